@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// One measured number. Every suite reports through the same row shape so the
+// CSV and JSON output stay comparable between versions.
+struct BenchmarkResult {
+	std::string suite;
+	std::string container;
+	std::string operation;
+	size_t size;
+	size_t iterations;
+	double value;
+	std::string unit;
+};
+
+class BenchmarkReport {
+private:
+	std::vector<BenchmarkResult> m_results;
+public:
+	void add(BenchmarkResult result);
+	const std::vector<BenchmarkResult>& results() const { return m_results; }
+
+	void write_table(std::ostream& out) const;
+	void write_csv(std::ostream& out) const;
+	void write_json(std::ostream& out) const;
+};
+
+// Counters fed by the global operator new/delete replacement in
+// Benchmarks.cpp. Sizes are the requested sizes, without allocator overhead.
+struct AllocationCounter {
+	std::atomic<size_t> allocations{ 0 };
+	std::atomic<size_t> frees{ 0 };
+	std::atomic<size_t> live_bytes{ 0 };
+	std::atomic<size_t> last_size{ 0 };
+};
+
+extern AllocationCounter g_allocations;
+
+// Keeps the compiler from discarding a computed value.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(_MSC_VER)
+	static const volatile void* sink;
+	sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Wall-clock nanoseconds taken by body().
+template <typename Body>
+double time_ns(Body&& body) {
+	auto start = std::chrono::steady_clock::now();
+	body();
+	auto stop = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+inline double median(std::vector<double> samples) {
+	if (samples.empty())
+		return 0.0;
+
+	std::sort(samples.begin(), samples.end());
+	size_t middle = samples.size() / 2;
+
+	return samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+}
+
+inline void BenchmarkReport::add(BenchmarkResult result) {
+	m_results.push_back(std::move(result));
+}
+
+inline void BenchmarkReport::write_table(std::ostream& out) const {
+	char line[256];
+
+	std::snprintf(line, sizeof(line), "%-12s %-36s %-18s %10s %10s %14s %s\n",
+		"suite", "container", "operation", "size", "iterations", "value", "unit");
+	out << line;
+
+	for (const auto& result : m_results) {
+		std::snprintf(line, sizeof(line), "%-12s %-36s %-18s %10zu %10zu %14.2f %s\n",
+			result.suite.c_str(), result.container.c_str(), result.operation.c_str(),
+			result.size, result.iterations, result.value, result.unit.c_str());
+		out << line;
+	}
+}
+
+inline void BenchmarkReport::write_csv(std::ostream& out) const {
+	out << "suite,container,operation,size,iterations,value,unit\n";
+
+	for (const auto& result : m_results) {
+		out << result.suite << ',' << result.container << ',' << result.operation << ','
+			<< result.size << ',' << result.iterations << ',' << result.value << ',' << result.unit << '\n';
+	}
+}
+
+inline void BenchmarkReport::write_json(std::ostream& out) const {
+	out << "[\n";
+
+	for (size_t idx = 0; idx < m_results.size(); ++idx) {
+		const auto& result = m_results[idx];
+		out << "  {\"suite\": \"" << result.suite
+			<< "\", \"container\": \"" << result.container
+			<< "\", \"operation\": \"" << result.operation
+			<< "\", \"size\": " << result.size
+			<< ", \"iterations\": " << result.iterations
+			<< ", \"value\": " << result.value
+			<< ", \"unit\": \"" << result.unit << "\"}"
+			<< (idx + 1 < m_results.size() ? ",\n" : "\n");
+	}
+
+	out << "]\n";
+}
@@ -0,0 +1,1734 @@
+#include "ARCCache.h"
+#include "BasicList.h"
+#include "Benchmark.h"
+#include "ChainedHashMap.h"
+#include "ConcurrentLRUCache.h"
+#include "CountingAllocator.h"
+#include "DoublyLinkedList.h"
+#include "LFUCache.h"
+#include "IndexedList.h"
+#include "Instrumentation.h"
+#include "JournaledList.h"
+#include "ListChunkStream.h"
+#include "LRUCache.h"
+#include "MappedList.h"
+#include "NodePool.h"
+#include "PerfCounters.h"
+#include "PersistentList.h"
+#include "SinglyLinkedList.h"
+#include "SmallList.h"
+#include "StaticList.h"
+#include "Traversal.h"
+#include "WTinyLFUCache.h"
+#include "XorLinkedList.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <forward_list>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Benchmark suite for the list containers.
+//
+//	Benchmarks [--suite operations|traversal|memory|cache|concurrent|hashmap|persistent|serialize|stream|mapped|journal|static|small|features|training|all]
+//	           [--container NAME] [--min-size N] [--max-size N] [--samples N]
+//	           [--budget N] [--threads N] [--trace FILE]
+//	           [--format table|csv|json] [--output FILE]
+//
+// operations  every list operation on every container at sizes 10 .. 10M, as
+//             ns/op and allocs/op
+// traversal   full scans with and without PrefetchTraversal, on nodes
+//             scattered across the heap and after compact(), with hardware
+//             counters per node where perf_event_open is available
+// memory      heap bytes per element for int, 16-byte and 64-byte payloads
+// cache       LRUCache, LFUCache, WTinyLFUCache and ARCCache against an LRU
+//             built on DoublyLinkedList::remove(), on Zipf-distributed
+//             read-through traces with and without one-off scans, as ns/op,
+//             Mops/s and hit%; with --trace, on the keys recorded in FILE
+//             instead, one per line (lines that are not integers are hashed)
+// concurrent  ConcurrentLRUCache, with exact and buffered recency, against one
+//             LRUCache behind a mutex, on 1, 2, 4 .. --threads threads (by
+//             default the hardware thread count), as total Mops/s and hit%
+// hashmap     ChainedHashMap against std::unordered_map, each with the
+//             standard and the pool allocator: the latency of every insert
+//             into a growing map as p50, p99, p99.9 and max ns, plus the mean
+//             ns/op of inserts and of finds in the full map
+// persistent  the cost of a new version of a list with one more element in
+//             front: PersistentList::push_front() against copying a
+//             SinglyLinkedList and inserting into the copy, as ns/version and
+//             heap bytes/version with every version kept alive
+// serialize   save() and load() of lists of ints against loading the same
+//             bytes by calling append() per element, as ns/element and
+//             allocs/element
+// stream      a SinglyLinkedList of ints written to a temporary file with
+//             ListChunkWriter, with and without checksums, and rebuilt with
+//             ListChunkReader, reading synchronously and reading ahead on a
+//             second thread, as ns/element
+// mapped      MappedList in a temporary file: append and full scans as
+//             ns/element, and the time to open the file again against
+//             SinglyLinkedList::load() of the same elements
+// journal     appends and pops on a JournaledList with an fsync per change,
+//             per 64 and per 1024 changes, and with the log written only at
+//             the end, against a SinglyLinkedList in memory, as ns/op
+// static      StaticList with room for 16 and 1024 ints against
+//             SinglyLinkedList and std::forward_list: a list made, filled,
+//             drained from the front and destroyed, as ns/element and
+//             allocs/element, and count() over the full list as ns/element
+// small       lists of 1 .. 64 ints made, filled and destroyed: SmallList
+//             with 8 inline nodes, spilling to the heap and to a NodePool,
+//             against SinglyLinkedList, as ns/list and allocs/list
+// features    BasicList with each ListFeatures switch off in turn and with all
+//             of them off, against SinglyLinkedList, DoublyLinkedList,
+//             std::forward_list and std::list: pushes and pops at the front as
+//             ns/op, count() as ns/element, heap bytes/element and
+//             sizeof(list)
+// training    the operations and traversal scenarios for SinglyLinkedList and
+//             DoublyLinkedList only, without the counted and histogram
+//             variants; the PGO build runs it to collect its profile and it is
+//             not part of all
+
+AllocationCounter g_allocations;
+
+namespace {
+	constexpr size_t allocation_header{ alignof(std::max_align_t) };
+
+	// Every replaced operator goes through these two, rather than the array
+	// and sized forms calling the plain ones, which GCC reports as mismatched
+	// new/delete once PGO inlines them into each other.
+	void* counted_allocate(size_t size) {
+		void* block = std::malloc(size + allocation_header);
+		if (!block)
+			throw std::bad_alloc();
+
+		std::memcpy(block, &size, sizeof(size));
+		g_allocations.allocations.fetch_add(1, std::memory_order_relaxed);
+		g_allocations.live_bytes.fetch_add(size, std::memory_order_relaxed);
+		g_allocations.last_size.store(size, std::memory_order_relaxed);
+
+		return static_cast<char*>(block) + allocation_header;
+	}
+
+	void counted_free(void* address) noexcept {
+		if (!address)
+			return;
+
+		void* block = static_cast<char*>(address) - allocation_header;
+		size_t size;
+		std::memcpy(&size, block, sizeof(size));
+		g_allocations.frees.fetch_add(1, std::memory_order_relaxed);
+		g_allocations.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+
+		std::free(block);
+	}
+}
+
+void* operator new(size_t size) { return counted_allocate(size); }
+void* operator new[](size_t size) { return counted_allocate(size); }
+void operator delete(void* address) noexcept { counted_free(address); }
+void operator delete[](void* address) noexcept { counted_free(address); }
+void operator delete(void* address, size_t) noexcept { counted_free(address); }
+void operator delete[](void* address, size_t) noexcept { counted_free(address); }
+
+namespace {
+
+struct Options {
+	std::string suite{ "all" };
+	std::string container;
+	std::string format{ "table" };
+	std::string output;
+	size_t min_size{ 10 };
+	size_t max_size{ 10000000 };
+	size_t samples{ 3 };
+	// node visits allowed per sample for operations that walk the list
+	size_t budget{ 10000000 };
+	size_t threads{ std::max<size_t>(std::thread::hardware_concurrency(), 1) };
+	std::string trace;
+};
+
+enum Operation : unsigned {
+	Append = 1 << 0,
+	InsertMiddle = 1 << 1,
+	PopFront = 1 << 2,
+	PopBack = 1 << 3,
+	Index = 1 << 4,
+	Count = 1 << 5,
+	Remove = 1 << 6,
+	RemoveAll = 1 << 7,
+	Iterate = 1 << 8,
+	ReverseIterate = 1 << 9,
+	Clear = 1 << 10,
+};
+
+template <size_t Bytes>
+struct Payload {
+	std::array<unsigned char, Bytes> bytes{};
+
+	Payload(int value = 0) { std::memcpy(bytes.data(), &value, sizeof(value)); }
+	bool operator==(const Payload& other) const { return bytes == other.bytes; }
+};
+
+// Adapters map each container onto the benchmarked operations. `operations`
+// lists what the container supports, `linear` which of those walk the
+// container and so get a smaller iteration count at large sizes.
+
+template <typename List>
+struct SinglyAdapter {
+	using Container = List;
+	static const char* name;
+	static constexpr unsigned operations{ Append | InsertMiddle | PopFront | PopBack | Index | Count | Remove | RemoveAll | Iterate | Clear };
+	static constexpr unsigned linear{ InsertMiddle | PopBack | Index | Count | Remove };
+
+	static void append(Container& list, int value) { list.append(value); }
+	static void insert_middle(Container& list, int value) { list.insert(static_cast<int>(list.size() / 2), value); }
+	static int pop_front(Container& list) { return list.pop(0); }
+	static int pop_back(Container& list) { return list.pop(); }
+	static int index(Container& list, size_t position) { return list.index(position); }
+	static int count(Container& list, int value) { return list.count(value); }
+	static void remove(Container& list, int value) { list.remove(value); }
+	static void remove_all(Container& list, int value) { list.remove_all(value); }
+	static void clear(Container& list) { list.clear(); }
+
+	static long long iterate(Container& list) {
+		long long sum{ 0 };
+		for (auto it = list.begin(); it != list.end(); ++it)
+			sum += *it;
+		return sum;
+	}
+};
+
+template <typename List>
+struct DoublyAdapter {
+	using Container = List;
+	static const char* name;
+	static constexpr unsigned operations{ Append | InsertMiddle | PopFront | PopBack | Index | Count | Remove | RemoveAll | Iterate | ReverseIterate | Clear };
+	static constexpr unsigned linear{ InsertMiddle | PopBack | Index | Count | Remove };
+
+	static void append(Container& list, int value) { list.append(value); }
+	static void insert_middle(Container& list, int value) { list.insert(static_cast<int>(list.size() / 2), value); }
+	static int pop_front(Container& list) { return list.pop(0); }
+	static int pop_back(Container& list) { return list.pop(); }
+	static int index(Container& list, size_t position) { return list.index(position); }
+	static int count(Container& list, int value) { return list.count(value); }
+	static void remove(Container& list, int value) { list.remove(value); }
+	static void remove_all(Container& list, int value) { list.remove_all(value); }
+	static void clear(Container& list) { list.clear(); }
+
+	static long long iterate(Container& list) {
+		long long sum{ 0 };
+		for (auto it = list.begin(); it != list.end(); ++it)
+			sum += *it;
+		return sum;
+	}
+
+	static long long reverse_iterate(Container& list) {
+		long long sum{ 0 };
+		for (auto it = list.rbegin(); it != list.rend(); ++it)
+			sum += *it;
+		return sum;
+	}
+};
+
+using CountedSingly = SinglyLinkedList<int, DirectTraversal, CountingAllocator<int>>;
+using CountedDoubly = DoublyLinkedList<int, DirectTraversal, CountingAllocator<int>>;
+using HistogramSingly = SinglyLinkedList<int, DirectTraversal, std::allocator<int>, HistogramInstrumentation>;
+using HistogramDoubly = DoublyLinkedList<int, DirectTraversal, std::allocator<int>, HistogramInstrumentation>;
+
+template <> const char* SinglyAdapter<SinglyLinkedList<int>>::name{ "SinglyLinkedList" };
+template <> const char* SinglyAdapter<CountedSingly>::name{ "SinglyLinkedList/counted" };
+template <> const char* SinglyAdapter<HistogramSingly>::name{ "SinglyLinkedList/histograms" };
+template <> const char* DoublyAdapter<DoublyLinkedList<int>>::name{ "DoublyLinkedList" };
+template <> const char* DoublyAdapter<CountedDoubly>::name{ "DoublyLinkedList/counted" };
+template <> const char* DoublyAdapter<HistogramDoubly>::name{ "DoublyLinkedList/histograms" };
+
+struct IndexedAdapter {
+	using Container = IndexedList<int>;
+	static constexpr const char* name{ "IndexedList" };
+	static constexpr unsigned operations{ Append | InsertMiddle | PopFront | PopBack | Index | Count | Remove | RemoveAll | Iterate | Clear };
+	static constexpr unsigned linear{ InsertMiddle | PopBack | Index | Count | Remove };
+
+	static void append(Container& list, int value) { list.append(value); }
+	static void insert_middle(Container& list, int value) { list.insert(static_cast<int>(list.size() / 2), value); }
+	static int pop_front(Container& list) { return list.pop(0); }
+	static int pop_back(Container& list) { return list.pop(); }
+	static int index(Container& list, size_t position) { return list.index(position); }
+	static int count(Container& list, int value) { return list.count(value); }
+	static void remove(Container& list, int value) { list.remove(value); }
+	static void remove_all(Container& list, int value) { list.remove_all(value); }
+	static void clear(Container& list) { list.clear(); }
+
+	static long long iterate(Container& list) {
+		long long sum{ 0 };
+		for (auto it = list.begin(); it != list.end(); ++it)
+			sum += *it;
+		return sum;
+	}
+};
+
+struct XorAdapter {
+	using Container = XorLinkedList<int>;
+	static constexpr const char* name{ "XorLinkedList" };
+	static constexpr unsigned operations{ Append | PopFront | PopBack | Index | Count | Iterate | ReverseIterate | Clear };
+	static constexpr unsigned linear{ Index | Count };
+
+	static void append(Container& list, int value) { list.append(value); }
+	static int pop_front(Container& list) { return list.pop_front(); }
+	static int pop_back(Container& list) { return list.pop_back(); }
+	static int index(Container& list, size_t position) { return list.index(position); }
+	static int count(Container& list, int value) { return list.count(value); }
+	static void clear(Container& list) { list.clear(); }
+
+	static long long iterate(Container& list) {
+		long long sum{ 0 };
+		for (auto it = list.begin(); it != list.end(); ++it)
+			sum += *it;
+		return sum;
+	}
+
+	static long long reverse_iterate(Container& list) {
+		long long sum{ 0 };
+		for (auto it = list.rbegin(); it != list.rend(); ++it)
+			sum += *it;
+		return sum;
+	}
+};
+
+// std::vector, std::deque and std::list share one adapter.
+template <typename Sequence>
+struct SequenceAdapter {
+	using Container = Sequence;
+	static const char* name;
+	static constexpr unsigned operations{ Append | InsertMiddle | PopFront | PopBack | Index | Count | Remove | RemoveAll | Iterate | ReverseIterate | Clear };
+	static const unsigned linear;
+
+	static void append(Container& sequence, int value) { sequence.push_back(value); }
+
+	static void insert_middle(Container& sequence, int value) {
+		sequence.insert(std::next(sequence.begin(), sequence.size() / 2), value);
+	}
+
+	static int pop_front(Container& sequence) {
+		int value = sequence.front();
+		sequence.erase(sequence.begin());
+		return value;
+	}
+
+	static int pop_back(Container& sequence) {
+		int value = sequence.back();
+		sequence.pop_back();
+		return value;
+	}
+
+	static int index(Container& sequence, size_t position) { return *std::next(sequence.begin(), position); }
+	static int count(Container& sequence, int value) { return static_cast<int>(std::count(sequence.begin(), sequence.end(), value)); }
+
+	static void remove(Container& sequence, int value) {
+		auto found = std::find(sequence.begin(), sequence.end(), value);
+		if (found != sequence.end())
+			sequence.erase(found);
+	}
+
+	static void remove_all(Container& sequence, int value) {
+		sequence.erase(std::remove(sequence.begin(), sequence.end(), value), sequence.end());
+	}
+
+	static void clear(Container& sequence) { sequence.clear(); }
+
+	static long long iterate(Container& sequence) {
+		long long sum{ 0 };
+		for (auto it = sequence.begin(); it != sequence.end(); ++it)
+			sum += *it;
+		return sum;
+	}
+
+	static long long reverse_iterate(Container& sequence) {
+		long long sum{ 0 };
+		for (auto it = sequence.rbegin(); it != sequence.rend(); ++it)
+			sum += *it;
+		return sum;
+	}
+};
+
+template <> const char* SequenceAdapter<std::vector<int>>::name{ "std::vector" };
+template <> const unsigned SequenceAdapter<std::vector<int>>::linear{ InsertMiddle | PopFront | Count | Remove };
+template <> const char* SequenceAdapter<std::deque<int>>::name{ "std::deque" };
+template <> const unsigned SequenceAdapter<std::deque<int>>::linear{ InsertMiddle | Count | Remove };
+template <> const char* SequenceAdapter<std::list<int>>::name{ "std::list" };
+template <> const unsigned SequenceAdapter<std::list<int>>::linear{ InsertMiddle | Index | Count | Remove };
+
+// std::forward_list plus the tail iterator and size it does not keep itself.
+struct ForwardList {
+	std::forward_list<int> list;
+	std::forward_list<int>::iterator tail{ list.before_begin() };
+	size_t size{ 0 };
+};
+
+struct ForwardListAdapter {
+	using Container = ForwardList;
+	static constexpr const char* name{ "std::forward_list" };
+	static constexpr unsigned operations{ Append | InsertMiddle | PopFront | PopBack | Index | Count | Remove | RemoveAll | Iterate | Clear };
+	static constexpr unsigned linear{ InsertMiddle | PopBack | Index | Count | Remove };
+
+	static void append(Container& forward, int value) {
+		forward.tail = forward.list.insert_after(forward.tail, value);
+		++forward.size;
+	}
+
+	static void insert_middle(Container& forward, int value) {
+		auto before = std::next(forward.list.before_begin(), forward.size / 2);
+		auto inserted = forward.list.insert_after(before, value);
+		if (before == forward.tail)
+			forward.tail = inserted;
+		++forward.size;
+	}
+
+	static int pop_front(Container& forward) {
+		int value = forward.list.front();
+		forward.list.pop_front();
+		if (--forward.size == 0)
+			forward.tail = forward.list.before_begin();
+		return value;
+	}
+
+	static int pop_back(Container& forward) {
+		auto before = std::next(forward.list.before_begin(), forward.size - 1);
+		int value = *forward.tail;
+		forward.list.erase_after(before);
+		forward.tail = before;
+		--forward.size;
+		return value;
+	}
+
+	static int index(Container& forward, size_t position) { return *std::next(forward.list.begin(), position); }
+	static int count(Container& forward, int value) { return static_cast<int>(std::count(forward.list.begin(), forward.list.end(), value)); }
+
+	static void remove(Container& forward, int value) {
+		for (auto before = forward.list.before_begin(); std::next(before) != forward.list.end(); ++before) {
+			if (*std::next(before) == value) {
+				if (std::next(before) == forward.tail)
+					forward.tail = before;
+				forward.list.erase_after(before);
+				--forward.size;
+				return;
+			}
+		}
+	}
+
+	static void remove_all(Container& forward, int value) {
+		forward.list.remove(value);
+		forward.size = 0;
+		forward.tail = forward.list.before_begin();
+		for (auto it = forward.list.begin(); it != forward.list.end(); ++it, ++forward.tail)
+			++forward.size;
+	}
+
+	static void clear(Container& forward) {
+		forward.list.clear();
+		forward.tail = forward.list.before_begin();
+		forward.size = 0;
+	}
+
+	static long long iterate(Container& forward) {
+		long long sum{ 0 };
+		for (auto it = forward.list.begin(); it != forward.list.end(); ++it)
+			sum += *it;
+		return sum;
+	}
+};
+
+std::vector<size_t> sizes(const Options& options, size_t minimum = 0) {
+	std::vector<size_t> selected;
+
+	for (size_t size = 10; size <= 10000000; size *= 10) {
+		if (size >= options.min_size && size <= options.max_size && size >= minimum)
+			selected.push_back(size);
+	}
+
+	return selected;
+}
+
+bool selected(const Options& options, const std::string& container) {
+
+	return options.container.empty() || container.find(options.container) != std::string::npos;
+}
+
+int identity(size_t position) { return static_cast<int>(position); }
+
+// Every 8th element is -1, the value remove_all() looks for.
+int every_eighth(size_t position) { return position % 8 == 0 ? -1 : static_cast<int>(position); }
+
+// How many times one sample repeats an operation on a container of `size`.
+template <typename A>
+size_t iterations_for(unsigned operation, size_t size, const Options& options, size_t limit) {
+	size_t cap{ 1000 };
+	if (A::linear & operation)
+		cap = std::min(cap, std::max<size_t>(options.budget / size, 1));
+
+	return std::max<size_t>(std::min(cap, limit), 1);
+}
+
+// Lists instantiated with a CountingAllocator report their own allocations
+// through stats(); everything else is counted by the global operator new.
+template <typename Container>
+struct counted : std::false_type {};
+
+template <typename T, typename Traversal, typename Upstream, typename Instrumentation>
+struct counted<SinglyLinkedList<T, Traversal, CountingAllocator<T, Upstream>, Instrumentation>> : std::true_type {};
+
+template <typename T, typename Traversal, typename Upstream, typename Instrumentation>
+struct counted<DoublyLinkedList<T, Traversal, CountingAllocator<T, Upstream>, Instrumentation>> : std::true_type {};
+
+template <typename Container>
+size_t allocations_of(const Container& container) {
+	if constexpr (counted<Container>::value)
+		return container.stats().allocations;
+	else
+		return g_allocations.allocations.load();
+}
+
+// Builds a fresh container per sample (untimed) and times body() on it.
+template <typename A, typename Body>
+void measure(BenchmarkReport& report, const Options& options, const char* operation, size_t size,
+	bool prefill, size_t iterations, Body body, int (*value_of)(size_t) = identity) {
+	std::vector<double> samples;
+	size_t allocations{ 0 };
+
+	for (size_t sample = 0; sample < options.samples; ++sample) {
+		typename A::Container container;
+		if (prefill) {
+			for (size_t idx = 0; idx < size; ++idx)
+				A::append(container, value_of(idx));
+		}
+
+		size_t before = allocations_of(container);
+		double elapsed = time_ns([&] { body(container); });
+		allocations = allocations_of(container) - before;
+
+		samples.push_back(elapsed / iterations);
+	}
+
+	report.add({ "operations", A::name, operation, size, iterations, median(samples), "ns/op" });
+	report.add({ "operations", A::name, operation, size, iterations,
+		static_cast<double>(allocations) / iterations, "allocs/op" });
+}
+
+template <typename A>
+void run_operations(BenchmarkReport& report, const Options& options) {
+	if (!selected(options, A::name))
+		return;
+
+	for (size_t size : sizes(options)) {
+		if constexpr ((A::operations & Append) != 0) {
+			measure<A>(report, options, "append", size, false, size, [&](auto& container) {
+				for (size_t idx = 0; idx < size; ++idx)
+					A::append(container, static_cast<int>(idx));
+			});
+		}
+
+		if constexpr ((A::operations & InsertMiddle) != 0) {
+			size_t iterations = iterations_for<A>(InsertMiddle, size, options, 1000);
+			measure<A>(report, options, "insert_middle", size, true, iterations, [&](auto& container) {
+				for (size_t idx = 0; idx < iterations; ++idx)
+					A::insert_middle(container, -2);
+			});
+		}
+
+		if constexpr ((A::operations & PopFront) != 0) {
+			size_t iterations = iterations_for<A>(PopFront, size, options, size - 1);
+			measure<A>(report, options, "pop_front", size, true, iterations, [&](auto& container) {
+				for (size_t idx = 0; idx < iterations; ++idx)
+					do_not_optimize(A::pop_front(container));
+			});
+		}
+
+		if constexpr ((A::operations & PopBack) != 0) {
+			size_t iterations = iterations_for<A>(PopBack, size, options, size - 1);
+			measure<A>(report, options, "pop_back", size, true, iterations, [&](auto& container) {
+				for (size_t idx = 0; idx < iterations; ++idx)
+					do_not_optimize(A::pop_back(container));
+			});
+		}
+
+		if constexpr ((A::operations & Index) != 0) {
+			size_t iterations = iterations_for<A>(Index, size, options, 1000);
+			measure<A>(report, options, "index", size, true, iterations, [&](auto& container) {
+				for (size_t idx = 0; idx < iterations; ++idx)
+					do_not_optimize(A::index(container, (size / 2 + idx * 7919) % size));
+			});
+		}
+
+		if constexpr ((A::operations & Count) != 0) {
+			size_t iterations = iterations_for<A>(Count, size, options, 1000);
+			measure<A>(report, options, "count", size, true, iterations, [&](auto& container) {
+				for (size_t idx = 0; idx < iterations; ++idx)
+					do_not_optimize(A::count(container, static_cast<int>(size / 2)));
+			});
+		}
+
+		if constexpr ((A::operations & Remove) != 0) {
+			size_t iterations = iterations_for<A>(Remove, size, options, size / 2);
+			measure<A>(report, options, "remove", size, true, iterations, [&](auto& container) {
+				for (size_t idx = 0; idx < iterations; ++idx)
+					A::remove(container, static_cast<int>(size / 2 + idx));
+			});
+		}
+
+		if constexpr ((A::operations & RemoveAll) != 0) {
+			measure<A>(report, options, "remove_all", size, true, 1, [&](auto& container) {
+				A::remove_all(container, -1);
+			}, every_eighth);
+		}
+
+		if constexpr ((A::operations & Iterate) != 0) {
+			measure<A>(report, options, "iterate", size, true, size, [&](auto& container) {
+				do_not_optimize(A::iterate(container));
+			});
+		}
+
+		if constexpr ((A::operations & ReverseIterate) != 0) {
+			measure<A>(report, options, "reverse_iterate", size, true, size, [&](auto& container) {
+				do_not_optimize(A::reverse_iterate(container));
+			});
+		}
+
+		if constexpr ((A::operations & Clear) != 0) {
+			measure<A>(report, options, "clear", size, true, size, [&](auto& container) {
+				A::clear(container);
+			});
+		}
+	}
+}
+
+// Builds list so that its nodes sit in random address order: a shuffled batch
+// of blocks with the node allocation size is freed just before the appends,
+// and malloc hands recently freed blocks of one size back out last-in first-out.
+template <typename List>
+void fill_scattered(List& list, size_t size) {
+	size_t node_bytes{ 0 };
+	{
+		List probe;
+		probe.append(0);
+		node_bytes = g_allocations.last_size.load();
+	}
+
+	std::vector<void*> blocks(size);
+	for (auto& block : blocks)
+		block = ::operator new(node_bytes);
+
+	std::shuffle(blocks.begin(), blocks.end(), std::mt19937_64{ 42 });
+	for (auto block : blocks)
+		::operator delete(block);
+
+	for (size_t idx = 0; idx < size; ++idx)
+		list.append(static_cast<int>(idx));
+}
+
+template <typename List>
+void run_traversal(BenchmarkReport& report, const Options& options, const std::string& name) {
+	if (!selected(options, name))
+		return;
+
+	PerfCounters counters;
+
+	for (size_t size : sizes(options, 1000)) {
+		for (bool compacted : { false, true }) {
+			std::vector<double> scans;
+			std::vector<double> walks;
+			std::array<double, PerfCounters::counter_count> scan_events{};
+			std::array<double, PerfCounters::counter_count> walk_events{};
+
+			for (size_t sample = 0; sample < options.samples; ++sample) {
+				List list;
+				fill_scattered(list, size);
+				if (compacted)
+					list.compact();
+
+				counters.start();
+				scans.push_back(time_ns([&] { do_not_optimize(list.count(-1)); }) / size);
+				counters.stop();
+				for (size_t counter = 0; counter < PerfCounters::counter_count; ++counter)
+					scan_events[counter] += counters.value(counter);
+
+				counters.start();
+				walks.push_back(time_ns([&] {
+					size_t visited{ 0 };
+					for (auto it = list.begin(); it != list.end(); ++it)
+						++visited;
+					do_not_optimize(visited);
+				}) / size);
+				counters.stop();
+				for (size_t counter = 0; counter < PerfCounters::counter_count; ++counter)
+					walk_events[counter] += counters.value(counter);
+			}
+
+			std::string layout = compacted ? "compacted" : "scattered";
+			report.add({ "traversal", name, "count_" + layout, size, size, median(scans), "ns/node" });
+			report.add({ "traversal", name, "iterate_" + layout, size, size, median(walks), "ns/node" });
+
+			double nodes = static_cast<double>(size * options.samples);
+			for (size_t counter = 0; counter < PerfCounters::counter_count; ++counter) {
+				if (!counters.available(counter))
+					continue;
+
+				std::string unit = std::string(PerfCounters::name(counter)) + "/node";
+				report.add({ "traversal", name, "count_" + layout, size, size, scan_events[counter] / nodes, unit });
+				report.add({ "traversal", name, "iterate_" + layout, size, size, walk_events[counter] / nodes, unit });
+			}
+		}
+	}
+}
+
+// Heap bytes per element after appending `size` elements, allocator overhead
+// excluded.
+template <typename Container, typename Append>
+void run_memory(BenchmarkReport& report, const Options& options, const std::string& name,
+	const std::string& payload, size_t size, Append append) {
+	if (!selected(options, name))
+		return;
+
+	size_t before = g_allocations.live_bytes.load();
+	{
+		Container container;
+		for (size_t idx = 0; idx < size; ++idx)
+			append(container, static_cast<int>(idx));
+
+		double bytes = static_cast<double>(g_allocations.live_bytes.load() - before);
+		report.add({ "memory", name, "bytes_per_element_" + payload, size, size, bytes / size, "bytes" });
+	}
+}
+
+template <typename T>
+void run_memory_payload(BenchmarkReport& report, const Options& options, const std::string& payload) {
+	size_t size = std::min<size_t>(options.max_size, 100000);
+
+	run_memory<SinglyLinkedList<T>>(report, options, "SinglyLinkedList", payload, size, [](auto& list, int value) { list.append(T(value)); });
+	run_memory<DoublyLinkedList<T>>(report, options, "DoublyLinkedList", payload, size, [](auto& list, int value) { list.append(T(value)); });
+	run_memory<IndexedList<T>>(report, options, "IndexedList", payload, size, [](auto& list, int value) { list.append(T(value)); });
+	run_memory<XorLinkedList<T>>(report, options, "XorLinkedList", payload, size, [](auto& list, int value) { list.append(T(value)); });
+	run_memory<std::list<T>>(report, options, "std::list", payload, size, [](auto& list, int value) { list.push_back(T(value)); });
+	run_memory<std::forward_list<T>>(report, options, "std::forward_list", payload, size, [](auto& list, int value) { list.push_front(T(value)); });
+	run_memory<std::deque<T>>(report, options, "std::deque", payload, size, [](auto& deque, int value) { deque.push_back(T(value)); });
+	run_memory<std::vector<T>>(report, options, "std::vector", payload, size, [](auto& vector, int value) { vector.push_back(T(value)); });
+}
+
+// Keys with Zipf-distributed popularity: rank r is drawn with probability
+// proportional to 1 / r^skew. Ranks are scrambled by an odd multiplier so the
+// popular keys are not neighbouring integers.
+std::vector<int> zipf_trace(size_t keys, size_t length, double skew, uint64_t seed) {
+	std::vector<double> cumulative(keys);
+	double total{ 0.0 };
+	for (size_t rank = 0; rank < keys; ++rank) {
+		total += 1.0 / std::pow(static_cast<double>(rank + 1), skew);
+		cumulative[rank] = total;
+	}
+
+	std::mt19937_64 generator{ seed };
+	std::uniform_real_distribution<double> uniform(0.0, total);
+	std::vector<int> trace(length);
+	for (auto& key : trace) {
+		size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(generator)) - cumulative.begin();
+		key = static_cast<int>((rank * 2654435761u) & 0x7fffffff);
+	}
+
+	return trace;
+}
+
+// A cache benchmark's key stream: Zipf-distributed keys, optionally broken
+// up by scans, runs of capacity keys that are never seen again, one every
+// scan_every times capacity Zipf accesses. Scans flush an LRU; caches that
+// weigh frequency should ride them out. A recorded trace is replayed as it
+// is, whatever the length asked for.
+struct CacheWorkload {
+	std::string name;
+	double skew;
+	size_t scan_every;
+	const std::vector<int>* recorded{ nullptr };
+};
+
+std::vector<int> cache_trace(const CacheWorkload& workload, size_t capacity, size_t length) {
+	if (workload.recorded)
+		return *workload.recorded;
+
+	std::vector<int> zipf = zipf_trace(capacity * 10, length, workload.skew, 7);
+	if (!workload.scan_every)
+		return zipf;
+
+	// Zipf keys are never negative, so scan keys count down from -1
+	std::vector<int> trace;
+	trace.reserve(length);
+	int scanned{ 0 };
+	for (size_t idx = 0; trace.size() < length; ++idx) {
+		if (idx % (workload.scan_every * capacity) == workload.scan_every * capacity - 1)
+			for (size_t key = 0; key < capacity && trace.size() < length; ++key)
+				trace.push_back(-++scanned);
+		if (trace.size() < length)
+			trace.push_back(zipf[idx]);
+	}
+
+	return trace;
+}
+
+// Reads a recorded trace: the first field of each line is a key. Blank lines
+// and lines starting with # are skipped.
+std::optional<std::vector<int>> load_trace(const std::string& path) {
+	std::ifstream file(path);
+	if (!file)
+		return std::nullopt;
+
+	std::vector<int> keys;
+	std::string line;
+	while (std::getline(file, line)) {
+		size_t start = line.find_first_not_of(" \t\r");
+		if (start == std::string::npos || line[start] == '#')
+			continue;
+
+		std::string field = line.substr(start, line.find_first_of(" \t\r,", start) - start);
+		char* end{ nullptr };
+		long long value = std::strtoll(field.c_str(), &end, 10);
+		keys.push_back(*end == '\0' ? static_cast<int>(value) : static_cast<int>(std::hash<std::string>{}(field)));
+	}
+
+	return keys;
+}
+
+// The hand-rolled LRU that LRUCache replaces: values in a hash map and keys
+// in a DoublyLinkedList in recency order, promoted with remove(), which scans.
+class ListLRU {
+private:
+	size_t m_capacity;
+	std::unordered_map<int, int> m_values;
+	DoublyLinkedList<int> m_recency;
+
+	void promote(int key) {
+		if (m_recency.back()->data() != key) {
+			m_recency.remove(key);
+			m_recency.append(key);
+		}
+	}
+public:
+	explicit ListLRU(size_t capacity) : m_capacity(capacity) {};
+
+	std::optional<int> get(int key) {
+		auto found = m_values.find(key);
+		if (found == m_values.end())
+			return std::nullopt;
+
+		promote(key);
+		return found->second;
+	}
+
+	void put(int key, int value) {
+		auto found = m_values.find(key);
+		if (found != m_values.end()) {
+			found->second = value;
+			promote(key);
+			return;
+		}
+
+		if (m_values.size() == m_capacity)
+			m_values.erase(m_recency.pop(0));
+
+		m_recency.append(key);
+		m_values.emplace(key, value);
+	}
+};
+
+// Replays trace as a read-through cache would: a get, then a put when it
+// missed. Returns the number of hits.
+template <typename Cache>
+size_t read_through(Cache& cache, const int* begin, const int* end) {
+	size_t hits{ 0 };
+	for (const int* key = begin; key != end; ++key) {
+		if (auto value = cache.get(*key)) {
+			do_not_optimize(*value);
+			++hits;
+		}
+		else {
+			cache.put(*key, *key);
+		}
+	}
+
+	return hits;
+}
+
+// Caches of each capacity see keys drawn from ten times as many. A fresh
+// cache is warmed with twice its capacity in untimed accesses, at most half
+// a recorded trace, then timed on the rest of the trace. `linear_from` is the capacity from which an
+// operation walks the cache, past which the trace is shortened to stay within
+// the budget; 0 for caches that never walk.
+template <typename Cache>
+void run_cache(BenchmarkReport& report, const Options& options, const std::string& name, const CacheWorkload& workload,
+	size_t linear_from) {
+	if (!selected(options, name))
+		return;
+
+	std::string operation{ workload.name };
+
+	for (size_t capacity : sizes(options, 100)) {
+		if (capacity > 1000000 || (linear_from && capacity > linear_from))
+			continue;
+
+		size_t length = std::max<size_t>(capacity * 10, 1000000);
+		std::vector<int> trace = cache_trace(workload, capacity, capacity * 2 + length);
+		size_t warmup = std::min(capacity * 2, trace.size() / 2);
+		if (linear_from)
+			trace.resize(std::min(trace.size(), warmup + std::max<size_t>(options.budget / capacity, 1000)));
+		length = trace.size() - warmup;
+		std::vector<double> samples;
+		size_t hits{ 0 };
+
+		for (size_t sample = 0; sample < options.samples; ++sample) {
+			Cache cache{ capacity };
+			read_through(cache, trace.data(), trace.data() + warmup);
+
+			samples.push_back(time_ns([&] {
+				hits = read_through(cache, trace.data() + warmup, trace.data() + trace.size());
+			}) / length);
+		}
+
+		double ns = median(samples);
+		report.add({ "cache", name, operation, capacity, length, ns, "ns/op" });
+		report.add({ "cache", name, operation, capacity, length, ns > 0 ? 1000.0 / ns : 0.0, "Mops/s" });
+		report.add({ "cache", name, operation, capacity, length, 100.0 * hits / length, "hit%" });
+	}
+}
+
+// Times every insert into a map grown from empty to size keys, and then a
+// find of each key. Inserts are timed one at a time so the rehashes show up
+// in the tail; the percentiles pool the inserts of every sample.
+template <typename Map, typename Find>
+void run_hashmap(BenchmarkReport& report, const Options& options, const std::string& name, Find find) {
+	if (!selected(options, name))
+		return;
+
+	for (size_t size : sizes(options, 1000)) {
+		if (size > 1000000)
+			continue;
+
+		std::vector<int> keys(size);
+		for (size_t idx = 0; idx < size; ++idx)
+			keys[idx] = static_cast<int>((idx * 2654435761u) & 0x7fffffff);
+
+		Histogram latency;
+		std::vector<double> inserts;
+		std::vector<double> finds;
+
+		for (size_t sample = 0; sample < options.samples; ++sample) {
+			Map map;
+			double total{ 0.0 };
+
+			for (int key : keys) {
+				auto start = std::chrono::steady_clock::now();
+				map.insert_or_assign(key, key);
+				auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+				latency.record(static_cast<uint64_t>(elapsed));
+				total += elapsed;
+			}
+			inserts.push_back(total / size);
+
+			finds.push_back(time_ns([&] {
+				for (int key : keys)
+					do_not_optimize(find(map, key));
+			}) / size);
+		}
+
+		report.add({ "hashmap", name, "insert", size, size, median(inserts), "ns/op" });
+		report.add({ "hashmap", name, "insert", size, size, static_cast<double>(latency.percentile(50.0)), "p50 ns" });
+		report.add({ "hashmap", name, "insert", size, size, static_cast<double>(latency.percentile(99.0)), "p99 ns" });
+		report.add({ "hashmap", name, "insert", size, size, static_cast<double>(latency.percentile(99.9)), "p99.9 ns" });
+		report.add({ "hashmap", name, "insert", size, size, static_cast<double>(latency.max()), "max ns" });
+		report.add({ "hashmap", name, "find", size, size, median(finds), "ns/op" });
+	}
+}
+
+// Derives `versions` new versions from one list of `size` elements, each into
+// its own preallocated slot, and keeps them all, so bytes/version is what each
+// version adds to the heap. Copies cost O(size) each, so there are at most
+// budget / (10 * size) of them.
+template <typename List, typename Grow, typename Derive>
+void run_persistent(BenchmarkReport& report, const Options& options, const std::string& name,
+	bool copies, Grow grow, Derive derive) {
+	if (!selected(options, name))
+		return;
+
+	for (size_t size : sizes(options)) {
+		if (size > 1000000)
+			continue;
+
+		size_t versions{ 1000 };
+		if (copies)
+			versions = std::max<size_t>(std::min<size_t>(versions, options.budget / (10 * size)), 1);
+
+		std::vector<double> samples;
+		double bytes{ 0.0 };
+
+		for (size_t sample = 0; sample < options.samples; ++sample) {
+			List base;
+			for (size_t idx = 0; idx < size; ++idx)
+				grow(base, static_cast<int>(idx));
+
+			std::vector<List> derived(versions);
+
+			size_t before = g_allocations.live_bytes.load();
+			double elapsed = time_ns([&] {
+				for (size_t version = 0; version < versions; ++version)
+					derive(derived[version], base, static_cast<int>(version));
+			});
+			bytes = static_cast<double>(g_allocations.live_bytes.load() - before) / versions;
+
+			samples.push_back(elapsed / versions);
+		}
+
+		report.add({ "persistent", name, "new_version", size, versions, median(samples), "ns/version" });
+		report.add({ "persistent", name, "new_version", size, versions, bytes, "bytes/version" });
+	}
+}
+
+// Times save() of a list of size ints into memory, load() of those bytes, and
+// the loop load() replaces: reading one element at a time and appending it.
+template <typename List>
+void run_serialize(BenchmarkReport& report, const Options& options, const std::string& name) {
+	if (!selected(options, name))
+		return;
+
+	for (size_t size : sizes(options, 1000)) {
+		if (size > 1000000)
+			continue;
+
+		std::string bytes;
+		std::vector<double> saves, loads, appends;
+		size_t load_allocations{ 0 }, append_allocations{ 0 };
+
+		for (size_t sample = 0; sample < options.samples; ++sample) {
+			{
+				List list;
+				for (size_t idx = 0; idx < size; ++idx)
+					list.append(static_cast<int>(idx));
+
+				std::ostringstream out;
+				saves.push_back(time_ns([&] { list.save(out); }) / size);
+				bytes = out.str();
+			}
+
+			{
+				std::istringstream in(bytes);
+				List loaded;
+				size_t before = g_allocations.allocations.load();
+				loads.push_back(time_ns([&] { loaded.load(in); }) / size);
+				load_allocations = g_allocations.allocations.load() - before;
+				do_not_optimize(loaded.size());
+			}
+
+			{
+				std::istringstream in(bytes);
+				List loaded;
+				size_t before = g_allocations.allocations.load();
+				appends.push_back(time_ns([&] {
+					in.seekg(20);
+					for (size_t idx = 0; idx < size; ++idx) {
+						int value;
+						in.read(reinterpret_cast<char*>(&value), sizeof(value));
+						loaded.append(value);
+					}
+				}) / size);
+				append_allocations = g_allocations.allocations.load() - before;
+				do_not_optimize(loaded.size());
+			}
+		}
+
+		report.add({ "serialize", name, "save", size, size, median(saves), "ns/element" });
+		report.add({ "serialize", name, "load", size, size, median(loads), "ns/element" });
+		report.add({ "serialize", name, "load", size, size, static_cast<double>(load_allocations) / size, "allocs/element" });
+		report.add({ "serialize", name, "append_each", size, size, median(appends), "ns/element" });
+		report.add({ "serialize", name, "append_each", size, size, static_cast<double>(append_allocations) / size, "allocs/element" });
+	}
+}
+
+// Streams a list of size ints through a temporary file in 64Ki-element
+// chunks and rebuilds it, timing each direction separately.
+void run_stream(BenchmarkReport& report, const Options& options) {
+	if (!selected(options, "ListChunkStream"))
+		return;
+
+	auto path = (std::filesystem::temp_directory_path() / "dsa_benchmark_list_stream.bin").string();
+
+	for (size_t size : sizes(options, 1000)) {
+		if (size > 1000000)
+			continue;
+
+		SinglyLinkedList<int> list;
+		for (size_t idx = 0; idx < size; ++idx)
+			list.append(static_cast<int>(idx));
+
+		for (bool checksums : { false, true }) {
+			std::vector<double> writes, reads, prefetched;
+
+			for (size_t sample = 0; sample < options.samples; ++sample) {
+				writes.push_back(time_ns([&] {
+					std::ofstream out(path, std::ios::binary | std::ios::trunc);
+					ListChunkWriter<int> writer(out, { 1 << 16, checksums });
+					writer.write_list(list);
+					writer.finish();
+				}) / size);
+
+				for (size_t read_ahead : { 0, 2 }) {
+					// the rebuilt list is freed outside the timed region
+					SinglyLinkedList<int> loaded;
+					double elapsed = time_ns([&] {
+						std::ifstream in(path, std::ios::binary);
+						ListChunkReader<int>(in, read_ahead).read_into(loaded);
+					});
+					do_not_optimize(loaded.size());
+					(read_ahead ? prefetched : reads).push_back(elapsed / size);
+				}
+			}
+
+			std::string suffix = checksums ? "+crc" : "";
+			report.add({ "stream", "ListChunkStream", "write" + suffix, size, size, median(writes), "ns/element" });
+			report.add({ "stream", "ListChunkStream", "read" + suffix, size, size, median(reads), "ns/element" });
+			report.add({ "stream", "ListChunkStream", "read_ahead" + suffix, size, size, median(prefetched), "ns/element" });
+		}
+	}
+
+	std::filesystem::remove(path);
+}
+
+// Builds a MappedList of size ints in a temporary file, then times reopening
+// it, which maps the file without reading the nodes, against loading a saved
+// SinglyLinkedList of the same elements.
+void run_mapped(BenchmarkReport& report, const Options& options) {
+	if (!selected(options, "MappedList"))
+		return;
+
+	auto path = (std::filesystem::temp_directory_path() / "dsa_benchmark_mapped_list.bin").string();
+
+	for (size_t size : sizes(options, 1000)) {
+		if (size > 1000000)
+			continue;
+
+		std::vector<double> appends, scans, opens, loads;
+
+		for (size_t sample = 0; sample < options.samples; ++sample) {
+			std::filesystem::remove(path);
+			{
+				MappedList<int> list(path);
+				appends.push_back(time_ns([&] {
+					for (size_t idx = 0; idx < size; ++idx)
+						list.append(static_cast<int>(idx));
+				}) / size);
+
+				scans.push_back(time_ns([&] {
+					long long sum{ 0 };
+					for (int value : list)
+						sum += value;
+					do_not_optimize(sum);
+				}) / size);
+			}
+
+			opens.push_back(time_ns([&] {
+				MappedList<int> reopened(path);
+				do_not_optimize(reopened.size());
+			}));
+
+			std::stringstream saved;
+			{
+				SinglyLinkedList<int> list;
+				for (size_t idx = 0; idx < size; ++idx)
+					list.append(static_cast<int>(idx));
+				list.save(saved);
+			}
+			SinglyLinkedList<int> loaded;
+			loads.push_back(time_ns([&] { loaded.load(saved); }));
+		}
+
+		report.add({ "mapped", "MappedList", "append", size, size, median(appends), "ns/element" });
+		report.add({ "mapped", "MappedList", "scan", size, size, median(scans), "ns/element" });
+		report.add({ "mapped", "MappedList", "open", size, 1, median(opens), "ns" });
+		report.add({ "mapped", "SinglyLinkedList", "load", size, 1, median(loads), "ns" });
+	}
+
+	std::filesystem::remove(path);
+}
+
+// Appends size ints and then pops them all from the front, through a
+// JournaledList logging to a temporary file at several group commit sizes and
+// straight to an in-memory SinglyLinkedList. With a group of 0 the log is
+// written and synced once, by the commit() at the end, which is timed too.
+// An fsync per change is only run up to 10K changes.
+void run_journal(BenchmarkReport& report, const Options& options) {
+	if (!selected(options, "JournaledList"))
+		return;
+
+	auto path = (std::filesystem::temp_directory_path() / "dsa_benchmark_journal.wal").string();
+	auto remove_log = [&path] {
+		std::filesystem::remove(path);
+		std::filesystem::remove(path + ".snapshot");
+	};
+
+	for (size_t size : sizes(options, 1000)) {
+		if (size > 1000000)
+			continue;
+
+		std::vector<double> appends, pops;
+		for (size_t sample = 0; sample < options.samples; ++sample) {
+			SinglyLinkedList<int> list;
+			appends.push_back(time_ns([&] {
+				for (size_t idx = 0; idx < size; ++idx)
+					list.append(static_cast<int>(idx));
+			}) / size);
+			pops.push_back(time_ns([&] {
+				for (size_t idx = 0; idx < size; ++idx)
+					do_not_optimize(list.pop(0));
+			}) / size);
+		}
+		report.add({ "journal", "SinglyLinkedList", "append", size, size, median(appends), "ns/op" });
+		report.add({ "journal", "SinglyLinkedList", "pop", size, size, median(pops), "ns/op" });
+
+		for (size_t group : { 1, 64, 1024, 0 }) {
+			if (group == 1 && size > 10000)
+				continue;
+
+			JournalOptions journal;
+			journal.group_commit = group;
+			std::string name = "JournaledList/group" + std::to_string(group);
+			appends.clear();
+			pops.clear();
+
+			for (size_t sample = 0; sample < options.samples; ++sample) {
+				remove_log();
+				JournaledList<int> list(path, journal);
+				appends.push_back(time_ns([&] {
+					for (size_t idx = 0; idx < size; ++idx)
+						list.append(static_cast<int>(idx));
+					list.commit();
+				}) / size);
+				pops.push_back(time_ns([&] {
+					for (size_t idx = 0; idx < size; ++idx)
+						do_not_optimize(list.pop(0));
+					list.commit();
+				}) / size);
+			}
+
+			report.add({ "journal", name, "append", size, size, median(appends), "ns/op" });
+			report.add({ "journal", name, "pop", size, size, median(pops), "ns/op" });
+		}
+	}
+
+	remove_log();
+}
+
+// Short-lived lists of N ints, as a latency-critical path uses them: each
+// round makes a list, appends N elements, pops them all from the front and
+// destroys it. The rounds add up to a tenth of options.budget elements.
+template <size_t N>
+void run_static(BenchmarkReport& report, const Options& options) {
+	if (N < options.min_size || N > options.max_size)
+		return;
+
+	size_t rounds = std::max<size_t>(options.budget / N / 10, 1);
+	size_t elements = rounds * N;
+
+	auto run = [&](const std::string& name, auto cycle, auto scan) {
+		if (!selected(options, name))
+			return;
+
+		std::vector<double> cycles, scans;
+		size_t allocations{ 0 };
+
+		for (size_t sample = 0; sample < options.samples; ++sample) {
+			size_t before = g_allocations.allocations.load();
+			cycles.push_back(time_ns([&] {
+				for (size_t round = 0; round < rounds; ++round)
+					cycle();
+			}) / elements);
+			allocations = g_allocations.allocations.load() - before;
+
+			scans.push_back(time_ns([&] {
+				for (size_t round = 0; round < rounds; ++round)
+					scan();
+			}) / elements);
+		}
+
+		report.add({ "static", name, "cycle", N, elements, median(cycles), "ns/element" });
+		report.add({ "static", name, "cycle", N, elements, static_cast<double>(allocations) / elements, "allocs/element" });
+		report.add({ "static", name, "count", N, elements, median(scans), "ns/element" });
+	};
+
+	StaticList<int, N> full_static;
+	SinglyLinkedList<int> full_singly;
+	std::forward_list<int> full_forward;
+	for (size_t idx = 0; idx < N; ++idx) {
+		full_static.append(static_cast<int>(idx));
+		full_singly.append(static_cast<int>(idx));
+	}
+	full_forward.assign(full_static.begin(), full_static.end());
+
+	run("StaticList", [] {
+		StaticList<int, N> list;
+		for (size_t idx = 0; idx < N; ++idx)
+			list.append(static_cast<int>(idx));
+		for (size_t idx = 0; idx < N; ++idx)
+			do_not_optimize(list.pop(0));
+	}, [&] { do_not_optimize(full_static.count(1)); });
+
+	run("SinglyLinkedList", [] {
+		SinglyLinkedList<int> list;
+		for (size_t idx = 0; idx < N; ++idx)
+			list.append(static_cast<int>(idx));
+		for (size_t idx = 0; idx < N; ++idx)
+			do_not_optimize(list.pop(0));
+	}, [&] { do_not_optimize(full_singly.count(1)); });
+
+	run("std::forward_list", [] {
+		std::forward_list<int> list;
+		auto last = list.before_begin();
+		for (size_t idx = 0; idx < N; ++idx)
+			last = list.insert_after(last, static_cast<int>(idx));
+		for (size_t idx = 0; idx < N; ++idx) {
+			do_not_optimize(list.front());
+			list.pop_front();
+		}
+	}, [&] { do_not_optimize(std::count(full_forward.begin(), full_forward.end(), 1)); });
+}
+
+// Makes a list, appends length ints and destroys it, over and over; most
+// lists callers make are this short. SmallList<int, 8> spills past 8
+// elements, to the heap or to a pool that outlives the lists.
+void run_small(BenchmarkReport& report, const Options& options) {
+	NodePool* pool = NodePool::create();
+
+	auto run = [&](const std::string& name, size_t length, auto make) {
+		if (!selected(options, name))
+			return;
+
+		size_t lists = std::max<size_t>(options.budget / 10 / length, 1);
+		std::vector<double> samples;
+		size_t allocations{ 0 };
+
+		for (size_t sample = 0; sample < options.samples; ++sample) {
+			size_t before = g_allocations.allocations.load();
+			samples.push_back(time_ns([&] {
+				for (size_t idx = 0; idx < lists; ++idx) {
+					auto list = make();
+					for (size_t value = 0; value < length; ++value)
+						list.append(static_cast<int>(value));
+					do_not_optimize(list.size());
+				}
+			}) / lists);
+			allocations = g_allocations.allocations.load() - before;
+		}
+
+		report.add({ "small", name, "create_append_destroy", length, lists, median(samples), "ns/list" });
+		report.add({ "small", name, "create_append_destroy", length, lists,
+			static_cast<double>(allocations) / lists, "allocs/list" });
+	};
+
+	for (size_t length : { 1, 4, 8, 16, 64 }) {
+		run("SinglyLinkedList", length, [] { return SinglyLinkedList<int>(); });
+		run("SmallList<8>", length, [] { return SmallList<int, 8>(); });
+		run("SmallList<8>/pool", length, [pool] { return SmallList<int, 8, PoolAllocator<int>>(PoolAllocator<int>{ pool }); });
+	}
+
+	pool->unreference();
+}
+
+// What each ListFeatures switch costs the operations that have no use for
+// it: pushes and pops at the front, which keep the count and the tail up to
+// date without reading them, and count() over the whole list, which pays for
+// the size of every node. SinglyLinkedList and DoublyLinkedList are run
+// against BasicList with one switch off at a time and with all of them off,
+// next to std::forward_list and std::list.
+void run_features(BenchmarkReport& report, const Options& options) {
+	auto run = [&](const std::string& name, auto make, auto push_front, auto pop_front, auto scan) {
+		if (!selected(options, name))
+			return;
+
+		for (size_t size : sizes(options, 100)) {
+			if (size > 1000000)
+				break;
+
+			size_t rounds = std::max<size_t>(options.budget / 10 / size, 1);
+			std::vector<double> fronts;
+			std::vector<double> scans;
+			double bytes{ 0.0 };
+
+			for (size_t sample = 0; sample < options.samples; ++sample) {
+				fronts.push_back(time_ns([&] {
+					for (size_t round = 0; round < rounds; ++round) {
+						auto list = make();
+						for (size_t value = 0; value < size; ++value)
+							push_front(list, static_cast<int>(value));
+						for (size_t value = 0; value < size; ++value)
+							do_not_optimize(pop_front(list));
+					}
+				}) / (2 * rounds * size));
+
+				size_t before = g_allocations.live_bytes.load();
+				auto full = make();
+				for (size_t value = 0; value < size; ++value)
+					push_front(full, static_cast<int>(value));
+				bytes = static_cast<double>(g_allocations.live_bytes.load() - before) / size;
+
+				scans.push_back(time_ns([&] {
+					for (size_t round = 0; round < rounds; ++round)
+						do_not_optimize(scan(full));
+				}) / (rounds * size));
+			}
+
+			report.add({ "features", name, "push_pop_front", size, 2 * rounds * size, median(fronts), "ns/op" });
+			report.add({ "features", name, "count", size, rounds * size, median(scans), "ns/element" });
+			report.add({ "features", name, "bytes_per_element", size, size, bytes, "bytes" });
+			report.add({ "features", name, "sizeof", size, 1, static_cast<double>(sizeof(decltype(make()))), "bytes" });
+		}
+	};
+
+	auto push = [](auto& list, int value) { list.insert(0, value); };
+	auto pop = [](auto& list) { return list.pop(0); };
+	auto count = [](auto& list) { return list.count(-1); };
+	auto basic = [&](const std::string& name, auto features) {
+		using Features = decltype(features);
+		run(name, [] { return BasicList<int, Features>(); }, push, pop, count);
+	};
+
+	basic("SinglyLinkedList", SinglyLinks{});
+	basic("Singly/no-size", ListFeatures<false, false>{});
+	basic("Singly/no-tail", ListFeatures<false, true, false>{});
+	basic("Singly/exclusive", ListFeatures<false, true, true, ExclusiveOwnership>{});
+	basic("Singly/no-compaction", ListFeatures<false, true, true, SharedOwnership, false>{});
+	basic("Singly/bare", ListFeatures<false, false, false, ExclusiveOwnership, false>{});
+	basic("DoublyLinkedList", DoublyLinks{});
+	basic("Doubly/exclusive", ListFeatures<true, true, true, ExclusiveOwnership>{});
+	basic("Doubly/bare", ListFeatures<true, false, false, ExclusiveOwnership, false>{});
+
+	auto count_std = [](auto& list) { return std::count(list.begin(), list.end(), -1); };
+	auto pop_std = [](auto& list) {
+		int value = list.front();
+		list.pop_front();
+		return value;
+	};
+	run("std::forward_list", [] { return std::forward_list<int>(); },
+		[](auto& list, int value) { list.push_front(value); }, pop_std, count_std);
+	run("std::list", [] { return std::list<int>(); },
+		[](auto& list, int value) { list.push_front(value); }, pop_std, count_std);
+}
+
+// One LRUCache behind one mutex: what a service starts with, and what the
+// sharded cache is measured against. shards is ignored.
+class LockedLRU {
+private:
+	std::mutex m_mutex;
+	LRUCache<int, int> m_cache;
+public:
+	LockedLRU(size_t capacity, size_t) : m_cache(capacity) {};
+
+	std::optional<int> get(int key) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_cache.get(key);
+	}
+
+	void put(int key, int value) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_cache.put(key, value);
+	}
+};
+
+// Wall-clock nanoseconds for `threads` threads to each run body(thread), timed
+// from when all of them are ready to when the last one finishes.
+template <typename Body>
+double time_threads_ns(size_t threads, Body body) {
+	std::atomic<size_t> ready{ 0 };
+	std::atomic<bool> go{ false };
+	std::vector<std::thread> workers;
+
+	for (size_t thread = 0; thread < threads; ++thread) {
+		workers.emplace_back([&, thread] {
+			++ready;
+			while (!go.load(std::memory_order_acquire))
+				std::this_thread::yield();
+			body(thread);
+		});
+	}
+
+	while (ready.load() < threads)
+		std::this_thread::yield();
+
+	double elapsed = time_ns([&] {
+		go.store(true, std::memory_order_release);
+		for (auto& worker : workers)
+			worker.join();
+	});
+
+	return elapsed;
+}
+
+// A Zipf 0.99 trace over ten times the capacity is split evenly between the
+// threads. read_through misses put the key; read_only runs on a cache
+// already warmed by the whole trace, so only gets reach it.
+template <typename Cache>
+void run_concurrent(BenchmarkReport& report, const Options& options, const std::string& name) {
+	if (!selected(options, name))
+		return;
+
+	const size_t total{ 1000000 };
+
+	for (size_t capacity : sizes(options, 10000)) {
+		if (capacity > 100000)
+			continue;
+
+		size_t shards = std::min<size_t>(ConcurrentLRUCache<int, int>::default_shards(), 256);
+		std::vector<int> trace = zipf_trace(capacity * 10, total, 0.99, 11);
+
+		for (size_t threads = 1; threads <= options.threads; threads *= 2) {
+			size_t slice = total / threads;
+
+			for (bool read_only : { false, true }) {
+				std::vector<double> samples;
+				std::atomic<size_t> hits{ 0 };
+
+				for (size_t sample = 0; sample < options.samples; ++sample) {
+					Cache cache{ capacity, shards };
+					if (read_only)
+						read_through(cache, trace.data(), trace.data() + trace.size());
+
+					hits = 0;
+					samples.push_back(time_threads_ns(threads, [&](size_t thread) {
+						const int* begin = trace.data() + thread * slice;
+						size_t found{ 0 };
+
+						if (read_only) {
+							for (const int* key = begin; key != begin + slice; ++key)
+								found += cache.get(*key).has_value();
+						}
+						else {
+							found = read_through(cache, begin, begin + slice);
+						}
+
+						hits += found;
+					}));
+				}
+
+				size_t operations = slice * threads;
+				std::string operation = std::string(read_only ? "read_only/" : "read_through/") + std::to_string(threads) + "t";
+				double ns = median(samples);
+				report.add({ "concurrent", name, operation, capacity, operations, ns > 0 ? operations * 1000.0 / ns : 0.0, "Mops/s" });
+				report.add({ "concurrent", name, operation, capacity, operations, 100.0 * hits / operations, "hit%" });
+			}
+		}
+	}
+}
+
+bool parse(int argc, char* argv[], Options& options) {
+	for (int idx = 1; idx < argc; ++idx) {
+		std::string flag = argv[idx];
+		if (flag == "--help" || idx + 1 >= argc)
+			return false;
+
+		std::string value = argv[++idx];
+		if (flag == "--suite")
+			options.suite = value;
+		else if (flag == "--container")
+			options.container = value;
+		else if (flag == "--format")
+			options.format = value;
+		else if (flag == "--output")
+			options.output = value;
+		else if (flag == "--min-size")
+			options.min_size = std::stoull(value);
+		else if (flag == "--max-size")
+			options.max_size = std::stoull(value);
+		else if (flag == "--samples")
+			options.samples = std::max<size_t>(std::stoull(value), 1);
+		else if (flag == "--budget")
+			options.budget = std::max<size_t>(std::stoull(value), 1);
+		else if (flag == "--threads")
+			options.threads = std::max<size_t>(std::stoull(value), 1);
+		else if (flag == "--trace")
+			options.trace = value;
+		else
+			return false;
+	}
+
+	return options.format == "table" || options.format == "csv" || options.format == "json";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	if (!parse(argc, argv, options)) {
+		std::cerr << "usage: " << argv[0] << " [--suite operations|traversal|memory|cache|concurrent|hashmap|persistent|serialize|stream|mapped|journal|static|small|features|training|all]\n"
+			<< "       [--container NAME] [--min-size N] [--max-size N] [--samples N]\n"
+			<< "       [--budget N] [--threads N] [--trace FILE]\n"
+			<< "       [--format table|csv|json] [--output FILE]\n";
+		return 2;
+	}
+
+	std::optional<std::vector<int>> recorded;
+	if (!options.trace.empty()) {
+		recorded = load_trace(options.trace);
+		if (!recorded || recorded->empty()) {
+			std::cerr << "cannot read a trace from " << options.trace << "\n";
+			return 2;
+		}
+	}
+
+	BenchmarkReport report;
+	bool all = options.suite == "all";
+
+	if (all || options.suite == "operations") {
+		run_operations<SinglyAdapter<SinglyLinkedList<int>>>(report, options);
+		run_operations<SinglyAdapter<CountedSingly>>(report, options);
+		run_operations<SinglyAdapter<HistogramSingly>>(report, options);
+		run_operations<DoublyAdapter<DoublyLinkedList<int>>>(report, options);
+		run_operations<DoublyAdapter<CountedDoubly>>(report, options);
+		run_operations<DoublyAdapter<HistogramDoubly>>(report, options);
+		run_operations<IndexedAdapter>(report, options);
+		run_operations<XorAdapter>(report, options);
+		run_operations<SequenceAdapter<std::list<int>>>(report, options);
+		run_operations<ForwardListAdapter>(report, options);
+		run_operations<SequenceAdapter<std::deque<int>>>(report, options);
+		run_operations<SequenceAdapter<std::vector<int>>>(report, options);
+	}
+
+	if (all || options.suite == "traversal") {
+		if (!PerfCounters().any_available())
+			std::cerr << "hardware counters unavailable (perf_event_open failed); reporting wall-clock times only\n";
+
+		run_traversal<SinglyLinkedList<int>>(report, options, "SinglyLinkedList/direct");
+		run_traversal<SinglyLinkedList<int, PrefetchTraversal<8>>>(report, options, "SinglyLinkedList/prefetch8");
+		run_traversal<SinglyLinkedList<int, PrefetchTraversal<16>>>(report, options, "SinglyLinkedList/prefetch16");
+		run_traversal<DoublyLinkedList<int>>(report, options, "DoublyLinkedList/direct");
+		run_traversal<DoublyLinkedList<int, PrefetchTraversal<8>>>(report, options, "DoublyLinkedList/prefetch8");
+		run_traversal<DoublyLinkedList<int, PrefetchTraversal<16>>>(report, options, "DoublyLinkedList/prefetch16");
+	}
+
+	if (all || options.suite == "cache") {
+		std::vector<CacheWorkload> workloads{
+			{ "zipf0.8", 0.8, 0 },
+			{ "zipf0.99", 0.99, 0 },
+			{ "zipf0.99+scan", 0.99, 5 },
+		};
+		if (recorded)
+			workloads = { { "trace", 0.0, 0, &*recorded } };
+
+		for (const auto& workload : workloads) {
+			run_cache<LRUCache<int, int>>(report, options, "LRUCache", workload, 0);
+			run_cache<LRUCache<int, int, std::hash<int>, std::equal_to<int>, std::allocator<std::pair<int, int>>>>(
+				report, options, "LRUCache/std::allocator", workload, 0);
+			run_cache<LFUCache<int, int>>(report, options, "LFUCache", workload, 0);
+			run_cache<WTinyLFUCache<int, int>>(report, options, "WTinyLFUCache", workload, 0);
+			run_cache<ARCCache<int, int>>(report, options, "ARCCache", workload, 0);
+			run_cache<ListLRU>(report, options, "ListLRU", workload, 10000);
+		}
+	}
+
+	if (all || options.suite == "concurrent") {
+		run_concurrent<LockedLRU>(report, options, "LRUCache+mutex");
+		run_concurrent<ConcurrentLRUCache<int, int>>(report, options, "ConcurrentLRUCache");
+		run_concurrent<ConcurrentLRUCache<int, int, std::hash<int>, std::equal_to<int>, BufferedRecency<>>>(
+			report, options, "ConcurrentLRUCache/buffered");
+	}
+
+	if (all || options.suite == "hashmap") {
+		using PooledUnorderedMap = std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+			PoolAllocator<std::pair<const int, int>>>;
+		auto find_chained = [](auto& map, int key) { return map.find(key) != nullptr; };
+		auto find_unordered = [](auto& map, int key) { return map.find(key) != map.end(); };
+
+		run_hashmap<ChainedHashMap<int, int>>(report, options, "ChainedHashMap", find_chained);
+		run_hashmap<ChainedHashMap<int, int, std::hash<int>, std::equal_to<int>, std::allocator<std::pair<int, int>>>>(
+			report, options, "ChainedHashMap/std::allocator", find_chained);
+		run_hashmap<std::unordered_map<int, int>>(report, options, "std::unordered_map", find_unordered);
+		run_hashmap<PooledUnorderedMap>(report, options, "std::unordered_map/pool", find_unordered);
+	}
+
+	if (all || options.suite == "persistent") {
+		// SinglyLinkedList's implicit copy shares its nodes, so a real copy is a
+		// walk appending each element, as a caller would write it
+		auto copy_singly = [](SinglyLinkedList<int>& copy, const SinglyLinkedList<int>& base, int value) {
+			for (auto node = base.front(); node; node = node->next())
+				copy.append(node->data());
+			copy.insert(0, value);
+		};
+
+		run_persistent<PersistentList<int>>(report, options, "PersistentList", false,
+			[](PersistentList<int>& list, int value) { list = list.push_front(value); },
+			[](PersistentList<int>& version, const PersistentList<int>& base, int value) { version = base.push_front(value); });
+		run_persistent<SinglyLinkedList<int>>(report, options, "SinglyLinkedList/copy", true,
+			[](SinglyLinkedList<int>& list, int value) { list.append(value); }, copy_singly);
+	}
+
+	if (all || options.suite == "serialize") {
+		run_serialize<SinglyLinkedList<int>>(report, options, "SinglyLinkedList");
+		run_serialize<DoublyLinkedList<int>>(report, options, "DoublyLinkedList");
+	}
+
+	if (all || options.suite == "stream")
+		run_stream(report, options);
+
+	if (all || options.suite == "mapped")
+		run_mapped(report, options);
+
+	if (all || options.suite == "journal")
+		run_journal(report, options);
+
+	if (all || options.suite == "static") {
+		run_static<16>(report, options);
+		run_static<1024>(report, options);
+	}
+
+	if (all || options.suite == "small")
+		run_small(report, options);
+
+	if (all || options.suite == "features")
+		run_features(report, options);
+
+	if (options.suite == "training") {
+		run_operations<SinglyAdapter<SinglyLinkedList<int>>>(report, options);
+		run_operations<DoublyAdapter<DoublyLinkedList<int>>>(report, options);
+		run_traversal<SinglyLinkedList<int>>(report, options, "SinglyLinkedList/direct");
+		run_traversal<SinglyLinkedList<int, PrefetchTraversal<8>>>(report, options, "SinglyLinkedList/prefetch8");
+		run_traversal<SinglyLinkedList<int, PrefetchTraversal<16>>>(report, options, "SinglyLinkedList/prefetch16");
+		run_traversal<DoublyLinkedList<int>>(report, options, "DoublyLinkedList/direct");
+		run_traversal<DoublyLinkedList<int, PrefetchTraversal<8>>>(report, options, "DoublyLinkedList/prefetch8");
+		run_traversal<DoublyLinkedList<int, PrefetchTraversal<16>>>(report, options, "DoublyLinkedList/prefetch16");
+	}
+
+	if (all || options.suite == "memory") {
+		run_memory_payload<int>(report, options, "int");
+		run_memory_payload<Payload<16>>(report, options, "16B");
+		run_memory_payload<Payload<64>>(report, options, "64B");
+	}
+
+	std::ofstream file;
+	if (!options.output.empty())
+		file.open(options.output);
+	std::ostream& out = options.output.empty() ? std::cout : file;
+
+	if (options.format == "csv")
+		report.write_csv(out);
+	else if (options.format == "json")
+		report.write_json(out);
+	else
+		report.write_table(out);
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters for the calling thread, read through Linux
+// perf_event_open.
+//
+// Each counter is opened on its own rather than as one group, so a CPU or VM
+// that lacks one event still reports the others. Where a counter cannot be
+// opened at all (not Linux, perf_event_paranoid too strict, no PMU inside a
+// container) it reports unavailable and the benchmarks leave its rows out.
+// Counts are scaled up when the kernel had to multiplex the counters.
+class PerfCounters {
+public:
+	enum Counter : size_t {
+		Cycles,
+		Instructions,
+		L1dMisses,
+		LlcMisses,
+		DtlbMisses,
+		BranchMisses,
+	};
+
+	static constexpr size_t counter_count{ 6 };
+
+	static const char* name(size_t counter) {
+		static const char* const names[counter_count]{
+			"cycles", "instructions", "L1d_misses", "LLC_misses", "dTLB_misses", "branch_misses"
+		};
+		return names[counter];
+	}
+private:
+	std::array<int, counter_count> m_descriptors;
+	std::array<double, counter_count> m_values{};
+
+	static int open_counter(size_t counter);
+public:
+	PerfCounters();
+	~PerfCounters();
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	bool available(size_t counter) const { return m_descriptors[counter] >= 0; }
+	bool any_available() const;
+
+	void start();
+	void stop();
+	// Count from the last start()/stop() pair.
+	double value(size_t counter) const { return m_values[counter]; }
+};
+
+#if defined(__linux__)
+
+inline int PerfCounters::open_counter(size_t counter) {
+	perf_event_attr attributes;
+	std::memset(&attributes, 0, sizeof(attributes));
+	attributes.size = sizeof(attributes);
+	attributes.disabled = 1;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+	attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	auto cache_miss = [](uint64_t cache) {
+		return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	};
+
+	switch (counter) {
+	case Cycles:
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+		break;
+	case Instructions:
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+		break;
+	case L1dMisses:
+		attributes.type = PERF_TYPE_HW_CACHE;
+		attributes.config = cache_miss(PERF_COUNT_HW_CACHE_L1D);
+		break;
+	case LlcMisses:
+		attributes.type = PERF_TYPE_HW_CACHE;
+		attributes.config = cache_miss(PERF_COUNT_HW_CACHE_LL);
+		break;
+	case DtlbMisses:
+		attributes.type = PERF_TYPE_HW_CACHE;
+		attributes.config = cache_miss(PERF_COUNT_HW_CACHE_DTLB);
+		break;
+	default:
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+		break;
+	}
+
+	return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+
+inline PerfCounters::PerfCounters() {
+	for (size_t counter = 0; counter < counter_count; ++counter)
+		m_descriptors[counter] = open_counter(counter);
+}
+
+inline PerfCounters::~PerfCounters() {
+	for (int descriptor : m_descriptors) {
+		if (descriptor >= 0)
+			close(descriptor);
+	}
+}
+
+inline void PerfCounters::start() {
+	for (int descriptor : m_descriptors) {
+		if (descriptor >= 0) {
+			ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+			ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+inline void PerfCounters::stop() {
+	for (int descriptor : m_descriptors) {
+		if (descriptor >= 0)
+			ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+	}
+
+	for (size_t counter = 0; counter < counter_count; ++counter) {
+		m_values[counter] = 0.0;
+		if (m_descriptors[counter] < 0)
+			continue;
+
+		// value, time enabled, time running
+		uint64_t reading[3]{};
+		if (read(m_descriptors[counter], reading, sizeof(reading)) != static_cast<ssize_t>(sizeof(reading)))
+			continue;
+
+		if (reading[2] > 0)
+			m_values[counter] = static_cast<double>(reading[0]) * reading[1] / reading[2];
+	}
+}
+
+#else
+
+inline int PerfCounters::open_counter(size_t) {
+
+	return -1;
+}
+
+inline PerfCounters::PerfCounters() {
+	m_descriptors.fill(-1);
+}
+
+inline PerfCounters::~PerfCounters() {}
+
+inline void PerfCounters::start() {}
+
+inline void PerfCounters::stop() {}
+
+#endif
+
+inline bool PerfCounters::any_available() const {
+	for (size_t counter = 0; counter < counter_count; ++counter) {
+		if (available(counter))
+			return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Compares the release, LTO and PGO builds on the list benchmarks.
+
+    pgo_report.py [--presets release,lto,pgo,pgo-lto] [--runs N] [--cpu N]
+                  [--skip-build] [--output FILE] [-- BENCHMARK ARGS]
+
+Builds every preset through its CMake workflow (training the PGO profile
+first), then runs each build's dsa_benchmarks on the operations and traversal
+suites. The builds run in turn, once per round, so drift on the machine
+affects them all alike. When taskset is available every run is pinned to one
+CPU. Each row keeps the median of its runs.
+
+The Markdown report gives the geometric-mean speedup over the first preset
+for each container and suite, then every SinglyLinkedList and
+DoublyLinkedList row, along with how far each build's runs spread. Arguments after -- go to dsa_benchmarks, replacing the
+defaults of --max-size 100000 --samples 3.
+"""
+
+import argparse
+import csv
+import io
+import math
+import shutil
+import statistics
+import subprocess
+import sys
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+CONTAINERS = ("SinglyLinkedList", "DoublyLinkedList")
+# Diagnostic builds of the lists that the training run leaves out.
+VARIANTS = ("/counted", "/histograms")
+SUITES = ("operations", "traversal")
+TIME_UNITS = ("ns/op", "ns/node")
+
+
+def build(presets):
+    if any(preset.startswith("pgo") for preset in presets):
+        subprocess.run(["cmake", "--workflow", "--preset", "pgo-train"], cwd=ROOT, check=True)
+
+    for preset in presets:
+        subprocess.run(["cmake", "--workflow", "--preset", preset], cwd=ROOT, check=True)
+
+
+def run(preset, suite, arguments, cpu):
+    binary = ROOT / "build" / preset / "dsa_benchmarks"
+    command = [str(binary), "--suite", suite, "--format", "csv"] + arguments
+    if cpu is not None and shutil.which("taskset"):
+        command = ["taskset", "-c", str(cpu)] + command
+
+    output = subprocess.run(command, check=True, capture_output=True, text=True).stdout
+    rows = {}
+    for row in csv.DictReader(io.StringIO(output)):
+        if not row["container"].startswith(CONTAINERS) or row["container"].endswith(VARIANTS):
+            continue
+        key = (row["suite"], row["container"], row["operation"], int(row["size"]), row["unit"])
+        rows[key] = float(row["value"])
+
+    return rows
+
+
+def measure(presets, arguments, runs, cpu):
+    samples = {preset: {} for preset in presets}
+
+    for index in range(runs):
+        for preset in presets:
+            for suite in SUITES:
+                print(f"round {index + 1}/{runs}: {preset} {suite}", file=sys.stderr)
+                for key, value in run(preset, suite, arguments, cpu).items():
+                    samples[preset].setdefault(key, []).append(value)
+
+    medians = {preset: {key: statistics.median(values) for key, values in rows.items()}
+               for preset, rows in samples.items()}
+    # Run-to-run spread of each build: the median over rows of (max - min) / median.
+    spreads = {preset: statistics.median((max(values) - min(values)) / statistics.median(values)
+                                         for values in rows.values() if statistics.median(values) > 0)
+               for preset, rows in samples.items()}
+
+    return medians, spreads
+
+
+def geometric_mean(ratios):
+    return math.exp(sum(math.log(ratio) for ratio in ratios) / len(ratios)) if ratios else float("nan")
+
+
+def speedup(baseline, value):
+    return baseline / value if value > 0 else float("nan")
+
+
+def report(results, spreads, presets, arguments, runs, cpu, out):
+    baseline = presets[0]
+    compared = presets[1:]
+    keys = sorted(key for key in results[baseline] if key[4] in TIME_UNITS)
+
+    compiler = subprocess.run(["c++", "--version"], capture_output=True, text=True).stdout.splitlines()
+    commit = subprocess.run(["git", "rev-parse", "--short", "HEAD"], cwd=ROOT, capture_output=True, text=True).stdout.strip()
+
+    out.write("# LTO and PGO on the list benchmarks\n\n")
+    out.write(f"- commit: {commit or 'unknown'}\n")
+    out.write(f"- compiler: {compiler[0] if compiler else 'unknown'}\n")
+    out.write(f"- benchmark arguments: {' '.join(arguments)}\n")
+    out.write(f"- runs per build: {runs}, pinned to CPU {cpu}\n" if cpu is not None and shutil.which("taskset")
+              else f"- runs per build: {runs}, not pinned\n")
+    out.write("- run-to-run spread: " + ", ".join(f"{preset} {spreads[preset]:.1%}" for preset in presets) + "\n")
+    out.write(f"- speedup is {baseline} time / build time; above 1 is faster\n\n")
+
+    out.write("## Geometric-mean speedup\n\n")
+    out.write("| suite | container | " + " | ".join(compared) + " |\n")
+    out.write("|---|---|" + "---|" * len(compared) + "\n")
+    for group in sorted({(key[0], key[1]) for key in keys}):
+        cells = []
+        for preset in compared:
+            ratios = [speedup(results[baseline][key], results[preset][key])
+                      for key in keys if (key[0], key[1]) == group and key in results[preset]]
+            cells.append(f"{geometric_mean([ratio for ratio in ratios if ratio == ratio]):.3f}")
+        out.write(f"| {group[0]} | {group[1]} | " + " | ".join(cells) + " |\n")
+
+    out.write("\n## Every row\n\n")
+    out.write(f"| suite | container | operation | size | unit | {baseline} | "
+              + " | ".join(compared) + " |\n")
+    out.write("|---|---|---|---|---|---|" + "---|" * len(compared) + "\n")
+    for key in keys:
+        cells = []
+        for preset in compared:
+            value = results[preset].get(key)
+            cells.append(f"{value:.2f} ({speedup(results[baseline][key], value):.2f}x)" if value is not None else "-")
+        suite, container, operation, size, unit = key
+        out.write(f"| {suite} | {container} | {operation} | {size} | {unit} | {results[baseline][key]:.2f} | "
+                  + " | ".join(cells) + " |\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare the release, LTO and PGO builds.")
+    parser.add_argument("--presets", default="release,lto,pgo,pgo-lto",
+                        help="comma-separated presets; the first is the baseline")
+    parser.add_argument("--runs", type=int, default=5, help="benchmark runs per build")
+    parser.add_argument("--cpu", type=int, default=0, help="CPU to pin the runs to, or -1 for none")
+    parser.add_argument("--skip-build", action="store_true", help="reuse the builds already in build/")
+    parser.add_argument("--output", help="write the report here instead of stdout")
+    parser.add_argument("arguments", nargs="*", help="dsa_benchmarks arguments, after --")
+    options = parser.parse_args()
+
+    presets = options.presets.split(",")
+    arguments = options.arguments or ["--max-size", "100000", "--samples", "3"]
+    cpu = options.cpu if options.cpu >= 0 else None
+
+    if not options.skip_build:
+        build(presets)
+
+    results, spreads = measure(presets, arguments, max(options.runs, 1), cpu)
+
+    if options.output:
+        with open(options.output, "w") as out:
+            report(results, spreads, presets, arguments, options.runs, cpu, out)
+    else:
+        report(results, spreads, presets, arguments, options.runs, cpu, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
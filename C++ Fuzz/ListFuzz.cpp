@@ -0,0 +1,342 @@
+#include "BasicList.h"
+#include "DoublyLinkedList.h"
+#include "IndexedList.h"
+#include "SinglyLinkedList.h"
+#include "XorLinkedList.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// Differential fuzzer: decodes the input into a sequence of list operations,
+// applies it to every list and to a std::list model, and aborts as soon as
+// a list disagrees with the model.
+//
+// Built against libFuzzer when the compiler supports -fsanitize=fuzzer. The
+// standalone driver at the bottom is used otherwise; it replays the files
+// named on the command line, or runs a fixed number of pseudo-random inputs
+// when given none, which is what the ctest smoke test does.
+
+namespace {
+
+	class Input {
+	private:
+		const uint8_t* m_data;
+		size_t m_size;
+	public:
+		Input(const uint8_t* data, size_t size) : m_data(data), m_size(size) {};
+
+		bool empty() const { return m_size == 0; }
+
+		uint8_t next() {
+			if (m_size == 0)
+				return 0;
+
+			--m_size;
+			return *m_data++;
+		}
+	};
+
+	void check(bool condition, const char* what) {
+		if (!condition) {
+			std::fprintf(stderr, "list disagrees with std::list: %s\n", what);
+			std::abort();
+		}
+	}
+
+	template <typename List>
+	void check_contents(List& list, const std::list<int>& model) {
+		check(list.size() == model.size(), "size");
+		if (model.empty())
+			return;
+
+		auto expected = model.begin();
+		for (auto it = list.begin(); it != list.end(); ++it, ++expected)
+			check(expected != model.end() && *it == *expected, "contents");
+		check(expected == model.end(), "length");
+	}
+
+	template <typename Call>
+	bool throws_out_of_range(Call call) {
+		try {
+			call();
+		}
+		catch (const std::out_of_range&) {
+			return true;
+		}
+
+		return false;
+	}
+
+	// Lists built on BasicList, whatever bookkeeping their features keep,
+	// including operations on an empty list and indices past the end.
+	template <typename List>
+	void run_basic(const uint8_t* data, size_t size) {
+		Input input{ data, size };
+		List list;
+		std::list<int> model;
+
+		while (!input.empty()) {
+			uint8_t operation = input.next();
+			int value = input.next() % 16;
+			size_t length = model.size();
+
+			switch (operation % 9) {
+			case 0:
+			case 1:
+				list.append(value);
+				model.push_back(value);
+				break;
+			case 2: {
+				// up to one past the end, which appends
+				size_t index = input.next() % (length + 2);
+				list.insert(static_cast<int>(index), value);
+				model.insert(std::next(model.begin(), std::min(index, length)), value);
+				break;
+			}
+			case 3: {
+				size_t index = input.next() % (length + 1);
+				if (index == length)
+					check(throws_out_of_range([&] { list.pop(index); }), "pop(index) past the end");
+				else {
+					check(list.pop(index) == *std::next(model.begin(), index), "pop(index)");
+					model.erase(std::next(model.begin(), index));
+				}
+				break;
+			}
+			case 4:
+				if (length == 0)
+					check(throws_out_of_range([&] { list.pop(); }), "pop() on an empty list");
+				else {
+					check(list.pop() == model.back(), "pop()");
+					model.pop_back();
+				}
+				break;
+			case 5:
+				list.remove(value);
+				for (auto it = model.begin(); it != model.end(); ++it) {
+					if (*it == value) {
+						model.erase(it);
+						break;
+					}
+				}
+				break;
+			case 6:
+				list.remove_all(value);
+				model.remove(value);
+				break;
+			case 7: {
+				size_t index = input.next() % (length + 1);
+				if (index == length)
+					check(throws_out_of_range([&] { list.index(index); }), "index past the end");
+				else
+					check(list.index(index) == *std::next(model.begin(), index), "index");
+				check(list.count(value) == static_cast<int>(std::count(model.begin(), model.end(), value)), "count");
+				break;
+			}
+			default:
+				if (value == 0) {
+					list.clear();
+					model.clear();
+				}
+				else if (value < 4) {
+					list.compact();
+				}
+				else {
+					list.compact_step(value);
+				}
+				break;
+			}
+
+			check(list.size() == model.size(), "size");
+			check(model.empty() ? !list.back() : list.back()->data() == model.back(), "back");
+		}
+
+		check_contents(list, model);
+
+		if constexpr (List::back_links) {
+			auto expected = model.rbegin();
+			for (auto it = list.rbegin(); it != list.rend(); ++it, ++expected)
+				check(expected != model.rend() && *it == *expected, "reverse contents");
+			check(expected == model.rend(), "reverse length");
+		}
+	}
+
+	void run_indexed(const uint8_t* data, size_t size) {
+		Input input{ data, size };
+		IndexedList<int> list;
+		std::list<int> model;
+
+		while (!input.empty()) {
+			uint8_t operation = input.next();
+			int value = input.next() % 16;
+			size_t index = input.next();
+
+			switch (operation % 8) {
+			case 0:
+			case 1:
+				list.append(value);
+				model.push_back(value);
+				break;
+			case 2: {
+				size_t position = model.empty() ? 0 : index % (model.size() + 1);
+				list.insert(static_cast<int>(position), value);
+				model.insert(std::next(model.begin(), position), value);
+				break;
+			}
+			case 3:
+				if (model.empty()) {
+					bool threw{ false };
+					try { list.pop(); }
+					catch (const std::out_of_range&) { threw = true; }
+					check(threw, "pop on empty");
+				}
+				else {
+					size_t position = index % model.size();
+					check(list.pop(position) == *std::next(model.begin(), position), "pop(index)");
+					model.erase(std::next(model.begin(), position));
+				}
+				break;
+			case 4:
+				list.remove(value);
+				for (auto it = model.begin(); it != model.end(); ++it) {
+					if (*it == value) {
+						model.erase(it);
+						break;
+					}
+				}
+				break;
+			case 5:
+				list.remove_all(value);
+				model.remove(value);
+				break;
+			case 6:
+				if (!model.empty()) {
+					size_t position = index % model.size();
+					check(list.index(position) == *std::next(model.begin(), position), "index");
+				}
+				check(list.count(value) == static_cast<int>(std::count(model.begin(), model.end(), value)), "count");
+				break;
+			default:
+				list.clear();
+				model.clear();
+				break;
+			}
+
+			check(list.size() == model.size(), "size");
+		}
+
+		check_contents(list, model);
+	}
+
+	void run_xor(const uint8_t* data, size_t size) {
+		Input input{ data, size };
+		XorLinkedList<int> list;
+		std::list<int> model;
+
+		while (!input.empty()) {
+			uint8_t operation = input.next();
+			int value = input.next() % 16;
+
+			switch (operation % 7) {
+			case 0:
+				list.append(value);
+				model.push_back(value);
+				break;
+			case 1:
+				list.prepend(value);
+				model.push_front(value);
+				break;
+			case 2:
+				if (!model.empty()) {
+					check(list.pop_front() == model.front(), "pop_front");
+					model.pop_front();
+				}
+				break;
+			case 3:
+				if (!model.empty()) {
+					check(list.pop_back() == model.back(), "pop_back");
+					model.pop_back();
+				}
+				break;
+			case 4:
+				if (!model.empty()) {
+					size_t position = input.next() % model.size();
+					check(list.index(position) == *std::next(model.begin(), position), "index");
+				}
+				break;
+			case 5: {
+				XorLinkedList<int> copy{ list };
+				list = std::move(copy);
+				break;
+			}
+			default:
+				list.clear();
+				model.clear();
+				break;
+			}
+
+			check(list.size() == model.size(), "size");
+		}
+
+		check_contents(list, model);
+
+		auto expected = model.rbegin();
+		for (auto it = list.rbegin(); it != list.rend(); ++it, ++expected)
+			check(expected != model.rend() && *it == *expected, "reverse contents");
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	run_basic<SinglyLinkedList<int>>(data, size);
+	run_basic<DoublyLinkedList<int>>(data, size);
+	run_basic<BasicList<int, ListFeatures<false, false, false, ExclusiveOwnership>>>(data, size);
+	run_basic<BasicList<int, ListFeatures<true, false, false, ExclusiveOwnership>>>(data, size);
+	run_indexed(data, size);
+	run_xor(data, size);
+
+	return 0;
+}
+
+#if !defined(DSA_LIBFUZZER)
+
+#include <fstream>
+#include <iostream>
+#include <random>
+
+int main(int argc, char* argv[]) {
+	if (argc > 1) {
+		for (int idx = 1; idx < argc; ++idx) {
+			std::ifstream file(argv[idx], std::ios::binary);
+			std::vector<uint8_t> bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+			LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+		}
+
+		std::cout << "replayed " << argc - 1 << " inputs\n";
+		return 0;
+	}
+
+	const size_t runs{ 2000 };
+	std::mt19937 generator{ 20240229 };
+	std::uniform_int_distribution<int> byte(0, 255);
+	std::uniform_int_distribution<size_t> length(0, 512);
+
+	for (size_t run = 0; run < runs; ++run) {
+		std::vector<uint8_t> bytes(length(generator));
+		for (auto& value : bytes)
+			value = static_cast<uint8_t>(byte(generator));
+
+		LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+	}
+
+	std::cout << "ran " << runs << " random inputs\n";
+	return 0;
+}
+
+#endif
@@ -0,0 +1,171 @@
+#include "catch.hpp"
+#include "ARCCache.h"
+#include <random>
+#include <string>
+
+TEST_CASE("ARCCache") {
+	using Segment = ARCCache<int, std::string>::Segment;
+	ARCCache<int, std::string> cache{ 4 };
+
+	SECTION("Get and put") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+
+		REQUIRE(cache.get(1) == "one");
+		REQUIRE(cache.get(2) == "two");
+		REQUIRE_FALSE(cache.get(3));
+		REQUIRE(cache.size() == 2);
+
+		cache.put(1, "uno");
+		REQUIRE(cache.get(1) == "uno");
+		REQUIRE(cache.size() == 2);
+	}
+
+	SECTION("Hits move entries to the frequent list") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+		REQUIRE(cache.segment(1) == Segment::Recent);
+
+		cache.get(1);
+		REQUIRE(cache.segment(1) == Segment::Frequent);
+		REQUIRE(cache.recent_size() == 1);
+		REQUIRE(cache.frequent_size() == 1);
+		REQUIRE_FALSE(cache.segment(3));
+	}
+
+	SECTION("Recent ghosts grow the recent target") {
+		cache.put(1, "one");
+		cache.get(1);
+		cache.put(2, "two");
+		cache.put(3, "three");
+		cache.put(4, "four");
+		cache.put(5, "five");
+
+		REQUIRE(cache.segment(2) == Segment::RecentGhost);
+		REQUIRE_FALSE(cache.contains(2));
+		REQUIRE_FALSE(cache.get(2));
+		REQUIRE(cache.recent_ghosts() == 1);
+
+		cache.put(2, "dos");
+		REQUIRE(cache.target_recent() == 1);
+		REQUIRE(cache.segment(2) == Segment::Frequent);
+		REQUIRE(cache.segment(3) == Segment::RecentGhost);
+		REQUIRE(cache.get(2) == "dos");
+		REQUIRE(cache.size() == 4);
+	}
+
+	SECTION("Frequent ghosts shrink the recent target") {
+		using SmallSegment = ARCCache<int, int>::Segment;
+		ARCCache<int, int> small{ 2 };
+		small.put(1, 1);
+		small.get(1);
+		small.put(2, 2);
+		small.get(2);
+		small.put(3, 3);
+		REQUIRE(small.segment(1) == SmallSegment::FrequentGhost);
+
+		small.put(1, 1);
+		REQUIRE(small.segment(1) == SmallSegment::Frequent);
+		REQUIRE(small.segment(3) == SmallSegment::RecentGhost);
+
+		small.put(3, 3);
+		REQUIRE(small.target_recent() == 1);
+		REQUIRE(small.segment(2) == SmallSegment::FrequentGhost);
+
+		small.put(2, 2);
+		REQUIRE(small.target_recent() == 0);
+		REQUIRE(small.segment(2) == SmallSegment::Frequent);
+	}
+
+	SECTION("Keeps frequent entries through a scan") {
+		ARCCache<int, int> large{ 100 };
+		for (int key = 0; key < 50; ++key) {
+			large.put(key, key);
+			large.get(key);
+		}
+
+		for (int key = 1000; key < 2000; ++key)
+			large.put(key, key);
+
+		for (int key = 0; key < 50; ++key)
+			REQUIRE(large.contains(key));
+		REQUIRE(large.size() == 100);
+	}
+
+	SECTION("List sizes stay in bounds") {
+		ARCCache<int, int> large{ 64 };
+		std::mt19937 generator{ 3 };
+		std::uniform_int_distribution<int> keys(0, 400);
+		std::uniform_int_distribution<int> actions(0, 9);
+
+		for (int step = 0; step < 20000; ++step) {
+			int key = keys(generator);
+			int action = actions(generator);
+			if (action == 0)
+				large.erase(key);
+			else if (!large.get(key))
+				large.put(key, key);
+
+			REQUIRE(large.size() <= 64);
+			REQUIRE(large.recent_size() + large.recent_ghosts() <= 64);
+			REQUIRE(large.size() + large.recent_ghosts() + large.frequent_ghosts() <= 128);
+			REQUIRE(large.target_recent() <= 64);
+		}
+	}
+
+	SECTION("Erase and clear") {
+		cache.put(1, "one");
+		cache.get(1);
+		cache.put(2, "two");
+
+		REQUIRE(cache.erase(1));
+		REQUIRE_FALSE(cache.erase(1));
+		REQUIRE(cache.erase(2));
+		REQUIRE(cache.size() == 0);
+
+		cache.put(3, "three");
+		cache.clear();
+		REQUIRE(cache.size() == 0);
+		REQUIRE(cache.target_recent() == 0);
+		cache.put(4, "four");
+		REQUIRE(cache.get(4) == "four");
+	}
+
+	SECTION("Stats") {
+		cache.put(1, "one");
+		cache.get(1);
+		cache.get(2);
+		for (int key = 2; key < 8; ++key)
+			cache.put(key, "many");
+
+		REQUIRE(cache.stats().hits == 1);
+		REQUIRE(cache.stats().misses == 1);
+		REQUIRE(cache.stats().insertions == 7);
+		REQUIRE(cache.stats().evictions == 3);
+	}
+
+	SECTION("Recycles pool slots") {
+		NodePool* pool = NodePool::create();
+		{
+			ARCCache<int, int> pooled{ 64, PoolAllocator<std::pair<int, int>>{ pool } };
+			for (int key = 0; key < 1000; ++key)
+				if (!pooled.get(key % 97))
+					pooled.put(key % 97, key);
+
+			size_t blocks = pool->blocks();
+
+			for (int key = 0; key < 20000; ++key)
+				if (!pooled.get(key % 131))
+					pooled.put(key % 131, key);
+
+			REQUIRE(pool->blocks() == blocks);
+		}
+
+		REQUIRE(pool->live_slots() == 0);
+		pool->unreference();
+	}
+
+	SECTION("Capacity must be positive") {
+		REQUIRE_THROWS_AS((ARCCache<int, int>{ 0 }), std::invalid_argument);
+	}
+}
@@ -0,0 +1,232 @@
+#include "catch.hpp"
+#include "BasicList.h"
+#include "CountingAllocator.h"
+#include "DoublyLinkedList.h"
+#include "SinglyLinkedList.h"
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+	using Exclusive = ExclusiveOwnership;
+	using Bare = ListFeatures<false, false, false, Exclusive, false>;
+	using BareDoubly = ListFeatures<true, false, false, Exclusive, false>;
+
+	template <typename List>
+	auto contents(List& list) {
+		using T = std::decay_t<decltype(*list.begin())>;
+		return std::vector<T>(list.begin(), list.end());
+	}
+
+	// The sequence of operations SmallList and StaticList are checked with,
+	// on a list of any feature set.
+	template <typename List>
+	void exercise() {
+		int arr[]{ 0, 1, 2, 3, 4 };
+		List list{ arr, 5 };
+
+		list.insert(0, -1);
+		list.insert(3, 100);
+		list.insert(99, 5);
+		list.insert(-1, 6);
+		REQUIRE(contents(list) == std::vector<int>{ -1, 0, 1, 100, 2, 3, 4, 5, 6 });
+		REQUIRE(list.back()->data() == 6);
+
+		REQUIRE(list.pop() == 6);
+		REQUIRE(list.pop(0) == -1);
+		REQUIRE(list.pop(2) == 100);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+		REQUIRE(list.back()->data() == 5);
+
+		list.append(2);
+		list.remove(2);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4, 5, 2 });
+		REQUIRE(list.count(2) == 1);
+
+		list.append(2);
+		list.remove_all(2);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4, 5 });
+		REQUIRE(list.back()->data() == 5);
+
+		list.remove(5);
+		list.append(7);
+		REQUIRE(list.index(list.size() - 1) == 7);
+
+		REQUIRE_THROWS_AS(list.index(5), std::out_of_range);
+		REQUIRE_THROWS_AS(list.pop(5), std::out_of_range);
+
+		list.clear();
+		REQUIRE(list.empty());
+		REQUIRE(list.size() == 0);
+		REQUIRE_FALSE(list.back());
+		REQUIRE(list.begin() == list.end());
+		REQUIRE_THROWS_AS(list.pop(), std::out_of_range);
+	}
+
+	// remove() and remove_all() given one of the list's own elements, which
+	// the first match frees.
+	template <typename List>
+	void remove_own_element() {
+		List list;
+		for (const char* val : { "ccc", "a", "ccc", "a", "ccc" })
+			list.append(val);
+
+		list.remove_all(*list.begin());
+		REQUIRE(contents(list) == std::vector<std::string>{ "a", "a" });
+		list.remove(*list.begin());
+		REQUIRE(contents(list) == std::vector<std::string>{ "a" });
+	}
+
+	// Each switch that is off takes its field out of the list or the node.
+	using Singly = SinglyLinkedList<int>;
+	using Link = std::shared_ptr<Singly::Node>;
+
+	static_assert(sizeof(BasicList<int, ListFeatures<false, false>>) == sizeof(Singly) - sizeof(size_t));
+	static_assert(sizeof(BasicList<int, ListFeatures<false, true, false>>) == sizeof(Singly) - sizeof(Link));
+	static_assert(sizeof(BasicList<int, ListFeatures<false, true, true, Exclusive>>)
+		== sizeof(Singly) - 2 * (sizeof(Link) - sizeof(void*)));
+	static_assert(sizeof(BasicList<int, ListFeatures<false, false, false, Exclusive>>)
+		== sizeof(Singly) - sizeof(size_t) - sizeof(Link) - (sizeof(Link) - sizeof(void*)));
+	static_assert(sizeof(BasicList<int, Bare>) == sizeof(void*));
+	static_assert(sizeof(BasicList<int, BareDoubly>) == sizeof(void*));
+	static_assert(sizeof(DoublyLinkedList<int>) == sizeof(Singly));
+
+	struct SinglyNodeLayout {
+		int data;
+		void* next;
+	};
+
+	struct DoublyNodeLayout {
+		void* prev;
+		int data;
+		void* next;
+	};
+
+	static_assert(sizeof(BasicList<int, Bare>::Node) == sizeof(SinglyNodeLayout));
+	static_assert(sizeof(BasicList<int, BareDoubly>::Node) == sizeof(DoublyNodeLayout));
+	static_assert(sizeof(Singly::Node) == sizeof(Link) + sizeof(SinglyNodeLayout) - sizeof(void*));
+}
+
+TEST_CASE("BasicList") {
+	SECTION("Every feature set matches SinglyLinkedList's operations") {
+		exercise<SinglyLinkedList<int>>();
+		exercise<DoublyLinkedList<int>>();
+		exercise<BasicList<int, ListFeatures<false, false>>>();
+		exercise<BasicList<int, ListFeatures<false, true, false>>>();
+		exercise<BasicList<int, ListFeatures<true, false, false>>>();
+		exercise<BasicList<int, ListFeatures<false, true, true, Exclusive>>>();
+		exercise<BasicList<int, Bare>>();
+		exercise<BasicList<int, BareDoubly>>();
+	}
+
+	SECTION("Removes a value that is one of its own elements") {
+		remove_own_element<SinglyLinkedList<std::string>>();
+		remove_own_element<DoublyLinkedList<std::string>>();
+		remove_own_element<BasicList<std::string, Bare>>();
+		remove_own_element<BasicList<std::string, BareDoubly>>();
+	}
+
+	SECTION("Handles without a count or a tail") {
+		int arr[]{ 0, 1, 2, 3, 4 };
+		BasicList<int, Bare> list{ arr, 5 };
+		BasicList<int, Bare> other;
+
+		auto second = list.front()->next();
+		list.erase_after(second);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4 });
+
+		auto inserted = list.insert_after(list.back(), 5);
+		REQUIRE(list.back() == inserted);
+		REQUIRE(list.size() == 5);
+
+		other.splice_back_after(list, nullptr);
+		other.splice_back_after(list, second);
+		REQUIRE(contents(other) == std::vector<int>{ 0, 3 });
+		REQUIRE(contents(list) == std::vector<int>{ 1, 4, 5 });
+
+		list.erase_after(nullptr);
+		list.erase_after(nullptr);
+		REQUIRE(list.front() == list.back());
+		REQUIRE(list.front() == inserted);
+	}
+
+	SECTION("Back links without reference counts") {
+		int arr[]{ 0, 1, 2, 3, 4 };
+		BasicList<int, BareDoubly> list{ arr, 5 };
+		BasicList<int, BareDoubly> other;
+
+		auto second = list.front()->next();
+		list.move_to_back(second);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 2, 3, 4, 1 });
+
+		list.erase(list.front()->next());
+		other.splice_back(list, list.back());
+		other.splice_back(list, list.front());
+		REQUIRE(contents(list) == std::vector<int>{ 3, 4 });
+		REQUIRE(contents(other) == std::vector<int>{ 1, 0 });
+		REQUIRE(other.back()->data() == 0);
+
+		std::vector<int> reversed(list.rbegin(), list.rend());
+		REQUIRE(reversed == std::vector<int>{ 4, 3 });
+
+		other.splice_back(other, other.front());
+		REQUIRE(contents(other) == std::vector<int>{ 0, 1 });
+	}
+
+	SECTION("Exclusive nodes take only their own size from the allocator") {
+		using Counted = BasicList<std::string, Bare, DirectTraversal, CountingAllocator<std::string>>;
+		CountingAllocator<std::string> counting;
+		{
+			Counted list{ counting };
+			for (int val = 0; val < 10; ++val)
+				list.append(std::string(val + 1, 'a'));
+
+			auto stats = list.stats();
+			REQUIRE(stats.allocations == 10);
+			REQUIRE(stats.live_bytes == 10 * sizeof(Counted::Node));
+
+			Counted moved{ std::move(list) };
+			REQUIRE(list.empty());
+			REQUIRE(moved.stats().allocations == 10);
+			REQUIRE(moved.pop(0) == "a");
+			REQUIRE(moved.size() == 9);
+
+			list = std::move(moved);
+			REQUIRE(moved.empty());
+			REQUIRE(list.index(8) == std::string(10, 'a'));
+		}
+
+		REQUIRE(counting.stats().frees == 10);
+		REQUIRE(counting.stats().live_nodes == 0);
+	}
+
+	SECTION("Exclusive lists compact, save and load") {
+		BasicList<int, ListFeatures<true, false, false, Exclusive>> list;
+		for (int val = 0; val < 100; ++val)
+			list.append(val);
+		for (int val = 0; val < 100; val += 3)
+			list.remove(val);
+
+		REQUIRE_FALSE(list.compact_step(10));
+		list.remove(1);
+		while (!list.compact_step(10))
+			;
+		std::vector<int> expected;
+		for (int val = 2; val < 100; ++val)
+			if (val % 3 != 0)
+				expected.push_back(val);
+		REQUIRE(contents(list) == expected);
+
+		std::stringstream stream;
+		list.save(stream);
+		BasicList<int, BareDoubly> loaded;
+		loaded.append(-1);
+		loaded.load(stream);
+		REQUIRE(contents(loaded) == expected);
+		REQUIRE(*loaded.rbegin() == expected.back());
+		REQUIRE(loaded.back()->data() == expected.back());
+	}
+}
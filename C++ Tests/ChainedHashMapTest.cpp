@@ -0,0 +1,200 @@
+#include "catch.hpp"
+#include "ChainedHashMap.h"
+#include "SinglyLinkedList.h"
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("SinglyLinkedList handles") {
+	const size_t arr_size{ 5 };
+	int arr[arr_size]{ 0,1,2,3,4 };
+	SinglyLinkedList<int> list{ arr, arr_size };
+
+	auto contents = [&] {
+		std::vector<int> values;
+		for (auto node = list.front(); node; node = node->next())
+			values.push_back(node->data());
+		return values;
+	};
+
+	SECTION("Erase after") {
+		list.erase_after(nullptr);
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 3, 4 });
+
+		auto second{ list.front()->next() };
+		list.erase_after(second);
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 4 });
+
+		list.erase_after(second);
+		REQUIRE(contents() == std::vector<int>{ 1, 2 });
+		REQUIRE(list.back() == second);
+
+		list.erase_after(nullptr);
+		list.erase_after(nullptr);
+		REQUIRE(list.size() == 0);
+		REQUIRE_FALSE(list.front());
+		REQUIRE_FALSE(list.back());
+
+		list.append(9);
+		REQUIRE(list.front() == list.back());
+	}
+
+	SECTION("Splice back after") {
+		SinglyLinkedList<int> other;
+		auto moved{ list.front() };
+
+		other.splice_back_after(list, nullptr);
+		REQUIRE(other.front() == moved);
+		REQUIRE(other.back() == moved);
+		REQUIRE(other.size() == 1);
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 3, 4 });
+
+		other.splice_back_after(list, list.front()->next()->next());
+		REQUIRE(other.back()->data() == 4);
+		REQUIRE(list.back()->data() == 3);
+		REQUIRE(list.size() == 3);
+
+		list.splice_back_after(other, nullptr);
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 3, 0 });
+		REQUIRE(other.front() == other.back());
+	}
+}
+
+TEST_CASE("ChainedHashMap") {
+	ChainedHashMap<int, std::string> map;
+
+	SECTION("Insert, find and erase") {
+		REQUIRE(map.empty());
+		REQUIRE(map.insert_or_assign(1, "one"));
+		REQUIRE(map.insert_or_assign(2, "two"));
+		REQUIRE_FALSE(map.insert_or_assign(1, "uno"));
+
+		REQUIRE(map.size() == 2);
+		REQUIRE(*map.find(1) == "uno");
+		REQUIRE(map.contains(2));
+		REQUIRE_FALSE(map.find(3));
+
+		REQUIRE(map.erase(1));
+		REQUIRE_FALSE(map.erase(1));
+		REQUIRE_FALSE(map.contains(1));
+		REQUIRE(map.size() == 1);
+	}
+
+	SECTION("Grows a few buckets at a time") {
+		REQUIRE(map.bucket_count() == ChainedHashMap<int, std::string>::min_buckets);
+
+		bool rehashed{ false };
+		for (int key = 0; key < 1000; ++key) {
+			map.insert_or_assign(key, std::to_string(key));
+			rehashed = rehashed || map.rehashing();
+
+			const auto& view = map;
+			for (int check = 0; check <= key; check += 37)
+				REQUIRE(view.find(check));
+		}
+
+		REQUIRE(rehashed);
+		REQUIRE(map.load_factor() <= 1.0);
+		for (int key = 0; key < 1000; ++key)
+			REQUIRE(*map.find(key) == std::to_string(key));
+
+		// a rehash of n buckets finishes within n / rehash_step operations
+		size_t buckets = map.bucket_count();
+		while (!map.rehashing())
+			map.insert_or_assign(static_cast<int>(map.size()) + 1000, "more");
+		for (size_t step = 0; step < buckets / ChainedHashMap<int, std::string>::rehash_step; ++step)
+			map.find(0);
+		REQUIRE_FALSE(map.rehashing());
+		REQUIRE(map.bucket_count() == 2 * buckets);
+	}
+
+	SECTION("Matches std::unordered_map") {
+		std::unordered_map<int, int> expected;
+		ChainedHashMap<int, int> actual;
+		std::mt19937 generator{ 5 };
+		std::uniform_int_distribution<int> keys(0, 3000);
+		std::uniform_int_distribution<int> actions(0, 3);
+
+		for (int step = 0; step < 50000; ++step) {
+			int key = keys(generator);
+			switch (actions(generator)) {
+			case 0:
+				REQUIRE(actual.erase(key) == (expected.erase(key) == 1));
+				break;
+			case 1: {
+				auto found = expected.find(key);
+				int* value = actual.find(key);
+				REQUIRE((value != nullptr) == (found != expected.end()));
+				if (value)
+					REQUIRE(*value == found->second);
+				break;
+			}
+			default:
+				REQUIRE(actual.insert_or_assign(key, step) == expected.insert_or_assign(key, step).second);
+				break;
+			}
+			REQUIRE(actual.size() == expected.size());
+		}
+
+		size_t visited{ 0 };
+		actual.for_each([&](int key, int value) {
+			REQUIRE(expected.at(key) == value);
+			++visited;
+		});
+		REQUIRE(visited == expected.size());
+	}
+
+	SECTION("Chains colliding keys") {
+		struct Collide {
+			size_t operator()(int) const noexcept { return 42; }
+		};
+
+		ChainedHashMap<int, int, Collide> colliding;
+		for (int key = 0; key < 100; ++key)
+			colliding.insert_or_assign(key, key * 2);
+
+		REQUIRE(colliding.size() == 100);
+		for (int key = 0; key < 100; key += 2)
+			REQUIRE(colliding.erase(key));
+		for (int key = 1; key < 100; key += 2)
+			REQUIRE(*colliding.find(key) == key * 2);
+		REQUIRE_FALSE(colliding.contains(0));
+	}
+
+	SECTION("Buckets share one pool") {
+		NodePool* pool = NodePool::create();
+		{
+			ChainedHashMap<int, int> pooled{ 8, PoolAllocator<std::pair<int, int>>{ pool } };
+			for (int key = 0; key < 5000; ++key)
+				pooled.insert_or_assign(key, key);
+			REQUIRE(pool->live_slots() == 5000);
+
+			for (int key = 0; key < 5000; key += 2)
+				pooled.erase(key);
+			REQUIRE(pool->live_slots() == 2500);
+
+			size_t blocks = pool->blocks();
+			for (int key = 0; key < 5000; key += 2)
+				pooled.insert_or_assign(key, key);
+			REQUIRE(pool->blocks() == blocks);
+		}
+
+		REQUIRE(pool->live_slots() == 0);
+		pool->unreference();
+	}
+
+	SECTION("Clear") {
+		for (int key = 0; key < 100; ++key)
+			map.insert_or_assign(key, "many");
+
+		map.clear();
+		REQUIRE(map.size() == 0);
+		REQUIRE_FALSE(map.rehashing());
+		REQUIRE(map.bucket_count() == ChainedHashMap<int, std::string>::min_buckets);
+		REQUIRE_FALSE(map.contains(5));
+
+		map.insert_or_assign(5, "five");
+		REQUIRE(*map.find(5) == "five");
+	}
+}
@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include "SinglyLinkedList.h"
+#include "DoublyLinkedList.h"
+#include <memory>
+
+TEST_CASE("Compaction") {
+	const size_t arr_size{ 64 };
+	int arr[arr_size];
+	for (size_t idx = 0; idx < arr_size; ++idx)
+		arr[idx] = static_cast<int>(idx);
+
+	SECTION("SinglyLinkedList compact") {
+		SinglyLinkedList<int> list{ arr, arr_size };
+		for (int val = 0; val < 64; val += 3)
+			list.remove(val);
+		list.insert(5, 100);
+
+		SinglyLinkedList<int> expected{ arr, arr_size };
+		for (int val = 0; val < 64; val += 3)
+			expected.remove(val);
+		expected.insert(5, 100);
+
+		list.compact();
+
+		REQUIRE(list.size() == expected.size());
+		for (size_t idx = 0; idx < expected.size(); ++idx)
+			REQUIRE(list.index(idx) == expected.index(idx));
+
+		auto prev{ list.front() };
+		for (auto current = prev->next(); current; current = current->next()) {
+			REQUIRE(current.get() > prev.get());
+			prev = current;
+		}
+		REQUIRE(prev == list.back());
+
+		list.append(7);
+		REQUIRE(list.back()->data() == 7);
+		REQUIRE(list.size() == expected.size() + 1);
+	}
+
+	SECTION("SinglyLinkedList keeps held nodes in place") {
+		SinglyLinkedList<int> list{ arr, arr_size };
+		auto held{ list.front()->next() };
+
+		list.compact();
+
+		REQUIRE(list.front()->next() == held);
+		REQUIRE(held->data() == 1);
+		REQUIRE(list.index(2) == 2);
+	}
+
+	SECTION("SinglyLinkedList incremental") {
+		SinglyLinkedList<int> list{ arr, arr_size };
+
+		REQUIRE_FALSE(list.compact_step(10));
+		list.pop(0);
+		list.remove(20);
+		REQUIRE_FALSE(list.compact_step(10));
+		list.append(64);
+
+		while (!list.compact_step(10))
+			list.pop(3);
+
+		REQUIRE(list.index(0) == 1);
+		REQUIRE(list.back()->data() == 64);
+		REQUIRE(list.count(20) == 0);
+
+		size_t visited{ 0 };
+		for (auto it = list.begin(); it != list.end(); ++it)
+			++visited;
+		REQUIRE(visited == list.size());
+	}
+
+	SECTION("DoublyLinkedList compact") {
+		DoublyLinkedList<int> list{ arr, arr_size };
+		list.remove(10);
+		list.pop(20);
+
+		list.compact();
+
+		REQUIRE(list.size() == arr_size - 2);
+		REQUIRE(list.count(10) == 0);
+		REQUIRE(list.index(0) == 0);
+		REQUIRE(list.index(list.size() - 1) == 63);
+
+		int expected{ 63 };
+		for (auto it = list.rbegin(); it != list.rend(); ++it) {
+			if (expected == 21 || expected == 10)
+				--expected;
+			REQUIRE(*it == expected--);
+		}
+		REQUIRE(expected == -1);
+	}
+
+	SECTION("DoublyLinkedList incremental") {
+		DoublyLinkedList<int> list{ arr, arr_size };
+
+		REQUIRE_FALSE(list.compact_step(16));
+		list.remove(40);
+		while (!list.compact_step(16)) {}
+
+		REQUIRE(list.size() == arr_size - 1);
+		REQUIRE(list.count(40) == 0);
+		REQUIRE(list.index(40) == 41);
+	}
+}
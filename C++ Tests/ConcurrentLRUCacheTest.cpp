@@ -0,0 +1,123 @@
+#include "catch.hpp"
+#include "ConcurrentLRUCache.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("ConcurrentLRUCache") {
+	SECTION("Get and put") {
+		ConcurrentLRUCache<int, std::string> cache{ 64, 4 };
+		cache.put(1, "one");
+		cache.put(2, "two");
+
+		REQUIRE(cache.get(1) == "one");
+		REQUIRE(cache.get(2) == "two");
+		REQUIRE_FALSE(cache.get(3));
+		REQUIRE(cache.erase(1));
+		REQUIRE_FALSE(cache.get(1));
+		REQUIRE(cache.size() == 1);
+
+		cache.clear();
+		REQUIRE(cache.size() == 0);
+	}
+
+	SECTION("Capacity is split over the shards") {
+		ConcurrentLRUCache<int, int> cache{ 10, 4 };
+
+		size_t total{ 0 };
+		for (size_t shard = 0; shard < cache.shard_count(); ++shard)
+			total += cache.shard_stats(shard).capacity;
+		REQUIRE(total == 10);
+
+		for (int key = 0; key < 1000; ++key)
+			cache.put(key, key);
+		REQUIRE(cache.size() == 10);
+		REQUIRE(cache.stats().insertions == 1000);
+		REQUIRE(cache.stats().evictions == 990);
+	}
+
+	SECTION("Evicts least recently used within a shard") {
+		ConcurrentLRUCache<int, int> cache{ 3, 1 };
+		cache.put(1, 1);
+		cache.put(2, 2);
+		cache.put(3, 3);
+		cache.get(1);
+		cache.put(4, 4);
+
+		REQUIRE(cache.get(1));
+		REQUIRE_FALSE(cache.get(2));
+	}
+
+	SECTION("Buffered reads are promoted before the next write") {
+		ConcurrentLRUCache<int, int, std::hash<int>, std::equal_to<int>, BufferedRecency<8>> cache{ 3, 1 };
+		cache.put(1, 1);
+		cache.put(2, 2);
+		cache.put(3, 3);
+		cache.get(1);
+		cache.put(4, 4);
+
+		REQUIRE(cache.get(1));
+		REQUIRE_FALSE(cache.get(2));
+
+		ShardStats stats = cache.shard_stats(0);
+		REQUIRE(stats.buffered_promotions == 1);
+		REQUIRE(stats.cache.hits == 2);
+		REQUIRE(stats.cache.misses == 1);
+	}
+
+	SECTION("Invalid shard counts") {
+		REQUIRE_THROWS_AS((ConcurrentLRUCache<int, int>{ 64, 3 }), std::invalid_argument);
+		REQUIRE_THROWS_AS((ConcurrentLRUCache<int, int>{ 2, 4 }), std::invalid_argument);
+	}
+}
+
+template <typename Cache>
+void hammer(Cache& cache) {
+	const int threads{ 4 };
+	const int operations{ 20000 };
+	std::atomic<int> lookups{ 0 };
+	std::atomic<int> wrong{ 0 };
+	std::vector<std::thread> workers;
+
+	for (int worker = 0; worker < threads; ++worker) {
+		workers.emplace_back([&, worker] {
+			for (int idx = 0; idx < operations; ++idx) {
+				int key = (idx * 31 + worker * 7) % 256;
+				if (idx % 4 == 0) {
+					cache.put(key, key);
+				}
+				else if (idx % 97 == 0) {
+					cache.erase(key);
+				}
+				else {
+					auto value = cache.get(key);
+					if (value && *value != key)
+						++wrong;
+					++lookups;
+				}
+			}
+		});
+	}
+
+	for (auto& worker : workers)
+		worker.join();
+
+	REQUIRE(wrong == 0);
+
+	CacheStats stats = cache.stats();
+	REQUIRE(stats.hits + stats.misses == static_cast<uint64_t>(lookups.load()));
+	REQUIRE(cache.size() <= cache.capacity());
+}
+
+TEST_CASE("ConcurrentLRUCache threads") {
+	SECTION("Exact recency") {
+		ConcurrentLRUCache<int, int> cache{ 128, 8 };
+		hammer(cache);
+	}
+
+	SECTION("Buffered recency") {
+		ConcurrentLRUCache<int, int, std::hash<int>, std::equal_to<int>, BufferedRecency<16>> cache{ 128, 8 };
+		hammer(cache);
+	}
+}
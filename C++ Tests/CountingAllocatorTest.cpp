@@ -0,0 +1,126 @@
+#include "catch.hpp"
+#include "CountingAllocator.h"
+#include "SinglyLinkedList.h"
+#include "DoublyLinkedList.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Global heap hooks for the test binary, so the tests can check that the
+// per-container counters match what actually reached the heap.
+namespace {
+	std::atomic<size_t> g_heap_allocations{ 0 };
+}
+
+void* operator new(size_t size) {
+	g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* address = std::malloc(size ? size : 1))
+		return address;
+
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* address) noexcept {
+	std::free(address);
+}
+
+void operator delete(void* address, size_t) noexcept {
+	std::free(address);
+}
+
+void operator delete(void* address, const std::nothrow_t&) noexcept {
+	std::free(address);
+}
+
+TEST_CASE("CountingAllocator") {
+	using CountedSingly = SinglyLinkedList<int, DirectTraversal, CountingAllocator<int>>;
+	using CountedDoubly = DoublyLinkedList<int, DirectTraversal, CountingAllocator<int>>;
+
+	SECTION("Counts each node as one allocation") {
+		CountedSingly list;
+		for (int val = 0; val < 10; ++val)
+			list.append(val);
+
+		auto stats{ list.stats() };
+		REQUIRE(stats.allocations == 10);
+		REQUIRE(stats.frees == 0);
+		REQUIRE(stats.live_nodes == 10);
+		REQUIRE(stats.live_bytes > 10 * sizeof(int));
+		REQUIRE(stats.peak_bytes == stats.live_bytes);
+
+		list.pop(0);
+		list.remove(5);
+		stats = list.stats();
+		REQUIRE(stats.frees == 2);
+		REQUIRE(stats.live_nodes == 8);
+
+		size_t peak{ stats.peak_bytes };
+		list.clear();
+		stats = list.stats();
+		REQUIRE(stats.live_nodes == 0);
+		REQUIRE(stats.live_bytes == 0);
+		REQUIRE(stats.peak_bytes == peak);
+	}
+
+	SECTION("Matches the global heap hooks") {
+		size_t before{ g_heap_allocations.load() };
+		CountedDoubly counted;
+		for (int val = 0; val < 100; ++val)
+			counted.append(val);
+		size_t counted_heap{ g_heap_allocations.load() - before };
+
+		REQUIRE(counted.stats().allocations == 100);
+		REQUIRE(counted_heap == 101);
+
+		before = g_heap_allocations.load();
+		DoublyLinkedList<int> plain;
+		for (int val = 0; val < 100; ++val)
+			plain.append(val);
+
+		REQUIRE(g_heap_allocations.load() - before == 100);
+	}
+
+	SECTION("Containers count separately") {
+		CountedSingly first;
+		CountedSingly second;
+		first.append(1);
+		first.append(2);
+		second.append(3);
+
+		REQUIRE(first.stats().allocations == 2);
+		REQUIRE(second.stats().allocations == 1);
+	}
+
+	SECTION("Compaction keeps the node count") {
+		CountedDoubly list;
+		for (int val = 0; val < 64; ++val)
+			list.append(val);
+
+		list.compact();
+
+		auto stats{ list.stats() };
+		REQUIRE(stats.live_nodes == 64);
+		REQUIRE(stats.allocations == 128);
+		REQUIRE(stats.frees == 64);
+		REQUIRE(list.index(63) == 63);
+	}
+
+	SECTION("Nodes may outlive the list") {
+		std::shared_ptr<CountedSingly::Node> held;
+		{
+			CountedSingly list;
+			list.append(1);
+			list.append(2);
+			held = list.front();
+		}
+
+		REQUIRE(held->data() == 1);
+		held.reset();
+	}
+}
@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include "IndexedList.h"
+#include <memory>
+#include <stdexcept>
+
+TEST_CASE("IndexedList") {
+	const size_t arr_size{ 7 };
+	int arr[arr_size]{ 1,2,3,4,5,4,7 };
+	IndexedList<int> list{ arr, arr_size };
+
+	SECTION("Append") {
+		list.append(2);
+
+		REQUIRE(list.size() == 8);
+		REQUIRE(list.back() == 2);
+		REQUIRE(list.index(7) == 2);
+	}
+
+	SECTION("Insert") {
+		list.insert(0, 0);
+		list.insert(3, 10);
+		list.insert(100, 11);
+		list.insert(-1, 12);
+
+		int expected[]{ 0,1,2,10,3,4,5,4,7,11,12 };
+		size_t position{ 0 };
+		for (auto it = list.begin(); it != list.end(); ++it)
+			REQUIRE(*it == expected[position++]);
+
+		REQUIRE(position == 11);
+		REQUIRE(list.size() == 11);
+		REQUIRE(list.back() == 12);
+
+		IndexedList<int> empty;
+		empty.insert(-1, 1);
+		empty.insert(0, 0);
+		REQUIRE(empty.front() == 0);
+		REQUIRE(empty.back() == 1);
+	}
+
+	SECTION("Pop") {
+		REQUIRE(list.pop(0) == 1);
+		REQUIRE(list.front() == 2);
+		REQUIRE(list.pop() == 7);
+		REQUIRE(list.back() == 4);
+		REQUIRE(list.pop(3) == 5);
+		REQUIRE(list.size() == 4);
+		REQUIRE_THROWS_AS(list.pop(4), std::out_of_range);
+	}
+
+	SECTION("Remove") {
+		list.remove(4);
+		REQUIRE(list.count(4) == 1);
+		REQUIRE(list.index(3) == 5);
+
+		list.append(4);
+		list.append(4);
+		list.remove_all(4);
+		REQUIRE(list.count(4) == 0);
+		REQUIRE(list.size() == 5);
+		REQUIRE(list.back() == 7);
+	}
+
+	SECTION("Recycles freed slots") {
+		size_t slots = list.capacity();
+
+		list.pop(0);
+		list.remove(4);
+		list.append(8);
+		list.insert(1, 9);
+
+		REQUIRE(list.capacity() == slots);
+		REQUIRE(list.size() == 7);
+		REQUIRE(list.index(1) == 9);
+		REQUIRE(list.back() == 8);
+	}
+
+	SECTION("Freed slots let go of their elements") {
+		auto resource = std::make_shared<int>(1);
+		IndexedList<std::shared_ptr<int>> shared;
+		shared.append(resource);
+		shared.append(resource);
+		shared.append(resource);
+		REQUIRE(resource.use_count() == 4);
+
+		shared.pop(0);
+		shared.remove(resource);
+		REQUIRE(resource.use_count() == 2);
+
+		shared.remove_all(resource);
+		REQUIRE(resource.use_count() == 1);
+		REQUIRE(shared.size() == 0);
+	}
+
+	SECTION("Clear") {
+		list.clear();
+
+		REQUIRE(list.size() == 0);
+		REQUIRE_FALSE(list.begin() != list.end());
+		REQUIRE_THROWS_AS(list.index(0), std::out_of_range);
+
+		list.append(1);
+		REQUIRE(list.front() == 1);
+		REQUIRE(list.back() == 1);
+	}
+}
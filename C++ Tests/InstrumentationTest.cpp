@@ -0,0 +1,87 @@
+#include "catch.hpp"
+#include "Instrumentation.h"
+#include "SinglyLinkedList.h"
+#include "DoublyLinkedList.h"
+#include <memory>
+
+TEST_CASE("Histogram") {
+	Histogram histogram;
+
+	SECTION("Small values are exact") {
+		for (uint64_t value = 0; value < 16; ++value)
+			histogram.record(value);
+
+		REQUIRE(histogram.count() == 16);
+		REQUIRE(histogram.min() == 0);
+		REQUIRE(histogram.max() == 15);
+		REQUIRE(histogram.mean() == Approx(7.5));
+		REQUIRE(histogram.percentile(50) == 7);
+		REQUIRE(histogram.percentile(100) == 15);
+	}
+
+	SECTION("Large values stay within one sub-bucket") {
+		for (uint64_t value = 1; value <= 100000; ++value)
+			histogram.record(value);
+
+		REQUIRE(histogram.percentile(50) >= 50000);
+		REQUIRE(histogram.percentile(50) <= 50000 + 50000 / 16);
+		REQUIRE(histogram.percentile(99) >= 99000);
+		REQUIRE(histogram.percentile(99) <= 99000 + 99000 / 16);
+		REQUIRE(histogram.percentile(100) == 100000);
+
+		histogram.record(UINT64_MAX);
+		REQUIRE(histogram.max() == UINT64_MAX);
+	}
+
+	SECTION("Reset") {
+		histogram.record(42);
+		histogram.reset();
+
+		REQUIRE(histogram.count() == 0);
+		REQUIRE(histogram.min() == 0);
+		REQUIRE(histogram.percentile(99) == 0);
+	}
+}
+
+TEST_CASE("HistogramInstrumentation") {
+	const size_t arr_size{ 10 };
+	int arr[arr_size]{ 0,1,2,3,4,5,6,7,8,9 };
+
+	SECTION("SinglyLinkedList") {
+		SinglyLinkedList<int, DirectTraversal, std::allocator<int>, HistogramInstrumentation> list{ arr, arr_size };
+
+		list.index(7);
+		list.index(3);
+		list.count(4);
+		list.remove(2);
+
+		const auto& index = list.histograms()[ListOperation::Index];
+		REQUIRE(index.nodes_visited.count() == 2);
+		REQUIRE(index.nodes_visited.min() == 3);
+		REQUIRE(index.nodes_visited.max() == 7);
+		REQUIRE(index.latency_ns.count() == 2);
+
+		REQUIRE(list.histograms()[ListOperation::Count].nodes_visited.max() == 10);
+		REQUIRE(list.histograms()[ListOperation::Remove].nodes_visited.max() == 2);
+		REQUIRE(list.histograms()[ListOperation::Pop].nodes_visited.count() == 0);
+
+		list.reset_histograms();
+		REQUIRE(list.histograms()[ListOperation::Index].nodes_visited.count() == 0);
+	}
+
+	SECTION("DoublyLinkedList") {
+		DoublyLinkedList<int, DirectTraversal, std::allocator<int>, HistogramInstrumentation> list{ arr, arr_size };
+
+		list.insert(5, 42);
+		list.pop();
+		list.pop(0);
+		list.remove_all(42);
+
+		REQUIRE(list.histograms()[ListOperation::Insert].nodes_visited.max() == 5);
+		REQUIRE(list.histograms()[ListOperation::Pop].nodes_visited.count() == 2);
+		REQUIRE(list.histograms()[ListOperation::Pop].nodes_visited.min() == 0);
+		REQUIRE(list.histograms()[ListOperation::Pop].nodes_visited.max() == 10);
+		REQUIRE(list.histograms()[ListOperation::RemoveAll].nodes_visited.max() == 9);
+		REQUIRE(list.size() == 8);
+	}
+}
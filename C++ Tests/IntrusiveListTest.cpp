@@ -0,0 +1,145 @@
+#include "catch.hpp"
+#include "IntrusiveList.h"
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	struct ByAge {};
+	struct BySize {};
+
+	struct Item : SinglyListHook<>, DoublyListHook<ByAge>, DoublyListHook<BySize> {
+		int value;
+		Item(int val) : value(val) {};
+	};
+}
+
+TEST_CASE("IntrusiveSinglyLinkedList") {
+	std::vector<Item> items{ 1, 2, 3, 4 };
+	IntrusiveSinglyLinkedList<Item> list;
+
+	for (auto& item : items)
+		list.append(item);
+
+	SECTION("Links existing objects") {
+		REQUIRE(list.size() == 4);
+		REQUIRE(&list.front() == &items[0]);
+		REQUIRE(&list.back() == &items[3]);
+
+		int expected{ 1 };
+		for (auto it = list.begin(); it != list.end(); ++it)
+			REQUIRE((*it).value == expected++);
+	}
+
+	SECTION("Prepend, pop and remove") {
+		Item zero{ 0 };
+		list.prepend(zero);
+		REQUIRE(&list.pop_front() == &zero);
+
+		REQUIRE(list.remove(items[3]));
+		REQUIRE(&list.back() == &items[2]);
+		REQUIRE_FALSE(list.remove(items[3]));
+		REQUIRE(list.size() == 3);
+
+		list.clear();
+		REQUIRE(list.size() == 0);
+		REQUIRE_THROWS_AS(list.pop_front(), std::out_of_range);
+	}
+
+	SECTION("Refuses objects that are already linked") {
+		IntrusiveSinglyLinkedList<Item> other;
+
+		REQUIRE_THROWS_AS(list.append(items[3]), std::invalid_argument);
+		REQUIRE_THROWS_AS(list.prepend(items[0]), std::invalid_argument);
+		REQUIRE_THROWS_AS(other.append(items[1]), std::invalid_argument);
+		REQUIRE(list.size() == 4);
+		REQUIRE(other.size() == 0);
+
+		auto& hook = static_cast<SinglyListHook<>&>(items[3]);
+		REQUIRE(hook.is_linked());
+		REQUIRE(list.remove(items[3]));
+		REQUIRE_FALSE(hook.is_linked());
+
+		other.append(items[3]);
+		REQUIRE(&list.back() == &items[2]);
+		REQUIRE(list.size() == 3);
+		REQUIRE(&other.front() == &items[3]);
+
+		list.clear();
+		other.clear();
+		REQUIRE_FALSE(static_cast<SinglyListHook<>&>(items[0]).is_linked());
+	}
+
+	SECTION("Objects outlive their list") {
+		list.clear();
+		{
+			IntrusiveSinglyLinkedList<Item> scoped;
+			for (auto& item : items)
+				scoped.append(item);
+		}
+
+		for (auto& item : items)
+			REQUIRE_FALSE(static_cast<SinglyListHook<>&>(item).is_linked());
+
+		list.append(items[2]);
+		list.append(items[0]);
+		REQUIRE(list.size() == 2);
+		REQUIRE(&list.back() == &items[0]);
+	}
+}
+
+TEST_CASE("IntrusiveDoublyLinkedList") {
+	std::vector<Item> items{ 1, 2, 3, 4 };
+	IntrusiveDoublyLinkedList<Item, ByAge> by_age;
+	IntrusiveDoublyLinkedList<Item, BySize> by_size;
+
+	for (auto& item : items) {
+		by_age.append(item);
+		by_size.prepend(item);
+	}
+
+	SECTION("Object in several lists") {
+		REQUIRE(by_age.size() == 4);
+		REQUIRE(by_size.size() == 4);
+		REQUIRE(&by_age.front() == &items[0]);
+		REQUIRE(&by_size.front() == &items[3]);
+
+		int expected{ 4 };
+		for (auto it = by_age.rbegin(); it != by_age.rend(); ++it)
+			REQUIRE((*it).value == expected--);
+	}
+
+	SECTION("O(1) unlink from the object alone") {
+		IntrusiveDoublyLinkedList<Item, ByAge>::remove(items[1]);
+		static_cast<DoublyListHook<BySize>&>(items[2]).unlink();
+
+		REQUIRE(by_age.size() == 3);
+		REQUIRE(by_size.size() == 3);
+		REQUIRE_FALSE(static_cast<DoublyListHook<ByAge>&>(items[1]).is_linked());
+		REQUIRE(static_cast<DoublyListHook<BySize>&>(items[1]).is_linked());
+
+		by_age.insert_before(items[2], items[1]);
+		REQUIRE(by_age.size() == 4);
+		REQUIRE_THROWS_AS(by_age.append(items[1]), std::invalid_argument);
+	}
+
+	SECTION("Destroyed objects unlink themselves") {
+		{
+			Item temporary{ 5 };
+			by_age.append(temporary);
+			REQUIRE(by_age.size() == 5);
+		}
+
+		REQUIRE(by_age.size() == 4);
+		REQUIRE(&by_age.back() == &items[3]);
+	}
+
+	SECTION("Pop both ends") {
+		REQUIRE(&by_age.pop_front() == &items[0]);
+		REQUIRE(&by_age.pop_back() == &items[3]);
+		REQUIRE(by_age.size() == 2);
+
+		by_age.clear();
+		REQUIRE(by_age.empty());
+		REQUIRE(by_size.size() == 4);
+	}
+}
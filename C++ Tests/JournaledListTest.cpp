@@ -0,0 +1,246 @@
+#include "catch.hpp"
+#include "DoublyLinkedList.h"
+#include "JournaledList.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+namespace {
+	// A log in the temporary directory, removed with its snapshot when the
+	// test is done with it.
+	struct TemporaryLog {
+		std::string path;
+
+		explicit TemporaryLog(const std::string& name) :
+			path((std::filesystem::temp_directory_path() / name).string()) {
+			remove();
+		}
+
+		~TemporaryLog() { remove(); }
+
+		void remove() const {
+			std::filesystem::remove(path);
+			std::filesystem::remove(path + ".snapshot");
+			std::filesystem::remove(path + ".snapshot.tmp");
+		}
+	};
+
+	template <typename T, typename List>
+	std::vector<T> contents(const JournaledList<T, List>& list) {
+		return std::vector<T>(list.begin(), list.end());
+	}
+}
+
+TEST_CASE("JournaledList") {
+	TemporaryLog log("dsa_journaled_list_test.wal");
+
+	SECTION("Replays every kind of change after reopening") {
+		{
+			JournaledList<int> list(log.path);
+			for (int val = 0; val < 6; ++val)
+				list.append(val);
+
+			list.insert(0, -1);
+			list.insert(3, 100);
+			REQUIRE(list.pop() == 5);
+			REQUIRE(list.pop(0) == -1);
+			list.append(2);
+			list.remove(2);
+			list.append(4);
+			list.remove_all(4);
+			REQUIRE(contents(list) == std::vector<int>{ 0, 1, 100, 3, 2 });
+		}
+
+		JournaledList<int> reopened(log.path);
+		REQUIRE(contents(reopened) == std::vector<int>{ 0, 1, 100, 3, 2 });
+		REQUIRE(reopened.journal().last_lsn() == 14);
+
+		reopened.clear();
+		reopened.append(7);
+		reopened.commit();
+
+		JournaledList<int> again(log.path);
+		REQUIRE(contents(again) == std::vector<int>{ 7 });
+	}
+
+	SECTION("Commits records in groups") {
+		JournalOptions options;
+		options.group_commit = 4;
+		JournaledList<int> list(log.path, options);
+		size_t syncs = list.journal().syncs();
+
+		for (int val = 0; val < 10; ++val)
+			list.append(val);
+		REQUIRE(list.journal().syncs() - syncs == 2);
+		REQUIRE(list.journal().buffered() == 2);
+
+		list.commit();
+		REQUIRE(list.journal().syncs() - syncs == 3);
+		REQUIRE(list.journal().buffered() == 0);
+
+		options.group_commit = 1;
+		TemporaryLog every("dsa_journaled_list_every.wal");
+		JournaledList<int> durable(every.path, options);
+		syncs = durable.journal().syncs();
+		for (int val = 0; val < 5; ++val)
+			durable.append(val);
+		REQUIRE(durable.journal().syncs() - syncs == 5);
+		REQUIRE(durable.journal().buffered() == 0);
+	}
+
+	SECTION("Drops a torn record at the end of the log") {
+		{
+			JournaledList<int> list(log.path);
+			for (int val = 0; val < 3; ++val)
+				list.append(val);
+		}
+		auto intact = std::filesystem::file_size(log.path);
+
+		{
+			std::ofstream torn(log.path, std::ios::binary | std::ios::app);
+			torn.write("\x0d\x00\x00\x00\x12\x34", 6);
+		}
+
+		{
+			JournaledList<int> list(log.path);
+			REQUIRE(contents(list) == std::vector<int>{ 0, 1, 2 });
+			REQUIRE(std::filesystem::file_size(log.path) == intact);
+			REQUIRE(list.journal().bytes() == intact);
+			list.append(3);
+		}
+
+		JournaledList<int> reopened(log.path);
+		REQUIRE(contents(reopened) == std::vector<int>{ 0, 1, 2, 3 });
+	}
+
+	SECTION("Snapshots and empties the log once it grows") {
+		JournalOptions options;
+		options.snapshot_bytes = 1024;
+		{
+			JournaledList<int> list(log.path, options);
+			for (int val = 0; val < 1000; ++val)
+				list.append(val);
+			for (int val = 0; val < 500; ++val)
+				list.pop(0);
+
+			REQUIRE(std::filesystem::exists(log.path + ".snapshot"));
+			REQUIRE(list.journal().bytes() < 1024);
+			REQUIRE(std::filesystem::file_size(log.path) < 1024);
+		}
+
+		JournaledList<int> reopened(log.path, options);
+		REQUIRE(reopened.size() == 500);
+		REQUIRE(reopened.index(0) == 500);
+		REQUIRE(reopened.index(499) == 999);
+		REQUIRE(reopened.journal().last_lsn() == 1500);
+	}
+
+	SECTION("Skips records a snapshot already holds") {
+		auto stale = log.path + ".stale";
+		{
+			JournaledList<int> list(log.path);
+			for (int val = 0; val < 5; ++val)
+				list.append(val);
+			list.commit();
+
+			// the log as a crash between replacing the snapshot and
+			// truncating the log would leave it
+			std::filesystem::copy_file(log.path, stale, std::filesystem::copy_options::overwrite_existing);
+			list.snapshot();
+		}
+		std::filesystem::copy_file(stale, log.path, std::filesystem::copy_options::overwrite_existing);
+		std::filesystem::remove(stale);
+
+		{
+			JournaledList<int> list(log.path);
+			REQUIRE(contents(list) == std::vector<int>{ 0, 1, 2, 3, 4 });
+			list.append(5);
+		}
+
+		JournaledList<int> reopened(log.path);
+		REQUIRE(contents(reopened) == std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+	}
+
+	SECTION("Refuses a pop it could not replay") {
+		JournaledList<int> list(log.path);
+		REQUIRE_THROWS_AS(list.pop(), std::out_of_range);
+
+		list.append(1);
+		REQUIRE_THROWS_AS(list.pop(1), std::out_of_range);
+		REQUIRE(list.journal().last_lsn() == 1);
+	}
+
+	SECTION("Journals strings in a DoublyLinkedList") {
+		JournalOptions options;
+		options.snapshot_bytes = 256;
+		{
+			JournaledList<std::string, DoublyLinkedList<std::string>> list(log.path, options);
+			for (int val = 0; val < 20; ++val)
+				list.append(std::string(val, 'a'));
+			list.remove(std::string(3, 'a'));
+			list.insert(1, "inserted");
+		}
+
+		JournaledList<std::string, DoublyLinkedList<std::string>> reopened(log.path, options);
+		REQUIRE(reopened.size() == 20);
+		REQUIRE(reopened.index(1) == "inserted");
+		REQUIRE(reopened.index(4) == "aaaa");
+		REQUIRE(reopened.index(19) == std::string(19, 'a'));
+	}
+
+#if !defined(_WIN32)
+	SECTION("A change whose group commit fails is not made") {
+		JournalOptions options;
+		options.group_commit = 4;
+		{
+			JournaledList<int> list(log.path, options);
+			for (int val = 0; val < 8; ++val)
+				list.append(val);
+			REQUIRE(list.journal().buffered() == 0);
+
+			// the log cannot grow past what is already committed
+			struct rlimit limit;
+			::getrlimit(RLIMIT_FSIZE, &limit);
+			struct rlimit capped = limit;
+			capped.rlim_cur = std::filesystem::file_size(log.path);
+			auto previous = std::signal(SIGXFSZ, SIG_IGN);
+			::setrlimit(RLIMIT_FSIZE, &capped);
+
+			for (int val = 8; val < 11; ++val)
+				list.append(val);
+			REQUIRE_THROWS_AS(list.append(11), std::system_error);
+
+			::setrlimit(RLIMIT_FSIZE, &limit);
+			std::signal(SIGXFSZ, previous);
+
+			REQUIRE(list.size() == 11);
+			REQUIRE(list.journal().buffered() == 3);
+			REQUIRE(list.journal().last_lsn() == 11);
+			REQUIRE(list.journal().bytes() > std::filesystem::file_size(log.path));
+			list.commit();
+			REQUIRE(list.journal().bytes() == std::filesystem::file_size(log.path));
+		}
+
+		JournaledList<int> reopened(log.path, options);
+		REQUIRE(reopened.size() == 11);
+		REQUIRE(reopened.index(10) == 10);
+		REQUIRE(reopened.journal().last_lsn() == 11);
+	}
+#endif
+
+	SECTION("Refuses a file that is not a log") {
+		{
+			std::ofstream garbage(log.path, std::ios::binary | std::ios::trunc);
+			garbage << std::string(200, 'x');
+		}
+		REQUIRE_THROWS_AS(JournaledList<int>(log.path), std::runtime_error);
+	}
+}
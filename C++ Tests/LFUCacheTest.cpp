@@ -0,0 +1,138 @@
+#include "catch.hpp"
+#include "LFUCache.h"
+#include <string>
+
+TEST_CASE("LFUCache") {
+	LFUCache<int, std::string> cache{ 3 };
+
+	SECTION("Get and put") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+
+		REQUIRE(cache.get(1) == "one");
+		REQUIRE(cache.get(2) == "two");
+		REQUIRE_FALSE(cache.get(3));
+		REQUIRE(cache.size() == 2);
+
+		cache.put(1, "uno");
+		REQUIRE(cache.get(1) == "uno");
+		REQUIRE(cache.size() == 2);
+	}
+
+	SECTION("Counts accesses") {
+		cache.put(1, "one");
+		REQUIRE(cache.frequency(1) == 1);
+
+		cache.get(1);
+		cache.get(1);
+		cache.put(1, "uno");
+		REQUIRE(cache.frequency(1) == 4);
+		REQUIRE(cache.frequency(2) == 0);
+	}
+
+	SECTION("Evicts the least frequently used entry") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+		cache.put(3, "three");
+		cache.get(1);
+		cache.get(1);
+		cache.get(3);
+		cache.put(4, "four");
+
+		REQUIRE_FALSE(cache.contains(2));
+		REQUIRE(cache.contains(1));
+		REQUIRE(cache.contains(3));
+		REQUIRE(cache.contains(4));
+
+		// 4 is alone at the lowest count
+		cache.put(5, "five");
+		REQUIRE_FALSE(cache.contains(4));
+		REQUIRE(cache.size() == 3);
+	}
+
+	SECTION("Breaks ties by recency") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+		cache.put(3, "three");
+		cache.get(2);
+		cache.get(1);
+		cache.get(3);
+
+		// all at count 2, 2 the least recent
+		cache.put(4, "four");
+		REQUIRE_FALSE(cache.contains(2));
+
+		// 4 is alone at count 1
+		cache.put(5, "five");
+		REQUIRE_FALSE(cache.contains(4));
+
+		cache.get(5);
+		cache.put(6, "six");
+		REQUIRE_FALSE(cache.contains(1));
+		REQUIRE(cache.contains(3));
+		REQUIRE(cache.contains(5));
+		REQUIRE(cache.contains(6));
+	}
+
+	SECTION("Erase and clear") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+		cache.get(2);
+
+		REQUIRE(cache.erase(1));
+		REQUIRE_FALSE(cache.erase(1));
+		REQUIRE(cache.erase(2));
+		REQUIRE(cache.size() == 0);
+
+		cache.put(3, "three");
+		cache.put(4, "four");
+		cache.clear();
+		REQUIRE(cache.size() == 0);
+		REQUIRE_FALSE(cache.contains(3));
+
+		cache.put(5, "five");
+		REQUIRE(cache.get(5) == "five");
+	}
+
+	SECTION("Stats") {
+		cache.put(1, "one");
+		cache.get(1);
+		cache.get(2);
+		for (int key = 2; key < 6; ++key)
+			cache.put(key, "many");
+
+		REQUIRE(cache.stats().hits == 1);
+		REQUIRE(cache.stats().misses == 1);
+		REQUIRE(cache.stats().insertions == 5);
+		REQUIRE(cache.stats().evictions == 2);
+	}
+
+	SECTION("Recycles pool slots") {
+		NodePool* pool = NodePool::create();
+		{
+			LFUCache<int, int> pooled{ 64, PoolAllocator<std::pair<int, int>>{ pool } };
+			for (int key = 0; key < 64; ++key) {
+				pooled.put(key, key);
+				for (int hit = 0; hit < key % 4; ++hit)
+					pooled.get(key);
+			}
+
+			size_t blocks = pool->blocks();
+
+			for (int key = 64; key < 10000; ++key) {
+				pooled.put(key, key);
+				pooled.get(key - key % 3);
+			}
+
+			REQUIRE(pool->blocks() == blocks);
+			REQUIRE(pooled.size() == 64);
+		}
+
+		REQUIRE(pool->live_slots() == 0);
+		pool->unreference();
+	}
+
+	SECTION("Capacity must be positive") {
+		REQUIRE_THROWS_AS((LFUCache<int, int>{ 0 }), std::invalid_argument);
+	}
+}
@@ -0,0 +1,190 @@
+#include "catch.hpp"
+#include "LRUCache.h"
+#include "DoublyLinkedList.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+TEST_CASE("DoublyLinkedList handles") {
+	const size_t arr_size{ 5 };
+	int arr[arr_size]{ 0,1,2,3,4 };
+	DoublyLinkedList<int> list{ arr, arr_size };
+
+	auto contents = [&] {
+		std::vector<int> values;
+		for (auto it = list.begin(); it != list.end(); ++it)
+			values.push_back(*it);
+		return values;
+	};
+
+	SECTION("Erase") {
+		list.erase(list.front());
+		list.erase(list.back());
+		auto middle{ list.front()->next_node() };
+		REQUIRE(middle->data() == 2);
+
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 3 });
+		REQUIRE(list.size() == 3);
+
+		list.erase(list.front());
+		list.erase(list.front());
+		list.erase(list.front());
+		REQUIRE(list.size() == 0);
+		REQUIRE_FALSE(list.front());
+		REQUIRE_FALSE(list.back());
+
+		list.append(9);
+		REQUIRE(list.front() == list.back());
+		REQUIRE(list.index(0) == 9);
+	}
+
+	SECTION("Move to back") {
+		auto first{ list.front() };
+		auto node{ first.get() };
+
+		list.move_to_back(first);
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 3, 4, 0 });
+		REQUIRE(list.back().get() == node);
+
+		list.move_to_back(list.back());
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 3, 4, 0 });
+
+		auto it = list.rbegin();
+		for (int val : { 0, 4, 3, 2, 1 }) {
+			REQUIRE(*it == val);
+			++it;
+		}
+		REQUIRE(list.size() == 5);
+	}
+
+	SECTION("Insert after") {
+		auto inserted{ list.insert_after(list.front(), 7) };
+		REQUIRE(inserted->data() == 7);
+		REQUIRE(contents() == std::vector<int>{ 0, 7, 1, 2, 3, 4 });
+
+		auto last{ list.insert_after(list.back(), 8) };
+		REQUIRE(list.back() == last);
+		REQUIRE(*list.rbegin() == 8);
+		REQUIRE(list.size() == 7);
+	}
+
+	SECTION("Splice back") {
+		DoublyLinkedList<int> other;
+		other.append(5);
+
+		auto moved{ list.front() };
+		other.splice_back(list, moved);
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 3, 4 });
+		REQUIRE(other.back() == moved);
+		REQUIRE(other.size() == 2);
+		REQUIRE(list.size() == 4);
+
+		list.splice_back(other, other.front());
+		list.splice_back(other, other.front());
+		REQUIRE(contents() == std::vector<int>{ 1, 2, 3, 4, 5, 0 });
+		REQUIRE(other.size() == 0);
+		REQUIRE_FALSE(other.front());
+		REQUIRE_FALSE(other.back());
+
+		list.splice_back(list, list.front());
+		REQUIRE(contents() == std::vector<int>{ 2, 3, 4, 5, 0, 1 });
+	}
+}
+
+TEST_CASE("LRUCache") {
+	LRUCache<int, std::string> cache{ 3 };
+
+	SECTION("Get and put") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+
+		REQUIRE(cache.get(1) == "one");
+		REQUIRE(cache.get(2) == "two");
+		REQUIRE_FALSE(cache.get(3));
+		REQUIRE(cache.size() == 2);
+
+		cache.put(1, "uno");
+		REQUIRE(cache.get(1) == "uno");
+		REQUIRE(cache.size() == 2);
+	}
+
+	SECTION("Evicts the least recently used entry") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+		cache.put(3, "three");
+		cache.get(1);
+		cache.put(4, "four");
+
+		REQUIRE_FALSE(cache.contains(2));
+		REQUIRE(cache.contains(1));
+		REQUIRE(cache.contains(3));
+		REQUIRE(cache.contains(4));
+		REQUIRE(cache.size() == 3);
+		REQUIRE(cache.least_recent().first == 3);
+
+		cache.put(3, "tres");
+		cache.put(5, "five");
+		REQUIRE_FALSE(cache.contains(1));
+		REQUIRE(cache.get(3) == "tres");
+	}
+
+	SECTION("Erase and clear") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+
+		REQUIRE(cache.erase(1));
+		REQUIRE_FALSE(cache.erase(1));
+		REQUIRE(cache.size() == 1);
+		REQUIRE(cache.least_recent().first == 2);
+
+		cache.clear();
+		REQUIRE(cache.size() == 0);
+		cache.put(3, "three");
+		REQUIRE(cache.get(3) == "three");
+	}
+
+	SECTION("Stats") {
+		cache.put(1, "one");
+		cache.get(1);
+		cache.get(2);
+		cache.get(1);
+		for (int key = 2; key < 6; ++key)
+			cache.put(key, "many");
+
+		REQUIRE(cache.stats().hits == 2);
+		REQUIRE(cache.stats().misses == 1);
+		REQUIRE(cache.stats().insertions == 5);
+		REQUIRE(cache.stats().evictions == 2);
+		REQUIRE(cache.stats().hit_rate() == Approx(2.0 / 3.0));
+
+		cache.reset_stats();
+		REQUIRE(cache.stats().hits == 0);
+	}
+
+	SECTION("Recycles pool slots") {
+		NodePool* pool = NodePool::create();
+		{
+			LRUCache<int, int> pooled{ 64, PoolAllocator<std::pair<int, int>>{ pool } };
+			for (int key = 0; key < 64; ++key)
+				pooled.put(key, key);
+
+			size_t blocks = pool->blocks();
+			size_t live = pool->live_slots();
+
+			for (int key = 64; key < 10000; ++key)
+				pooled.put(key, key);
+
+			REQUIRE(pool->blocks() == blocks);
+			REQUIRE(pool->live_slots() == live);
+			REQUIRE(pooled.get(9999) == 9999);
+			REQUIRE_FALSE(pooled.get(0));
+		}
+
+		REQUIRE(pool->live_slots() == 0);
+		pool->unreference();
+	}
+
+	SECTION("Capacity must be positive") {
+		REQUIRE_THROWS_AS((LRUCache<int, int>{ 0 }), std::invalid_argument);
+	}
+}
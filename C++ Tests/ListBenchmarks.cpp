@@ -0,0 +1,103 @@
+#include "catch.hpp"
+#include "SinglyLinkedList.h"
+#include "DoublyLinkedList.h"
+#include "IndexedList.h"
+#include <string>
+
+// Sampled timings for every list operation. The test cases are hidden and
+// tagged [benchmark], so a plain test run skips them; run them with
+//
+//     "C++ Tests.exe" [benchmark]
+//     "C++ Tests.exe" [benchmark][SinglyLinkedList] --benchmark-samples 50
+//
+// Operations that change the list are timed as a pair that puts it back the
+// way it was, e.g. insert and pop at the same position. Catch repeats each
+// benchmark until the warm-up time is used up, which can mean millions of
+// runs, so a list that grew or shrank on every run would not stay the size
+// the benchmark is named after.
+
+namespace {
+
+	const int list_size{ 1000 };
+
+	template <typename List>
+	void fill(List& list, int size) {
+		for (int idx = 0; idx < size; ++idx)
+			list.append(idx);
+	}
+
+	template <typename List>
+	void benchmark_operations(const std::string& name) {
+		List list;
+		fill(list, list_size);
+
+		const std::string suffix = " (" + name + ", " + std::to_string(list_size) + ")";
+
+		BENCHMARK("append + pop head" + suffix) {
+			list.append(list_size);
+			return list.pop(0);
+		};
+
+		BENCHMARK("insert + pop middle" + suffix) {
+			list.insert(list_size / 2, -1);
+			return list.pop(list_size / 2);
+		};
+
+		BENCHMARK("pop tail + append" + suffix) {
+			int data = list.pop();
+			list.append(data);
+		};
+
+		BENCHMARK("remove + insert middle" + suffix) {
+			int data = list.index(list_size / 2);
+			list.remove(data);
+			list.insert(list_size / 2, data);
+		};
+
+		BENCHMARK_ADVANCED("remove_all + refill" + suffix)(Catch::Benchmark::Chronometer meter) {
+			List repeated;
+			for (int idx = 0; idx < list_size; ++idx)
+				repeated.append(idx % 10);
+
+			meter.measure([&] {
+				repeated.remove_all(5);
+				for (int idx = 0; idx < list_size / 10; ++idx)
+					repeated.append(5);
+			});
+		};
+
+		BENCHMARK("fill + clear" + suffix) {
+			List filled;
+			fill(filled, list_size);
+			filled.clear();
+		};
+
+		BENCHMARK("index middle" + suffix) {
+			return list.index(list_size / 2);
+		};
+
+		BENCHMARK("count" + suffix) {
+			return list.count(list_size - 1);
+		};
+
+		BENCHMARK("iterate" + suffix) {
+			size_t visited{ 0 };
+			for (auto it = list.begin(); it != list.end(); ++it)
+				++visited;
+
+			return visited;
+		};
+	}
+}
+
+TEST_CASE("SinglyLinkedList benchmarks", "[.][benchmark][SinglyLinkedList]") {
+	benchmark_operations<SinglyLinkedList<int>>("SinglyLinkedList");
+}
+
+TEST_CASE("DoublyLinkedList benchmarks", "[.][benchmark][DoublyLinkedList]") {
+	benchmark_operations<DoublyLinkedList<int>>("DoublyLinkedList");
+}
+
+TEST_CASE("IndexedList benchmarks", "[.][benchmark][IndexedList]") {
+	benchmark_operations<IndexedList<int>>("IndexedList");
+}
@@ -0,0 +1,183 @@
+#include "catch.hpp"
+#include "ListChunkStream.h"
+#include "SinglyLinkedList.h"
+#include "DoublyLinkedList.h"
+#include "SmallList.h"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	// Run-length encoding of bytes as (count, byte) pairs; enough to show the
+	// hooks are called on both sides.
+	struct RunLengthCodec {
+		static constexpr uint32_t id{ 1 };
+
+		static void compress(const std::byte* input, size_t bytes, std::vector<std::byte>& output) {
+			output.clear();
+			for (size_t idx = 0; idx < bytes;) {
+				size_t run{ 1 };
+				while (idx + run < bytes && run < 255 && input[idx + run] == input[idx])
+					++run;
+				output.push_back(static_cast<std::byte>(run));
+				output.push_back(input[idx]);
+				idx += run;
+			}
+		}
+
+		static void decompress(const std::byte* input, size_t bytes, size_t raw_bytes, std::vector<std::byte>& output) {
+			output.clear();
+			output.reserve(raw_bytes);
+			for (size_t idx = 0; idx + 1 < bytes; idx += 2)
+				output.insert(output.end(), static_cast<size_t>(input[idx]), input[idx + 1]);
+		}
+	};
+
+	std::string chunked(size_t elements, ChunkWriterOptions options) {
+		std::ostringstream out;
+		ListChunkWriter<int> writer(out, options);
+		for (size_t idx = 0; idx < elements; ++idx)
+			writer.write(static_cast<int>(idx));
+		writer.finish();
+
+		return out.str();
+	}
+}
+
+TEST_CASE("ListChunkStream") {
+	SECTION("Round trip through a SinglyLinkedList") {
+		SinglyLinkedList<int> list;
+		for (int val = 0; val < 10000; ++val)
+			list.append(val * 3);
+
+		std::stringstream stream;
+		ListChunkWriter<int> writer(stream, { 1000, true });
+		writer.write_list(list);
+		writer.finish();
+		REQUIRE(writer.written() == 10000);
+
+		for (size_t read_ahead : { 0, 1, 3 }) {
+			std::istringstream in(stream.str());
+			ListChunkReader<int> reader(in, read_ahead);
+			REQUIRE(reader.chunk_elements() == 1000);
+
+			SinglyLinkedList<int> loaded;
+			reader.read_into(loaded);
+			REQUIRE(reader.elements_read() == 10000);
+			REQUIRE(loaded.size() == 10000);
+
+			int expected{ 0 };
+			for (auto node = loaded.front(); node; node = node->next())
+				REQUIRE(node->data() == 3 * expected++);
+			REQUIRE(reader.next_chunk() == nullptr);
+		}
+	}
+
+	SECTION("Chunks are read one at a time") {
+		std::istringstream in(chunked(2500, { 1000, true }));
+		ListChunkReader<int> reader(in);
+
+		std::vector<size_t> sizes;
+		while (auto chunk = reader.next_chunk())
+			sizes.push_back(chunk->size());
+		REQUIRE(sizes == std::vector<size_t>{ 1000, 1000, 500 });
+
+		std::istringstream again(chunked(2500, { 1000, false }));
+		long long sum{ 0 };
+		ListChunkReader<int>(again, 0).for_each([&](int value) { sum += value; });
+		REQUIRE(sum == 2499LL * 2500 / 2);
+	}
+
+	SECTION("Strings in a DoublyLinkedList") {
+		DoublyLinkedList<std::string> list;
+		for (int val = 0; val < 50; ++val)
+			list.append(std::string(static_cast<size_t>(val), 'a' + val % 26));
+
+		std::stringstream stream;
+		{
+			ListChunkWriter<std::string> writer(stream, { 7, false });
+			writer.write_list(list);
+		}
+
+		DoublyLinkedList<std::string> loaded;
+		ListChunkReader<std::string> reader(stream);
+		reader.read_into(loaded);
+		REQUIRE(loaded.size() == 50);
+		REQUIRE(loaded.index(0).empty());
+		REQUIRE(loaded.index(49) == std::string(49, 'a' + 49 % 26));
+	}
+
+	SECTION("Lists that do not share their nodes") {
+		BasicList<int, ListFeatures<false, false, false, ExclusiveOwnership>> exclusive;
+		SmallList<int> small;
+		for (int val = 0; val < 100; ++val) {
+			exclusive.append(val);
+			small.append(val);
+		}
+
+		std::stringstream exclusive_stream, small_stream;
+		{
+			ListChunkWriter<int> exclusive_writer(exclusive_stream, { 16, false });
+			exclusive_writer.write_list(exclusive);
+			ListChunkWriter<int> small_writer(small_stream, { 16, false });
+			small_writer.write_list(small);
+		}
+		REQUIRE(exclusive_stream.str() == small_stream.str());
+
+		SinglyLinkedList<int> loaded;
+		ListChunkReader<int> reader(exclusive_stream);
+		reader.read_into(loaded);
+		REQUIRE(loaded.size() == 100);
+		REQUIRE(loaded.index(99) == 99);
+	}
+
+	SECTION("Compression hooks") {
+		std::stringstream stream;
+		{
+			ListChunkWriter<int, RunLengthCodec> writer(stream, { 512, true });
+			for (int val = 0; val < 4096; ++val)
+				writer.write(val < 2048 ? 0 : -1);
+		}
+		REQUIRE(stream.str().size() < 4096 * sizeof(int) / 4);
+
+		std::istringstream in(stream.str());
+		ListChunkReader<int, RunLengthCodec> reader(in);
+		DoublyLinkedList<int> loaded;
+		reader.read_into(loaded);
+		REQUIRE(loaded.size() == 4096);
+		REQUIRE(loaded.count(-1) == 2048);
+
+		std::istringstream other(stream.str());
+		REQUIRE_THROWS_AS(ListChunkReader<int>(other), std::runtime_error);
+	}
+
+	SECTION("Corrupt and truncated streams") {
+		std::string bytes = chunked(3000, { 1000, true });
+
+		for (size_t read_ahead : { 0, 2 }) {
+			std::string corrupt = bytes;
+			corrupt[24 + 16 + 1000 * sizeof(int) + 16 + 100] ^= 0x01;
+			std::istringstream in(corrupt);
+			ListChunkReader<int> reader(in, read_ahead);
+
+			REQUIRE(reader.next_chunk() != nullptr);
+			REQUIRE_THROWS_AS(reader.next_chunk(), std::runtime_error);
+
+			std::istringstream truncated(bytes.substr(0, bytes.size() - 20));
+			SinglyLinkedList<int> list;
+			REQUIRE_THROWS_AS(ListChunkReader<int>(truncated, read_ahead).read_into(list), std::runtime_error);
+		}
+
+		std::istringstream wrong_type(bytes);
+		REQUIRE_THROWS_AS(ListChunkReader<double>(wrong_type), std::runtime_error);
+
+		REQUIRE_THROWS_AS(chunked(1, { 0, true }), std::invalid_argument);
+	}
+
+	SECTION("Readers can stop early") {
+		std::istringstream in(chunked(100000, { 100, true }));
+		ListChunkReader<int> reader(in, 4);
+		REQUIRE(reader.next_chunk()->size() == 100);
+	}
+}
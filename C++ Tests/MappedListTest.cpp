@@ -0,0 +1,231 @@
+#include "catch.hpp"
+#include "MappedList.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+namespace {
+	// A file in the temporary directory, removed when the test is done with it.
+	struct TemporaryFile {
+		std::string path;
+
+		explicit TemporaryFile(const std::string& name) :
+			path((std::filesystem::temp_directory_path() / name).string()) {
+			std::filesystem::remove(path);
+		}
+
+		~TemporaryFile() { std::filesystem::remove(path); }
+	};
+
+	template <typename List>
+	std::vector<int> contents(const List& list) {
+		return std::vector<int>(list.begin(), list.end());
+	}
+}
+
+TEST_CASE("MappedList") {
+	TemporaryFile file("dsa_mapped_list_test.bin");
+
+	SECTION("Survives being closed and opened again") {
+		{
+			MappedList<int> list(file.path);
+			for (int val = 0; val < 10; ++val)
+				list.append(val);
+			REQUIRE(list.size() == 10);
+		}
+
+		MappedList<int> reopened(file.path);
+		REQUIRE(reopened.size() == 10);
+		REQUIRE(contents(reopened) == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+
+		reopened.append(10);
+		REQUIRE(reopened.index(10) == 10);
+	}
+
+	SECTION("Insert, pop and remove") {
+		MappedList<int> list(file.path);
+		for (int val = 0; val < 5; ++val)
+			list.append(val);
+
+		list.insert(0, -1);
+		list.insert(3, 100);
+		list.insert(99, 5);
+		list.insert(-1, 6);
+		REQUIRE(contents(list) == std::vector<int>{ -1, 0, 1, 100, 2, 3, 4, 5, 6 });
+
+		REQUIRE(list.pop() == 6);
+		REQUIRE(list.pop(0) == -1);
+		REQUIRE(list.pop(2) == 100);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+
+		list.append(2);
+		list.remove(2);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4, 5, 2 });
+		REQUIRE(list.count(2) == 1);
+
+		list.append(2);
+		list.remove_all(2);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4, 5 });
+
+		list.remove(5);
+		list.append(7);
+		REQUIRE(list.index(list.size() - 1) == 7);
+
+		REQUIRE_THROWS_AS(list.index(5), std::out_of_range);
+		REQUIRE_THROWS_AS(list.pop(5), std::out_of_range);
+
+		list.clear();
+		REQUIRE(list.size() == 0);
+		REQUIRE(list.begin() == list.end());
+		REQUIRE_THROWS_AS(list.pop(), std::out_of_range);
+
+		list.append(1);
+		REQUIRE(contents(list) == std::vector<int>{ 1 });
+	}
+
+	SECTION("Grows the file and reuses freed nodes") {
+		size_t initial{ 0 };
+		{
+			MappedList<int> list(file.path, 4);
+			initial = list.file_size();
+
+			for (int val = 0; val < 100000; ++val)
+				list.append(val);
+			REQUIRE(list.file_size() > initial);
+
+			size_t grown = list.file_size();
+			for (int val = 0; val < 1000; ++val)
+				list.pop(0);
+			for (int val = 0; val < 1000; ++val)
+				list.append(val);
+			REQUIRE(list.file_size() == grown);
+		}
+
+		MappedList<int> reopened(file.path);
+		REQUIRE(reopened.size() == 100000);
+		REQUIRE(reopened.index(0) == 1000);
+		REQUIRE(reopened.index(99999) == 999);
+
+		long long sum{ 0 };
+		for (int value : reopened)
+			sum += value;
+		REQUIRE(sum == 99999LL * 100000 / 2 - 999LL * 1000 / 2 + 999LL * 1000 / 2);
+	}
+
+	SECTION("Iterators survive the file growing") {
+		MappedList<int> list(file.path, 1);
+		list.append(42);
+		auto it = list.begin();
+
+		for (int val = 0; val < 1000; ++val)
+			list.append(val);
+
+		REQUIRE(*it == 42);
+		REQUIRE(*++it == 0);
+	}
+
+	SECTION("Falls back to the last sync after a crash") {
+		TemporaryFile crash("dsa_mapped_list_crash.bin");
+		// the file as a crash would leave it if every changed page had been
+		// written back
+		auto crash_now = [&] {
+			std::filesystem::copy_file(file.path, crash.path, std::filesystem::copy_options::overwrite_existing);
+		};
+
+		MappedList<int> list(file.path, 4);
+		for (int val = 0; val < 10; ++val)
+			list.append(val);
+		list.sync();
+
+		// relinks, frees and reuses nodes the sync saw, and grows the file
+		list.pop(0);
+		list.remove(5);
+		list.insert(3, 100);
+		for (int val = 10; val < 100; ++val)
+			list.append(val);
+		crash_now();
+		{
+			MappedList<int> recovered(crash.path);
+			REQUIRE(contents(recovered) == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+
+			recovered.pop(0);
+			recovered.append(10);
+			REQUIRE(contents(recovered) == std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 });
+		}
+		{
+			MappedList<int> reopened(crash.path);
+			REQUIRE(contents(reopened) == std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 });
+		}
+
+		list.sync();
+		std::vector<int> expected = contents(list);
+		REQUIRE(expected.size() == 99);
+
+		list.clear();
+		list.append(-1);
+		crash_now();
+		{
+			MappedList<int> recovered(crash.path);
+			REQUIRE(contents(recovered) == expected);
+		}
+
+		list.sync();
+		crash_now();
+		MappedList<int> synced(crash.path);
+		REQUIRE(contents(synced) == std::vector<int>{ -1 });
+	}
+
+#if !defined(_WIN32)
+	SECTION("A failed resize leaves the file mapped") {
+		MappedFile mapped(file.path);
+		mapped.resize(4096);
+		mapped.data()[100] = std::byte{ 42 };
+
+		// a file size limit makes growing the file fail with EFBIG
+		struct rlimit limit;
+		::getrlimit(RLIMIT_FSIZE, &limit);
+		struct rlimit capped = limit;
+		capped.rlim_cur = 8192;
+		auto previous = std::signal(SIGXFSZ, SIG_IGN);
+		::setrlimit(RLIMIT_FSIZE, &capped);
+
+		REQUIRE_THROWS_AS(mapped.resize(1 << 20), std::system_error);
+
+		::setrlimit(RLIMIT_FSIZE, &limit);
+		std::signal(SIGXFSZ, previous);
+
+		REQUIRE(mapped.size() == 4096);
+		REQUIRE(mapped.data()[100] == std::byte{ 42 });
+		mapped.resize(8192);
+		REQUIRE(mapped.data()[100] == std::byte{ 42 });
+	}
+#endif
+
+	SECTION("Refuses files that do not hold a list of T") {
+		{
+			MappedList<int> list(file.path);
+			list.append(1);
+		}
+		REQUIRE_THROWS_AS(MappedList<double>(file.path), std::runtime_error);
+
+		{
+			std::ofstream garbage(file.path, std::ios::binary | std::ios::trunc);
+			garbage << std::string(200, 'x');
+		}
+		REQUIRE_THROWS_AS(MappedList<int>(file.path), std::runtime_error);
+
+		{
+			std::ofstream short_file(file.path, std::ios::binary | std::ios::trunc);
+			short_file << "DSAM";
+		}
+		REQUIRE_THROWS_AS(MappedList<int>(file.path), std::runtime_error);
+	}
+}
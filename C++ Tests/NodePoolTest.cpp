@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include "NodePool.h"
+#include "DoublyLinkedList.h"
+#include <memory>
+#include <vector>
+
+TEST_CASE("NodePool") {
+	NodePool* pool = NodePool::create(1024);
+	PoolAllocator<int> allocator{ pool };
+	pool->unreference();
+
+	SECTION("Freed slots are reused") {
+		void* first = pool->allocate(24, 8);
+		void* second = pool->allocate(24, 8);
+		REQUIRE(first != second);
+		REQUIRE(pool->live_slots() == 2);
+
+		pool->deallocate(first, 24, 8);
+		REQUIRE(pool->allocate(32, 8) == first);
+		REQUIRE(pool->blocks() == 1);
+
+		pool->deallocate(first, 32, 8);
+		pool->deallocate(second, 24, 8);
+		REQUIRE(pool->live_slots() == 0);
+	}
+
+	SECTION("Size classes do not share slots") {
+		void* small = pool->allocate(16, 8);
+		pool->deallocate(small, 16, 8);
+
+		void* large = pool->allocate(48, 8);
+		REQUIRE(large != small);
+		REQUIRE(pool->blocks() == 2);
+		pool->deallocate(large, 48, 8);
+	}
+
+	SECTION("Large requests bypass the pool") {
+		void* address = pool->allocate(NodePool::max_slot_bytes + 1, 8);
+		REQUIRE(pool->live_slots() == 0);
+		REQUIRE(pool->blocks() == 0);
+		pool->deallocate(address, NodePool::max_slot_bytes + 1, 8);
+	}
+
+	SECTION("List nodes come from the pool") {
+		{
+			DoublyLinkedList<int, DirectTraversal, PoolAllocator<int>> list{ allocator };
+			for (int val = 0; val < 100; ++val)
+				list.append(val);
+
+			REQUIRE(pool->live_slots() == 100);
+			size_t blocks = pool->blocks();
+
+			for (int val = 0; val < 50; ++val)
+				list.erase(list.front());
+			for (int val = 0; val < 50; ++val)
+				list.append(val);
+
+			REQUIRE(pool->live_slots() == 100);
+			REQUIRE(pool->blocks() == blocks);
+		}
+
+		REQUIRE(pool->live_slots() == 0);
+	}
+
+	SECTION("Nodes keep the pool alive") {
+		std::shared_ptr<DoublyLinkedList<int, DirectTraversal, PoolAllocator<int>>::Node> held;
+		{
+			DoublyLinkedList<int, DirectTraversal, PoolAllocator<int>> list;
+			list.append(1);
+			list.append(2);
+			held = list.back();
+		}
+
+		REQUIRE(held->data() == 2);
+	}
+}
@@ -0,0 +1,151 @@
+#include "catch.hpp"
+#include "PersistentList.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+template <typename List>
+std::vector<int> contents(const List& list) {
+	return std::vector<int>(list.begin(), list.end());
+}
+
+TEST_CASE("PersistentList") {
+	PersistentList<int> base{ 1, 2, 3 };
+
+	SECTION("Push front, front and tail") {
+		REQUIRE(base.size() == 3);
+		REQUIRE(base.front() == 1);
+		REQUIRE(contents(base) == std::vector<int>{ 1, 2, 3 });
+
+		auto longer = base.push_front(0);
+		REQUIRE(longer.size() == 4);
+		REQUIRE(longer.front() == 0);
+		REQUIRE(contents(longer) == std::vector<int>{ 0, 1, 2, 3 });
+
+		auto shorter = base.tail();
+		REQUIRE(shorter.size() == 2);
+		REQUIRE(contents(shorter) == std::vector<int>{ 2, 3 });
+		REQUIRE(contents(base) == std::vector<int>{ 1, 2, 3 });
+	}
+
+	SECTION("Versions share their tails") {
+		auto first = base.push_front(10);
+		auto second = base.push_front(20);
+
+		REQUIRE(first.tail().same_version(base));
+		REQUIRE(second.tail().same_version(base));
+		REQUIRE_FALSE(first.same_version(second));
+		REQUIRE(&*++first.begin() == &*++second.begin());
+		REQUIRE(&*base.begin() == &*++first.begin());
+	}
+
+	SECTION("Versions outlive the lists they came from") {
+		PersistentList<int> derived;
+		{
+			PersistentList<int> temporary{ 7, 8 };
+			derived = temporary.push_front(6);
+		}
+
+		REQUIRE(contents(derived) == std::vector<int>{ 6, 7, 8 });
+
+		auto snapshot = derived;
+		auto it = snapshot.begin();
+		derived = derived.tail();
+		REQUIRE(*it == 6);
+		REQUIRE(contents(derived) == std::vector<int>{ 7, 8 });
+	}
+
+	SECTION("Empty list") {
+		PersistentList<int> empty;
+		REQUIRE(empty.empty());
+		REQUIRE(empty.begin() == empty.end());
+		REQUIRE_THROWS_AS(empty.front(), std::out_of_range);
+		REQUIRE_THROWS_AS(empty.tail(), std::out_of_range);
+
+		auto single = empty.push_front(5);
+		REQUIRE(single.tail().empty());
+		REQUIRE(empty.empty());
+	}
+
+	SECTION("Moves leave the source empty") {
+		auto moved = std::move(base);
+		REQUIRE(contents(moved) == std::vector<int>{ 1, 2, 3 });
+		REQUIRE(base.empty());
+		REQUIRE(base.begin() == base.end());
+	}
+
+	SECTION("Destroys long chains without recursing") {
+		PersistentList<int> list;
+		for (int value = 0; value < 1000000; ++value)
+			list = list.push_front(value);
+
+		auto shared = list.tail().tail();
+		list = PersistentList<int>{};
+		REQUIRE(shared.size() == 999998);
+		REQUIRE(shared.front() == 999997);
+
+		shared = PersistentList<int>{};
+		REQUIRE(shared.empty());
+	}
+
+	SECTION("Threads dropping versions that share a tail do not recurse") {
+		for (int round = 0; round < 2; ++round) {
+			PersistentList<int> shared;
+			for (int value = 0; value < 1000000; ++value)
+				shared = shared.push_front(value);
+
+			std::vector<PersistentList<int>> versions;
+			for (int thread = 0; thread < 4; ++thread)
+				versions.push_back(shared.push_front(thread));
+			shared = PersistentList<int>{};
+
+			std::atomic<int> ready{ 0 };
+			std::vector<std::thread> threads;
+			for (auto& version : versions) {
+				threads.emplace_back([&] {
+					++ready;
+					while (ready < 4)
+						std::this_thread::yield();
+					version = PersistentList<int>{};
+				});
+			}
+
+			for (auto& thread : threads)
+				thread.join();
+			for (auto& version : versions)
+				REQUIRE(version.empty());
+		}
+	}
+
+	SECTION("Threads derive versions from one snapshot") {
+		PersistentList<int> snapshot;
+		for (int value = 0; value < 1000; ++value)
+			snapshot = snapshot.push_front(value);
+
+		std::atomic<int> wrong{ 0 };
+		std::vector<std::thread> threads;
+		for (int thread = 0; thread < 4; ++thread) {
+			threads.emplace_back([&, thread] {
+				for (int round = 0; round < 200; ++round) {
+					PersistentList<int> version = snapshot;
+					for (int value = 0; value < 10; ++value)
+						version = version.push_front(thread);
+
+					long long sum{ 0 };
+					for (int value : version)
+						sum += value;
+					if (sum != 10LL * thread + 999LL * 1000 / 2)
+						++wrong;
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		REQUIRE(wrong == 0);
+		REQUIRE(snapshot.size() == 1000);
+		REQUIRE(snapshot.front() == 999);
+	}
+}
@@ -0,0 +1,163 @@
+#include "catch.hpp"
+#include "SinglyLinkedList.h"
+#include "DoublyLinkedList.h"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	struct Point {
+		int x;
+		double y;
+	};
+}
+
+TEST_CASE("Serialization") {
+	const size_t arr_size{ 1000 };
+	int arr[arr_size];
+	for (size_t idx = 0; idx < arr_size; ++idx)
+		arr[idx] = static_cast<int>(idx * 7);
+
+	SECTION("SinglyLinkedList round trip") {
+		SinglyLinkedList<int> list{ arr, arr_size };
+		std::stringstream stream;
+		list.save(stream);
+		REQUIRE(stream.str().size() == 20 + arr_size * sizeof(int));
+
+		SinglyLinkedList<int> loaded;
+		loaded.append(-1);
+		loaded.load(stream);
+
+		REQUIRE(loaded.size() == arr_size);
+		size_t idx{ 0 };
+		for (auto node = loaded.front(); node; node = node->next())
+			REQUIRE(node->data() == arr[idx++]);
+		REQUIRE(idx == arr_size);
+
+		// nodes come from one arena, in order
+		auto prev{ loaded.front() };
+		for (auto current = prev->next(); current; current = current->next()) {
+			REQUIRE(current.get() > prev.get());
+			prev = current;
+		}
+		REQUIRE(prev == loaded.back());
+
+		loaded.append(5);
+		loaded.pop(0);
+		REQUIRE(loaded.size() == arr_size);
+		REQUIRE(loaded.back()->data() == 5);
+	}
+
+	SECTION("DoublyLinkedList round trip") {
+		DoublyLinkedList<int> list{ arr, arr_size };
+		std::stringstream stream;
+		list.save(stream);
+
+		DoublyLinkedList<int> loaded;
+		loaded.load(stream);
+
+		REQUIRE(loaded.size() == arr_size);
+		int expected{ static_cast<int>(arr_size) - 1 };
+		for (auto it = loaded.rbegin(); it != loaded.rend(); ++it)
+			REQUIRE(*it == arr[expected--]);
+		REQUIRE(expected == -1);
+
+		loaded.erase(loaded.front()->next());
+		REQUIRE(loaded.index(1) == arr[2]);
+	}
+
+	SECTION("Either list loads what the other saved") {
+		SinglyLinkedList<int> singly{ arr, 10 };
+		std::stringstream stream;
+		singly.save(stream);
+
+		DoublyLinkedList<int> doubly;
+		doubly.load(stream);
+		REQUIRE(doubly.size() == 10);
+		REQUIRE(doubly.index(9) == arr[9]);
+	}
+
+	SECTION("Trivially copyable structs") {
+		DoublyLinkedList<Point> list;
+		list.append({ 1, 0.5 });
+		list.append({ -2, 3.25 });
+		std::stringstream stream;
+		list.save(stream);
+
+		DoublyLinkedList<Point> loaded;
+		loaded.load(stream);
+		REQUIRE(loaded.size() == 2);
+		REQUIRE(loaded.back()->data().x == -2);
+		REQUIRE(loaded.back()->data().y == 3.25);
+	}
+
+	SECTION("Strings") {
+		SinglyLinkedList<std::string> list;
+		list.append("");
+		list.append("persistent");
+		list.append(std::string(1000, 'x'));
+		std::stringstream stream;
+		list.save(stream);
+
+		DoublyLinkedList<std::string> loaded;
+		loaded.load(stream);
+		REQUIRE(loaded.size() == 3);
+		REQUIRE(loaded.index(0).empty());
+		REQUIRE(loaded.index(1) == "persistent");
+		REQUIRE(loaded.index(2) == std::string(1000, 'x'));
+	}
+
+	SECTION("Empty lists") {
+		SinglyLinkedList<int> empty;
+		std::stringstream stream;
+		empty.save(stream);
+
+		SinglyLinkedList<int> loaded{ arr, 3 };
+		loaded.load(stream);
+		REQUIRE(loaded.size() == 0);
+		REQUIRE(loaded.front() == nullptr);
+
+		loaded.append(4);
+		REQUIRE(loaded.front() == loaded.back());
+	}
+
+	SECTION("Bad streams leave the list unchanged") {
+		SinglyLinkedList<int> list{ arr, arr_size };
+		std::stringstream saved;
+		list.save(saved);
+		const std::string bytes = saved.str();
+
+		DoublyLinkedList<int> loaded{ arr, 3 };
+
+		std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+		REQUIRE_THROWS_AS(loaded.load(truncated), std::runtime_error);
+
+		std::stringstream garbage("not a list at all, not even close");
+		REQUIRE_THROWS_AS(loaded.load(garbage), std::runtime_error);
+
+		std::stringstream wrong_type(bytes);
+		DoublyLinkedList<double> doubles;
+		REQUIRE_THROWS_AS(doubles.load(wrong_type), std::runtime_error);
+
+		std::string huge = bytes.substr(0, 20);
+		huge[19] = '\x7f';
+		std::stringstream oversized(huge);
+		REQUIRE_THROWS_AS(loaded.load(oversized), std::runtime_error);
+
+		REQUIRE(loaded.size() == 3);
+		REQUIRE(loaded.index(2) == arr[2]);
+	}
+
+	SECTION("Loaded nodes are counted") {
+		DoublyLinkedList<int, DirectTraversal, CountingAllocator<int>> list{ arr, arr_size };
+		std::stringstream stream;
+		list.save(stream);
+
+		DoublyLinkedList<int, DirectTraversal, CountingAllocator<int>> loaded;
+		loaded.load(stream);
+		REQUIRE(loaded.stats().live_nodes == arr_size);
+
+		loaded.clear();
+		REQUIRE(loaded.stats().live_nodes == 0);
+	}
+}
@@ -59,6 +59,31 @@ TEST_CASE("SinglyLinkedList") {
 
 
 	}
+
+	SECTION("Remove All Adjacent") {
+		list.insert(4, 4);
+		list.append(4);
+		list.remove_all(4);
+
+		REQUIRE(list.size() == 5);
+		REQUIRE(list.count(4) == 0);
+		REQUIRE(list.back()->data() == 7);
+	}
+
+	SECTION("Clear past a held node") {
+		SinglyLinkedList<int> long_list;
+		for (int val = 0; val < 2000000; ++val)
+			long_list.append(val);
+
+		auto held{ long_list.front()->next() };
+		long_list.clear();
+		REQUIRE(held->data() == 1);
+		REQUIRE(held->next()->data() == 2);
+
+		// the rest of the chain now goes with the last handle, one node at a time
+		held.reset();
+		REQUIRE(long_list.empty());
+	}
 	
 
 }
\ No newline at end of file
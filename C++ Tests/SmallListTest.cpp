@@ -0,0 +1,134 @@
+#include "catch.hpp"
+#include "CountingAllocator.h"
+#include "NodePool.h"
+#include "SmallList.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	template <typename T, size_t K, typename Allocator>
+	std::vector<T> contents(const SmallList<T, K, Allocator>& list) {
+		return std::vector<T>(list.begin(), list.end());
+	}
+}
+
+TEST_CASE("SmallList") {
+	SECTION("Matches SinglyLinkedList's operations") {
+		int arr[]{ 0, 1, 2, 3, 4 };
+		SmallList<int, 4> list{ arr, 5 };
+
+		list.insert(0, -1);
+		list.insert(3, 100);
+		list.insert(99, 5);
+		list.insert(-1, 6);
+		REQUIRE(contents(list) == std::vector<int>{ -1, 0, 1, 100, 2, 3, 4, 5, 6 });
+
+		REQUIRE(list.pop() == 6);
+		REQUIRE(list.pop(0) == -1);
+		REQUIRE(list.pop(2) == 100);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+
+		list.append(2);
+		list.remove(2);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4, 5, 2 });
+		REQUIRE(list.count(2) == 1);
+
+		list.append(2);
+		list.remove_all(2);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4, 5 });
+
+		list.remove(5);
+		list.append(7);
+		REQUIRE(list.index(list.size() - 1) == 7);
+
+		REQUIRE_THROWS_AS(list.index(5), std::out_of_range);
+		REQUIRE_THROWS_AS(list.pop(5), std::out_of_range);
+
+		list.clear();
+		REQUIRE(list.empty());
+		REQUIRE(list.begin() == list.end());
+		REQUIRE_THROWS_AS(list.pop(), std::out_of_range);
+	}
+
+	SECTION("Allocates only past K elements") {
+		CountingAllocator<int> counting;
+		SmallList<int, 4, CountingAllocator<int>> list{ counting };
+
+		for (int val = 0; val < 4; ++val)
+			list.append(val);
+		REQUIRE(counting.stats().allocations == 0);
+		REQUIRE(list.spilled() == 0);
+
+		list.append(4);
+		list.append(5);
+		REQUIRE(counting.stats().allocations == 2);
+		REQUIRE(list.spilled() == 2);
+
+		// freed inline slots are taken before the allocator is asked again
+		list.pop(0);
+		list.pop(0);
+		list.append(6);
+		list.append(7);
+		REQUIRE(counting.stats().allocations == 2);
+		REQUIRE(contents(list) == std::vector<int>{ 2, 3, 4, 5, 6, 7 });
+
+		list.clear();
+		REQUIRE(counting.stats().frees == 2);
+		REQUIRE(list.spilled() == 0);
+	}
+
+	SECTION("Copies and moves keep the elements in their own slots") {
+		SmallList<std::string, 2> list;
+		for (int val = 0; val < 4; ++val)
+			list.append(std::string(val + 1, 'a'));
+
+		SmallList<std::string, 2> copy{ list };
+		copy.pop(0);
+		REQUIRE(contents(list) == std::vector<std::string>{ "a", "aa", "aaa", "aaaa" });
+		REQUIRE(contents(copy) == std::vector<std::string>{ "aa", "aaa", "aaaa" });
+
+		SmallList<std::string, 2> moved{ std::move(copy) };
+		REQUIRE(copy.empty());
+		REQUIRE(contents(moved) == std::vector<std::string>{ "aa", "aaa", "aaaa" });
+		moved.append("b");
+		REQUIRE(moved.spilled() == 2);
+
+		list = moved;
+		REQUIRE(contents(list) == contents(moved));
+		list = std::move(moved);
+		REQUIRE(moved.empty());
+		REQUIRE(contents(list) == std::vector<std::string>{ "aa", "aaa", "aaaa", "b" });
+	}
+
+	SECTION("Removes a value that is one of its own elements") {
+		SmallList<std::string, 2> list;
+		for (const char* val : { "ccc", "a", "ccc", "a", "ccc" })
+			list.append(val);
+		REQUIRE(list.spilled() == 3);
+
+		list.remove_all(*list.begin());
+		REQUIRE(contents(list) == std::vector<std::string>{ "a", "a" });
+
+		list.append("ccc");
+		list.append("ccc");
+		auto last = list.begin();
+		++last;
+		++last;
+		list.remove_all(*last);
+		REQUIRE(contents(list) == std::vector<std::string>{ "a", "a" });
+	}
+
+	SECTION("Spills into a pool") {
+		NodePool* pool = NodePool::create();
+		{
+			SmallList<int, 2, PoolAllocator<int>> list{ PoolAllocator<int>{ pool } };
+			for (int val = 0; val < 10; ++val)
+				list.append(val);
+			REQUIRE(pool->live_slots() == 8);
+			REQUIRE(list.index(9) == 9);
+		}
+		REQUIRE(pool->live_slots() == 0);
+		pool->unreference();
+	}
+}
@@ -0,0 +1,139 @@
+#include "catch.hpp"
+#include "StaticList.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	template <typename T, size_t N>
+	std::vector<T> contents(const StaticList<T, N>& list) {
+		return std::vector<T>(list.begin(), list.end());
+	}
+
+	// The first n squares, built while compiling.
+	template <size_t N>
+	constexpr StaticList<int, N> squares(int n) {
+		StaticList<int, N> list;
+		for (int val = 0; val < n; ++val)
+			list.append(val * val);
+
+		return list;
+	}
+
+	constexpr StaticList<int, 8> edited() {
+		StaticList<int, 8> list = squares<8>(6);
+		list.insert(0, -1);
+		list.insert(3, 100);
+		list.pop();
+		list.pop(0);
+		list.remove(4);
+		list.append(9);
+		list.remove_all(9);
+		list.append(7);
+
+		return list;
+	}
+
+	constexpr int sum(const StaticList<int, 8>& list) {
+		int total{ 0 };
+		for (int value : list)
+			total += value;
+
+		return total;
+	}
+
+	constexpr auto table = squares<16>(10);
+	static_assert(table.size() == 10);
+	static_assert(table.index(0) == 0 && table.index(9) == 81);
+	static_assert(table.count(49) == 1 && table.count(50) == 0);
+
+	constexpr auto changed = edited();
+	static_assert(changed.size() == 5);
+	static_assert(changed.index(0) == 0 && changed.index(1) == 1);
+	static_assert(changed.index(2) == 100 && changed.index(3) == 16);
+	static_assert(changed.index(4) == 7);
+	static_assert(sum(changed) == 124);
+
+	static_assert(sizeof(StaticList<int, 100>::Index) == 1);
+	static_assert(sizeof(StaticList<int, 255>::Index) == 2);
+	static_assert(sizeof(StaticList<int, 70000>::Index) == 4);
+}
+
+TEST_CASE("StaticList") {
+	SECTION("Matches SinglyLinkedList's operations") {
+		int arr[]{ 0, 1, 2, 3, 4 };
+		StaticList<int, 16> list{ arr, 5 };
+
+		list.insert(0, -1);
+		list.insert(3, 100);
+		list.insert(99, 5);
+		list.insert(-1, 6);
+		REQUIRE(contents(list) == std::vector<int>{ -1, 0, 1, 100, 2, 3, 4, 5, 6 });
+
+		REQUIRE(list.pop() == 6);
+		REQUIRE(list.pop(0) == -1);
+		REQUIRE(list.pop(2) == 100);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+
+		list.append(2);
+		list.remove(2);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4, 5, 2 });
+		REQUIRE(list.count(2) == 1);
+
+		list.append(2);
+		list.remove_all(2);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 3, 4, 5 });
+
+		list.remove(5);
+		list.append(7);
+		REQUIRE(list.index(list.size() - 1) == 7);
+
+		REQUIRE_THROWS_AS(list.index(5), std::out_of_range);
+		REQUIRE_THROWS_AS(list.pop(5), std::out_of_range);
+
+		list.clear();
+		REQUIRE(list.empty());
+		REQUIRE(list.begin() == list.end());
+		REQUIRE_THROWS_AS(list.pop(), std::out_of_range);
+	}
+
+	SECTION("Reuses freed slots and refuses to grow past N") {
+		StaticList<int, 4> list;
+		for (int val = 0; val < 4; ++val)
+			list.append(val);
+		REQUIRE(list.full());
+		REQUIRE_THROWS_AS(list.append(4), std::length_error);
+		REQUIRE_THROWS_AS(list.insert(0, 4), std::length_error);
+		REQUIRE(contents(list) == std::vector<int>{ 0, 1, 2, 3 });
+
+		for (int round = 0; round < 100; ++round) {
+			list.pop(0);
+			list.append(round);
+		}
+		REQUIRE(contents(list) == std::vector<int>{ 96, 97, 98, 99 });
+	}
+
+	SECTION("Removes a value that is one of its own elements") {
+		StaticList<int, 8> list;
+		for (int val : { 3, 0, 3, 0, 3 })
+			list.append(val);
+
+		list.remove_all(*list.begin());
+		REQUIRE(contents(list) == std::vector<int>{ 0, 0 });
+		list.remove(*list.begin());
+		REQUIRE(contents(list) == std::vector<int>{ 0 });
+	}
+
+	SECTION("Copies are independent") {
+		StaticList<std::string, 4> list;
+		list.append("a");
+		list.append("b");
+
+		auto copy = list;
+		copy.pop(0);
+		copy.append("c");
+
+		REQUIRE(contents(list) == std::vector<std::string>{ "a", "b" });
+		REQUIRE(contents(copy) == std::vector<std::string>{ "b", "c" });
+	}
+}
@@ -0,0 +1,85 @@
+#include "catch.hpp"
+#include "SinglyLinkedList.h"
+#include "DoublyLinkedList.h"
+#include "Traversal.h"
+#include <vector>
+
+TEST_CASE("PrefetchTraversal") {
+	const size_t arr_size{ 12 };
+	int arr[arr_size]{ 1,2,3,4,5,4,7,8,4,10,11,12 };
+
+	SECTION("SinglyLinkedList") {
+		SinglyLinkedList<int> direct{ arr, arr_size };
+		SinglyLinkedList<int, PrefetchTraversal<8>> prefetched{ arr, arr_size };
+
+		REQUIRE(prefetched.count(4) == direct.count(4));
+		for (size_t idx = 0; idx < arr_size; ++idx)
+			REQUIRE(prefetched.index(idx) == direct.index(idx));
+
+		prefetched.remove(4);
+		prefetched.insert(3, 42);
+		REQUIRE(prefetched.pop(4) == 5);
+		REQUIRE(prefetched.count(4) == 2);
+		REQUIRE(prefetched.index(3) == 42);
+
+		size_t visited{ 0 };
+		for (auto it = prefetched.begin(); it != prefetched.end(); ++it)
+			++visited;
+
+		REQUIRE(visited == prefetched.size());
+	}
+
+	SECTION("DoublyLinkedList") {
+		DoublyLinkedList<int> direct{ arr, arr_size };
+		DoublyLinkedList<int, PrefetchTraversal<1>> prefetched{ arr, arr_size };
+
+		REQUIRE(prefetched.count(4) == direct.count(4));
+		for (size_t idx = 0; idx < arr_size; ++idx)
+			REQUIRE(prefetched.index(idx) == direct.index(idx));
+
+		prefetched.remove(4);
+		prefetched.insert(3, 42);
+		REQUIRE(prefetched.pop(4) == 5);
+		REQUIRE(prefetched.count(4) == 2);
+		REQUIRE(prefetched.index(3) == 42);
+
+		int expected[]{ 1,2,3,42,4,7,8,4,10,11,12 };
+		size_t position{ 0 };
+		for (auto it = prefetched.begin(); it != prefetched.end(); ++it)
+			REQUIRE(*it == expected[position++]);
+
+		REQUIRE(position == prefetched.size());
+	}
+
+	SECTION("Compacted nodes") {
+		SinglyLinkedList<int, PrefetchTraversal<8>> prefetched{ arr, arr_size };
+
+		prefetched.compact();
+		prefetched.remove(4);
+		prefetched.insert(3, 42);
+		REQUIRE(prefetched.pop(4) == 5);
+		REQUIRE(prefetched.count(4) == 2);
+		REQUIRE(prefetched.index(3) == 42);
+		REQUIRE(std::vector<int>(prefetched.begin(), prefetched.end()) == std::vector<int>{ 1, 2, 3, 42, 4, 7, 8, 4, 10, 11, 12 });
+	}
+
+	SECTION("remove_all frees the node the lookahead is on") {
+		SinglyLinkedList<int, PrefetchTraversal<8>> singly;
+		DoublyLinkedList<int, PrefetchTraversal<8>> doubly;
+		for (int val = 0; val < 1000; ++val) {
+			singly.append(val % 2);
+			doubly.append(val % 2);
+		}
+
+		singly.remove_all(0);
+		doubly.remove_all(0);
+		REQUIRE(singly.size() == 500);
+		REQUIRE(singly.count(1) == 500);
+		REQUIRE(doubly.size() == 500);
+		REQUIRE(doubly.count(1) == 500);
+
+		singly.compact();
+		singly.remove_all(1);
+		REQUIRE(singly.empty());
+	}
+}
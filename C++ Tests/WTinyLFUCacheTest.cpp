@@ -0,0 +1,168 @@
+#include "catch.hpp"
+#include "WTinyLFUCache.h"
+#include "FrequencySketch.h"
+#include <string>
+
+TEST_CASE("FrequencySketch") {
+	FrequencySketch sketch{ 1000 };
+
+	SECTION("Sizes rows to a power of two") {
+		REQUIRE(sketch.width() == 4096);
+		REQUIRE(sketch.sample_size() == 10240);
+	}
+
+	SECTION("Counts and saturates") {
+		REQUIRE(sketch.estimate(7) == 0);
+
+		for (int count = 0; count < 5; ++count)
+			sketch.increment(7);
+		REQUIRE(sketch.estimate(7) == 5);
+		REQUIRE(sketch.estimate(8) == 0);
+
+		for (int count = 0; count < 20; ++count)
+			sketch.increment(7);
+		REQUIRE(sketch.estimate(7) == FrequencySketch::max_count);
+		REQUIRE(sketch.additions() == 25);
+
+		sketch.clear();
+		REQUIRE(sketch.estimate(7) == 0);
+		REQUIRE(sketch.additions() == 0);
+	}
+
+	SECTION("Halves after a sample") {
+		FrequencySketch small{ 1 };
+		for (int count = 0; count < 15; ++count)
+			small.increment(3);
+		for (uint64_t hash = 100; small.additions() < small.sample_size() - 1; ++hash)
+			small.increment(hash);
+
+		REQUIRE(small.estimate(3) == 15);
+		small.increment(4);
+		REQUIRE(small.estimate(3) == 7);
+		REQUIRE(small.additions() == small.sample_size() / 2);
+	}
+}
+
+TEST_CASE("WTinyLFUCache") {
+	using Segment = WTinyLFUCache<int, std::string>::Segment;
+	WTinyLFUCache<int, std::string> cache{ 100 };
+
+	SECTION("Sizes the segments") {
+		REQUIRE(cache.capacity() == 100);
+		REQUIRE(cache.window_capacity() == 1);
+		REQUIRE(cache.protected_capacity() == 79);
+	}
+
+	SECTION("Get and put") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+
+		REQUIRE(cache.get(1) == "one");
+		REQUIRE(cache.get(2) == "two");
+		REQUIRE_FALSE(cache.get(3));
+		REQUIRE(cache.size() == 2);
+
+		cache.put(1, "uno");
+		REQUIRE(cache.get(1) == "uno");
+		REQUIRE(cache.size() == 2);
+	}
+
+	SECTION("Moves entries between segments") {
+		cache.put(1, "one");
+		REQUIRE(cache.segment(1) == Segment::Window);
+
+		cache.put(2, "two");
+		REQUIRE(cache.segment(1) == Segment::Probation);
+		REQUIRE(cache.segment(2) == Segment::Window);
+
+		cache.get(1);
+		REQUIRE(cache.segment(1) == Segment::Protected);
+		REQUIRE_FALSE(cache.segment(3));
+
+		// each put pushes the previous key into probation, where a hit promotes
+		// it; protected overflow is demoted, least recent first
+		for (int key = 10; key < 90; ++key) {
+			cache.put(key, "many");
+			cache.get(key - 1);
+		}
+		REQUIRE(cache.segment(1) == Segment::Probation);
+		REQUIRE(cache.size() == 82);
+	}
+
+	SECTION("Resists a one-off scan") {
+		for (int key = 0; key < 100; ++key)
+			cache.put(key, "hot");
+		for (int round = 0; round < 3; ++round)
+			for (int key = 0; key < 100; ++key)
+				cache.get(key);
+
+		for (int key = 1000; key < 1500; ++key)
+			cache.put(key, "scan");
+
+		size_t hot{ 0 };
+		for (int key = 0; key < 100; ++key)
+			hot += cache.contains(key) ? 1 : 0;
+
+		REQUIRE(hot >= 95);
+		REQUIRE(cache.rejections() >= 495);
+		REQUIRE(cache.size() == 100);
+	}
+
+	SECTION("Admits keys that become frequent") {
+		for (int key = 0; key < 100; ++key)
+			cache.put(key, "old");
+
+		for (int round = 0; round < 5; ++round)
+			for (int key = 200; key < 220; ++key)
+				if (!cache.get(key))
+					cache.put(key, "new");
+
+		for (int key = 200; key < 220; ++key)
+			REQUIRE(cache.contains(key));
+		REQUIRE(cache.size() == 100);
+	}
+
+	SECTION("Erase and clear") {
+		cache.put(1, "one");
+		cache.put(2, "two");
+		cache.get(1);
+
+		REQUIRE(cache.erase(1));
+		REQUIRE_FALSE(cache.erase(1));
+		REQUIRE(cache.erase(2));
+		REQUIRE(cache.size() == 0);
+
+		cache.put(3, "three");
+		cache.clear();
+		REQUIRE(cache.size() == 0);
+		cache.put(4, "four");
+		REQUIRE(cache.get(4) == "four");
+	}
+
+	SECTION("Stats") {
+		for (int key = 0; key < 150; ++key)
+			cache.put(key, "many");
+		cache.get(149);
+		cache.get(1000);
+
+		REQUIRE(cache.stats().hits == 1);
+		REQUIRE(cache.stats().misses == 1);
+		REQUIRE(cache.stats().insertions == 150);
+		REQUIRE(cache.stats().evictions == 50);
+		REQUIRE(cache.rejections() <= 50);
+	}
+
+	SECTION("Capacity of one") {
+		WTinyLFUCache<int, int> single{ 1 };
+		single.put(1, 1);
+		single.put(2, 2);
+
+		REQUIRE(single.size() == 1);
+		REQUIRE(single.get(2) == 2);
+		REQUIRE_FALSE(single.contains(1));
+	}
+
+	SECTION("Capacity must be positive") {
+		REQUIRE_THROWS_AS((WTinyLFUCache<int, int>{ 0 }), std::invalid_argument);
+	}
+}
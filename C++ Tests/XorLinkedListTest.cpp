@@ -0,0 +1,74 @@
+#include "catch.hpp"
+#include "XorLinkedList.h"
+#include <stdexcept>
+
+TEST_CASE("XorLinkedList") {
+	const size_t arr_size{ 7 };
+	int arr[arr_size]{ 1,2,3,4,5,4,7 };
+	XorLinkedList<int> list{ arr, arr_size };
+
+	SECTION("Forward and reverse iteration") {
+		size_t position{ 0 };
+		for (auto it = list.begin(); it != list.end(); ++it)
+			REQUIRE(*it == arr[position++]);
+		REQUIRE(position == arr_size);
+
+		for (auto it = list.rbegin(); it != list.rend(); ++it)
+			REQUIRE(*it == arr[--position]);
+		REQUIRE(position == 0);
+	}
+
+	SECTION("Both ends") {
+		list.prepend(0);
+		list.append(8);
+
+		REQUIRE(list.size() == 9);
+		REQUIRE(list.front() == 0);
+		REQUIRE(list.back() == 8);
+
+		REQUIRE(list.pop_front() == 0);
+		REQUIRE(list.pop_back() == 8);
+		REQUIRE(list.pop_back() == 7);
+		REQUIRE(list.pop_front() == 1);
+		REQUIRE(list.size() == 5);
+		REQUIRE(list.front() == 2);
+		REQUIRE(list.back() == 4);
+	}
+
+	SECTION("Index and count") {
+		for (size_t idx = 0; idx < arr_size; ++idx)
+			REQUIRE(list.index(idx) == arr[idx]);
+
+		REQUIRE(list.count(4) == 2);
+		REQUIRE_THROWS_AS(list.index(arr_size), std::out_of_range);
+	}
+
+	SECTION("Drain") {
+		while (list.size() > 0)
+			list.pop_back();
+
+		REQUIRE_FALSE(list.begin() != list.end());
+		REQUIRE_THROWS_AS(list.pop_front(), std::out_of_range);
+
+		list.prepend(1);
+		REQUIRE(list.front() == 1);
+		REQUIRE(list.back() == 1);
+	}
+
+	SECTION("Copy and move") {
+		XorLinkedList<int> copy{ list };
+		copy.append(9);
+
+		REQUIRE(list.size() == arr_size);
+		REQUIRE(copy.size() == arr_size + 1);
+		REQUIRE(copy.index(3) == 4);
+
+		XorLinkedList<int> moved{ std::move(copy) };
+		REQUIRE(moved.back() == 9);
+		REQUIRE(copy.size() == 0);
+
+		list = moved;
+		REQUIRE(list.size() == arr_size + 1);
+		REQUIRE(list.back() == 9);
+	}
+}
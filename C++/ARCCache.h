@@ -0,0 +1,306 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include "CacheStats.h"
+#include "DoublyLinkedList.h"
+#include "NodePool.h"
+
+// Adaptive replacement cache (Megiddo and Modha, FAST 2003) of at most
+// capacity entries.
+//
+// Cached entries are split between two LRU lists: recent (T1) for keys seen
+// once since they entered, and frequent (T2) for keys hit again. Two ghost
+// lists remember the keys, without values, last evicted from each: recent
+// ghosts (B1) and frequent ghosts (B2), at most capacity keys between the
+// ghosts and their list. A put() of a key found among the recent ghosts
+// means recent entries were evicted too soon, so the target size of the
+// recent list grows; a key found among the frequent ghosts shrinks it. The
+// victim comes from the recent list while it is over its target and from
+// the frequent list otherwise, so the balance tunes itself to the workload.
+//
+// All four lists are DoublyLinkedLists. A hit splices its node from recent
+// to frequent; an eviction moves the key to a ghost list, and a put() that
+// finds a ghost moves it back into the frequent list. Every operation is
+// O(1) apart from hashing.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>,
+	typename Allocator = PoolAllocator<std::pair<K, V>>>
+class ARCCache {
+public:
+	using Entry = std::pair<K, V>;
+
+	enum class Segment : uint8_t {
+		Recent,
+		Frequent,
+		RecentGhost,
+		FrequentGhost,
+	};
+private:
+	using List = DoublyLinkedList<Entry, DirectTraversal, Allocator>;
+	using Handle = std::shared_ptr<typename List::Node>;
+	using GhostAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<K>;
+	using GhostList = DoublyLinkedList<K, DirectTraversal, GhostAllocator>;
+	using GhostHandle = std::shared_ptr<typename GhostList::Node>;
+
+	// entry is set for the cached segments, ghost for the ghost ones
+	struct Location {
+		Handle entry;
+		GhostHandle ghost;
+		Segment segment;
+	};
+
+	using MapAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const K, Location>>;
+
+	size_t m_capacity;
+	size_t m_target{ 0 };
+	CacheStats m_stats;
+	// declared before the map, so the map's handles are released first
+	List m_recent;
+	List m_frequent;
+	GhostList m_recent_ghosts;
+	GhostList m_frequent_ghosts;
+	std::unordered_map<K, Location, Hash, KeyEqual, MapAllocator> m_entries;
+
+	static bool cached(const Location& location) noexcept;
+	bool full() const noexcept { return m_recent.size() + m_frequent.size() == m_capacity; }
+	void promote(Location& location);
+	void replace(bool frequent_ghost);
+	void forget(GhostList& ghosts);
+	void revive(Location& location, GhostList& ghosts, V value);
+public:
+	explicit ARCCache(size_t capacity, const Allocator& allocator = Allocator());
+	ARCCache(const ARCCache&) = delete;
+	ARCCache& operator=(const ARCCache&) = delete;
+
+	std::optional<V> get(const K& key);
+	void put(const K& key, V value);
+	bool erase(const K& key);
+	bool contains(const K& key) const;
+	void clear();
+
+	// Which list holds key, cached or ghost, if any.
+	std::optional<Segment> segment(const K& key) const;
+
+	size_t size() const noexcept { return m_recent.size() + m_frequent.size(); }
+	size_t capacity() const noexcept { return m_capacity; }
+	// The size the recent list is steered towards, between 0 and capacity.
+	size_t target_recent() const noexcept { return m_target; }
+	size_t recent_size() const noexcept { return m_recent.size(); }
+	size_t frequent_size() const noexcept { return m_frequent.size(); }
+	size_t recent_ghosts() const noexcept { return m_recent_ghosts.size(); }
+	size_t frequent_ghosts() const noexcept { return m_frequent_ghosts.size(); }
+
+	const CacheStats& stats() const noexcept { return m_stats; }
+	void reset_stats() noexcept { m_stats = CacheStats{}; }
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+ARCCache<K, V, Hash, KeyEqual, Allocator>::ARCCache(size_t capacity, const Allocator& allocator) :
+	m_capacity(capacity), m_recent(allocator), m_frequent(allocator), m_recent_ghosts(GhostAllocator(allocator)),
+	m_frequent_ghosts(GhostAllocator(allocator)), m_entries(0, Hash(), KeyEqual(), MapAllocator(allocator)) {
+	if (capacity == 0)
+		throw std::invalid_argument("ARCCache capacity must be at least 1");
+
+	m_entries.reserve(2 * capacity);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool ARCCache<K, V, Hash, KeyEqual, Allocator>::cached(const Location& location) noexcept {
+
+	return location.segment == Segment::Recent || location.segment == Segment::Frequent;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ARCCache<K, V, Hash, KeyEqual, Allocator>::promote(Location& location) {
+	if (location.segment == Segment::Recent) {
+		m_frequent.splice_back(m_recent, location.entry);
+		location.segment = Segment::Frequent;
+	}
+	else {
+		m_frequent.move_to_back(location.entry);
+	}
+}
+
+// Evicts the least recent entry of the recent list if it is over its target,
+// or at it when the key being put was a frequent ghost, and otherwise of the
+// frequent list. The victim's key joins the matching ghost list.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ARCCache<K, V, Hash, KeyEqual, Allocator>::replace(bool frequent_ghost) {
+	size_t recent = m_recent.size();
+	bool from_recent = recent > 0 &&
+		(recent > m_target || (frequent_ghost && recent == m_target) || m_frequent.size() == 0);
+
+	List& victims = from_recent ? m_recent : m_frequent;
+	GhostList& ghosts = from_recent ? m_recent_ghosts : m_frequent_ghosts;
+
+	Handle victim = victims.front();
+	Location& location = m_entries.find(victim->data().first)->second;
+
+	ghosts.append(victim->data().first);
+	location.ghost = ghosts.back();
+	location.entry.reset();
+	location.segment = from_recent ? Segment::RecentGhost : Segment::FrequentGhost;
+
+	victims.erase(victim);
+	++m_stats.evictions;
+}
+
+// Drops the oldest key from a ghost list.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ARCCache<K, V, Hash, KeyEqual, Allocator>::forget(GhostList& ghosts) {
+	GhostHandle oldest = ghosts.front();
+
+	m_entries.erase(oldest->data());
+	ghosts.erase(oldest);
+}
+
+// Brings a ghost back into the cache as the most recent frequent entry.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ARCCache<K, V, Hash, KeyEqual, Allocator>::revive(Location& location, GhostList& ghosts, V value) {
+	GhostHandle ghost = std::move(location.ghost);
+	ghosts.erase(ghost);
+
+	m_frequent.append(Entry(ghost->data(), std::move(value)));
+	location.entry = m_frequent.back();
+	location.segment = Segment::Frequent;
+	++m_stats.insertions;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+std::optional<V> ARCCache<K, V, Hash, KeyEqual, Allocator>::get(const K& key) {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end() || !cached(found->second)) {
+		++m_stats.misses;
+		return std::nullopt;
+	}
+
+	++m_stats.hits;
+	promote(found->second);
+
+	return found->second.entry->data().second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ARCCache<K, V, Hash, KeyEqual, Allocator>::put(const K& key, V value) {
+	auto found = m_entries.find(key);
+
+	if (found != m_entries.end()) {
+		Location& location = found->second;
+
+		switch (location.segment) {
+		case Segment::Recent:
+		case Segment::Frequent:
+			location.entry->data().second = std::move(value);
+			promote(location);
+			break;
+		case Segment::RecentGhost:
+			m_target = std::min(m_capacity,
+				m_target + std::max<size_t>(m_frequent_ghosts.size() / m_recent_ghosts.size(), 1));
+			if (full())
+				replace(false);
+			revive(location, m_recent_ghosts, std::move(value));
+			break;
+		case Segment::FrequentGhost:
+			m_target -= std::min(m_target,
+				std::max<size_t>(m_recent_ghosts.size() / m_frequent_ghosts.size(), 1));
+			if (full())
+				replace(true);
+			revive(location, m_frequent_ghosts, std::move(value));
+			break;
+		}
+		return;
+	}
+
+	// A key seen for the first time. The recent list and its ghosts together
+	// stay within capacity, and all four lists within twice capacity.
+	size_t recent = m_recent.size() + m_recent_ghosts.size();
+	size_t total = recent + m_frequent.size() + m_frequent_ghosts.size();
+
+	if (recent >= m_capacity) {
+		if (m_recent.size() < m_capacity) {
+			forget(m_recent_ghosts);
+			if (full())
+				replace(false);
+		}
+		else {
+			Handle oldest = m_recent.front();
+			m_entries.erase(oldest->data().first);
+			m_recent.erase(oldest);
+			++m_stats.evictions;
+		}
+	}
+	else if (total >= m_capacity) {
+		if (total >= 2 * m_capacity)
+			forget(m_frequent_ghosts);
+		if (full())
+			replace(false);
+	}
+
+	m_recent.append(Entry(key, std::move(value)));
+	m_entries.emplace(key, Location{ m_recent.back(), nullptr, Segment::Recent });
+	++m_stats.insertions;
+}
+
+// Removes key from the cache, or from the ghost lists if it was only
+// remembered there; returns whether it was cached.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool ARCCache<K, V, Hash, KeyEqual, Allocator>::erase(const K& key) {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return false;
+
+	Location& location = found->second;
+	bool was_cached = cached(location);
+
+	switch (location.segment) {
+	case Segment::Recent:
+		m_recent.erase(location.entry);
+		break;
+	case Segment::Frequent:
+		m_frequent.erase(location.entry);
+		break;
+	case Segment::RecentGhost:
+		m_recent_ghosts.erase(location.ghost);
+		break;
+	case Segment::FrequentGhost:
+		m_frequent_ghosts.erase(location.ghost);
+		break;
+	}
+	m_entries.erase(found);
+
+	return was_cached;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool ARCCache<K, V, Hash, KeyEqual, Allocator>::contains(const K& key) const {
+	auto found = m_entries.find(key);
+
+	return found != m_entries.end() && cached(found->second);
+}
+
+// Empties the cache and its ghosts and forgets the learned target.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ARCCache<K, V, Hash, KeyEqual, Allocator>::clear() {
+	m_entries.clear();
+	m_recent.clear();
+	m_frequent.clear();
+	m_recent_ghosts.clear();
+	m_frequent_ghosts.clear();
+	m_target = 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+std::optional<typename ARCCache<K, V, Hash, KeyEqual, Allocator>::Segment>
+ARCCache<K, V, Hash, KeyEqual, Allocator>::segment(const K& key) const {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return std::nullopt;
+
+	return found->second.segment;
+}
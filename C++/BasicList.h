@@ -0,0 +1,1033 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "CountingAllocator.h"
+#include "Instrumentation.h"
+#include "ListSerialization.h"
+#include "NodeArena.h"
+#include "Traversal.h"
+
+// MSVC gives only the first of several empty bases offset zero unless asked.
+#if defined(_MSC_VER)
+#define DSA_EMPTY_BASES __declspec(empty_bases)
+#else
+#define DSA_EMPTY_BASES
+#endif
+
+// Ownership policies for BasicList: how the list and its callers hold nodes.
+
+// Nodes are reference counted. front(), back() and the other handles are
+// std::shared_ptr, so a node a caller still holds outlives its removal from
+// the list, and back links are std::weak_ptr. Every node carries a control
+// block next to it. Copying the list copies its links, not its nodes.
+struct SharedOwnership {
+	static constexpr bool shared{ true };
+
+	template <typename Node>
+	using Link = std::shared_ptr<Node>;
+	template <typename Node>
+	using BackLink = std::weak_ptr<Node>;
+};
+
+// The list owns its nodes outright and links them by raw pointers. Handles
+// are plain Node*, valid until the node is removed or the list compacted,
+// nodes take exactly sizeof(Node) from the allocator, and the list can be
+// moved but not copied.
+struct ExclusiveOwnership {
+	static constexpr bool shared{ false };
+
+	template <typename Node>
+	using Link = Node*;
+	template <typename Node>
+	using BackLink = Node*;
+};
+
+// Compile-time switches for what a BasicList keeps besides its head:
+//
+//   BackLinks  a link to the previous node in every node, for reverse
+//              iteration and O(1) erase(), move_to_back() and splice_back()
+//   TrackSize  an element count; without it size() walks the list
+//   TrackTail  a link to the last node; without it append() and back() walk
+//              the list
+//   Ownership  SharedOwnership or ExclusiveOwnership
+//   Compaction compact() and compact_step(), and the cursor and generation
+//              count the list keeps so that a compaction can run in steps
+//
+// A feature that is off takes no space in the list or its nodes, and the code
+// that would keep it up to date is not compiled.
+template <bool BackLinks, bool TrackSize = true, bool TrackTail = true, typename Ownership = SharedOwnership,
+	bool Compaction = true>
+struct ListFeatures {
+	static constexpr bool back_links{ BackLinks };
+	static constexpr bool track_size{ TrackSize };
+	static constexpr bool track_tail{ TrackTail };
+	using ownership = Ownership;
+	static constexpr bool compaction{ Compaction };
+};
+
+// The features SinglyLinkedList and DoublyLinkedList are made of.
+using SinglyLinks = ListFeatures<false>;
+using DoublyLinks = ListFeatures<true>;
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+class BasicList;
+
+namespace list_core {
+	struct AllocatorTag;
+	struct InstrumentationTag;
+
+	// Holds a policy object, as a base when it is empty so that it takes no
+	// space; Tag keeps two holders of the same type apart.
+	template <typename Tag, typename Policy, bool = std::is_empty_v<Policy> && !std::is_final_v<Policy>>
+	class Holder {
+	private:
+		Policy m_policy;
+	public:
+		Holder() = default;
+		explicit Holder(const Policy& policy) : m_policy(policy) {};
+
+		Policy& get() noexcept { return m_policy; }
+		const Policy& get() const noexcept { return m_policy; }
+	};
+
+	template <typename Tag, typename Policy>
+	class Holder<Tag, Policy, true> : private Policy {
+	public:
+		Holder() = default;
+		explicit Holder(const Policy& policy) : Policy(policy) {};
+
+		Policy& get() noexcept { return *this; }
+		const Policy& get() const noexcept { return *this; }
+	};
+
+	// Storage for the features that can be switched off; the disabled
+	// specializations are empty.
+	template <bool>
+	struct Size {
+		size_t m_size{ 0 };
+	};
+
+	template <>
+	struct Size<false> {};
+
+	template <typename Link, bool>
+	struct Tail {
+		Link m_tail{ nullptr };
+	};
+
+	template <typename Link>
+	struct Tail<Link, false> {};
+
+	template <typename BackLink, bool>
+	struct Prev {
+		BackLink m_prev{};
+	};
+
+	template <typename BackLink>
+	struct Prev<BackLink, false> {};
+
+	template <typename Node, bool>
+	struct Compaction {
+		size_t m_generation{ 0 };
+		CompactionCursor<Node> m_compaction;
+	};
+
+	template <typename Node>
+	struct Compaction<Node, false> {};
+
+	template <bool>
+	struct Copyable {};
+
+	template <>
+	struct Copyable<false> {
+		Copyable() = default;
+		Copyable(const Copyable&) = delete;
+		Copyable(Copyable&&) = default;
+		Copyable& operator=(const Copyable&) = delete;
+		Copyable& operator=(Copyable&&) = default;
+	};
+
+	template <typename T, typename Features>
+	class Node : private Prev<typename Features::ownership::template BackLink<Node<T, Features>>, Features::back_links> {
+		template <typename, typename, typename, typename, typename>
+		friend class ::BasicList;
+	public:
+		using Handle = typename Features::ownership::template Link<Node>;
+	private:
+		T m_data;
+		Handle m_next{ nullptr };
+
+		static Node* address(const Handle& link) noexcept {
+			if constexpr (Features::ownership::shared)
+				return link.get();
+			else
+				return link;
+		}
+	public:
+		Node(T value) : m_data(std::move(value)) {};
+		~Node();
+		T& data() noexcept { return m_data; }
+		const T& data() const noexcept { return m_data; }
+		Handle next() const { return m_next; }
+		Node* next_node() noexcept { return address(m_next); }
+		const Node* next_node() const noexcept { return address(m_next); }
+	};
+
+	// A reference-counted node frees the successors only it holds one at a
+	// time; letting m_next go would destroy them recursively and overflow the
+	// stack on long chains. The walk stops at a successor someone else still
+	// holds, which does the same for the rest of the chain when it goes.
+	template <typename T, typename Features>
+	Node<T, Features>::~Node() {
+		if constexpr (Features::ownership::shared) {
+			while (m_next && m_next.use_count() == 1)
+				m_next = std::move(m_next->m_next);
+		}
+	}
+
+	template <typename T, typename Features, typename Allocator>
+	using NodeAllocator = std::conditional_t<Features::ownership::shared, Allocator,
+		typename std::allocator_traits<Allocator>::template rebind_alloc<Node<T, Features>>>;
+}
+
+// Linked list core that SinglyLinkedList, DoublyLinkedList and leaner lists
+// are instantiated from. Features (see ListFeatures) picks the bookkeeping
+// the list keeps; Traversal, Allocator and Instrumentation are the policies
+// the lists have always taken. Members that need back links do not compile
+// without them.
+//
+// Handles are the ownership policy's links: from front(), back(), next() and
+// insert_after(), taken by erase_after(), erase(), move_to_back() and the
+// splices. Iterators yield the elements themselves.
+template <typename T, typename Features = SinglyLinks, typename Traversal = DirectTraversal,
+	typename Allocator = std::allocator<T>, typename Instrumentation = NoInstrumentation>
+class DSA_EMPTY_BASES BasicList :
+	private list_core::Size<Features::track_size>,
+	private list_core::Tail<typename list_core::Node<T, Features>::Handle, Features::track_tail>,
+	private list_core::Copyable<Features::ownership::shared>,
+	private list_core::Compaction<list_core::Node<T, Features>, Features::compaction>,
+	private list_core::Holder<list_core::AllocatorTag, list_core::NodeAllocator<T, Features, Allocator>>,
+	private list_core::Holder<list_core::InstrumentationTag, Instrumentation> {
+	template <typename, typename, typename, typename, typename>
+	friend class BasicList;
+public:
+	using Node = list_core::Node<T, Features>;
+	using Handle = typename Node::Handle;
+	template <bool Const>
+	class Forward_Iterator;
+	using Iterator = Forward_Iterator<false>;
+	using Const_Iterator = Forward_Iterator<true>;
+	class Reverse_Iterator;
+
+	static constexpr bool back_links{ Features::back_links };
+	static constexpr bool track_size{ Features::track_size };
+	static constexpr bool track_tail{ Features::track_tail };
+	static constexpr bool shared{ Features::ownership::shared };
+	static constexpr bool compaction{ Features::compaction };
+private:
+	using Link = Handle;
+	using BackLink = typename Features::ownership::template BackLink<Node>;
+	using NodeAllocator = list_core::NodeAllocator<T, Features, Allocator>;
+	using NodeTraits = std::allocator_traits<NodeAllocator>;
+	using AllocatorHolder = list_core::Holder<list_core::AllocatorTag, NodeAllocator>;
+	using InstrumentationHolder = list_core::Holder<list_core::InstrumentationTag, Instrumentation>;
+	using Lookahead = typename Traversal::template Lookahead<Node>;
+
+	static constexpr const char* index_error{ back_links ? "DoublyLinkedList index out of range"
+		: "SinglyLinkedList index out of range" };
+
+	Link m_head{ nullptr };
+public:
+	BasicList() {};
+	explicit BasicList(const Allocator& allocator) : AllocatorHolder(NodeAllocator(allocator)) {};
+	BasicList(T arr[], int size);
+	BasicList(const BasicList&) = default;
+	BasicList(BasicList&& other) noexcept;
+	BasicList& operator=(const BasicList&) = default;
+	BasicList& operator=(BasicList&& other) noexcept;
+	~BasicList();
+
+	Iterator begin();
+	Iterator end();
+	Const_Iterator begin() const;
+	Const_Iterator end() const;
+
+	Reverse_Iterator rbegin();
+	Reverse_Iterator rend();
+
+	void append(T data);
+	void insert(int index, T data);
+	T pop(std::optional<size_t> index = std::nullopt);
+	void remove(T data);
+	void remove_all(T data);
+	T index(size_t index);
+	int count(const T& data);
+	void clear();
+	size_t size() const;
+	bool empty() const noexcept { return !m_head; }
+	void compact();
+	bool compact_step(size_t budget);
+	AllocationStats stats() const;
+	const ListHistograms& histograms() const;
+	void reset_histograms();
+	Handle front() const;
+	Handle back() const;
+	Handle insert_after(const Handle& node, T data);
+	void erase_after(const Handle& prev);
+	void erase(const Handle& node);
+	void move_to_back(const Handle& node);
+	void splice_back(BasicList& other, const Handle& node);
+	void splice_back_after(BasicList& other, const Handle& prev);
+	void save(std::ostream& out) const;
+	void load(std::istream& in);
+private:
+	NodeAllocator& node_allocator() noexcept { return AllocatorHolder::get(); }
+	const NodeAllocator& node_allocator() const noexcept { return AllocatorHolder::get(); }
+	Instrumentation& instrumentation() noexcept { return InstrumentationHolder::get(); }
+	const Instrumentation& instrumentation() const noexcept { return InstrumentationHolder::get(); }
+
+	static Node* address(const Link& link) noexcept { return Node::address(link); }
+	static Link lock(const BackLink& link) noexcept;
+	static T release(Link& node);
+	Link create(T data);
+	void dispose(Link node) noexcept;
+	const Link& last() const noexcept;
+	Link detach(Link& link, const Link* prev) noexcept;
+	void link_back(Link node) noexcept;
+	template <typename Make>
+	bool relocate(size_t budget, Make make);
+	void steal(BasicList& other) noexcept;
+};
+
+// Iterator yields T&, Const_Iterator const T&.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+template <bool Const>
+class BasicList<T, Features, Traversal, Allocator, Instrumentation>::Forward_Iterator {
+private:
+	using NodePointer = std::conditional_t<Const, const Node*, Node*>;
+
+	NodePointer m_current;
+	Lookahead m_ahead;
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = std::conditional_t<Const, const T*, T*>;
+	using reference = std::conditional_t<Const, const T&, T&>;
+
+	explicit Forward_Iterator(NodePointer node) noexcept : m_current(node), m_ahead(node) {};
+
+	reference operator*() const noexcept { return m_current->data(); }
+	pointer operator->() const noexcept { return &m_current->data(); }
+
+	// prefix operator
+	Forward_Iterator& operator++() noexcept {
+		m_current = m_current->next_node();
+		m_ahead.step();
+		return *this;
+	}
+
+	// postfix operator
+	Forward_Iterator operator++(int) noexcept {
+		Forward_Iterator iterator = *this;
+		++*this;
+		return iterator;
+	}
+
+	bool operator==(const Forward_Iterator& other) const noexcept { return m_current == other.m_current; }
+	bool operator!=(const Forward_Iterator& other) const noexcept { return m_current != other.m_current; }
+};
+
+// Walks from the tail to the head; needs back links.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+class BasicList<T, Features, Traversal, Allocator, Instrumentation>::Reverse_Iterator {
+private:
+	Node* m_current;
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+	explicit Reverse_Iterator(Node* node) noexcept : m_current(node) {};
+
+	T& operator*() const noexcept { return m_current->data(); }
+	T* operator->() const noexcept { return &m_current->data(); }
+
+	Reverse_Iterator& operator++() noexcept {
+		m_current = address(lock(m_current->m_prev));
+		return *this;
+	}
+
+	Reverse_Iterator operator++(int) noexcept {
+		Reverse_Iterator riterator = *this;
+		++*this;
+		return riterator;
+	}
+
+	bool operator==(const Reverse_Iterator& other) const noexcept { return m_current == other.m_current; }
+	bool operator!=(const Reverse_Iterator& other) const noexcept { return m_current != other.m_current; }
+};
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+BasicList<T, Features, Traversal, Allocator, Instrumentation>::BasicList(T arr[], int size) {
+	for (auto idx = 0; idx < size; ++idx)
+		append(arr[idx]);
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+BasicList<T, Features, Traversal, Allocator, Instrumentation>::BasicList(BasicList&& other) noexcept :
+	AllocatorHolder(other.node_allocator()), InstrumentationHolder(other.instrumentation()) {
+	steal(other);
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+BasicList<T, Features, Traversal, Allocator, Instrumentation>& BasicList<T, Features, Traversal, Allocator, Instrumentation>::operator=(BasicList&& other) noexcept {
+	if (this != &other) {
+		clear();
+		node_allocator() = other.node_allocator();
+		steal(other);
+	}
+
+	return *this;
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+BasicList<T, Features, Traversal, Allocator, Instrumentation>::~BasicList() {
+	clear();
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Iterator BasicList<T, Features, Traversal, Allocator, Instrumentation>::begin() {
+
+	return Iterator(address(m_head));
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Iterator BasicList<T, Features, Traversal, Allocator, Instrumentation>::end() {
+
+	return Iterator(nullptr);
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Const_Iterator BasicList<T, Features, Traversal, Allocator, Instrumentation>::begin() const {
+
+	return Const_Iterator(address(m_head));
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Const_Iterator BasicList<T, Features, Traversal, Allocator, Instrumentation>::end() const {
+
+	return Const_Iterator(nullptr);
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Reverse_Iterator BasicList<T, Features, Traversal, Allocator, Instrumentation>::rbegin() {
+	static_assert(back_links, "reverse iteration needs a list with back links");
+
+	return Reverse_Iterator(address(last()));
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Reverse_Iterator BasicList<T, Features, Traversal, Allocator, Instrumentation>::rend() {
+	static_assert(back_links, "reverse iteration needs a list with back links");
+
+	return Reverse_Iterator(nullptr);
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::append(T data) {
+	link_back(create(std::move(data)));
+}
+
+// Inserts data before the element at index; an index at or past the end, or
+// negative, appends it.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::insert(int index, T data) {
+	auto probe{ instrumentation().probe(ListOperation::Insert) };
+	Link node{ create(std::move(data)) };
+	Link* link{ &m_head };
+	const Link* prev{ nullptr };
+	Lookahead ahead{ address(m_head) };
+
+	for (int position = 0; *link && position != index; ++position) {
+		prev = link;
+		link = &address(*link)->m_next;
+		ahead.step();
+		probe.visit();
+	}
+
+	Node* inserted = address(node);
+	if constexpr (back_links) {
+		if (*link)
+			address(*link)->m_prev = node;
+		if (prev)
+			inserted->m_prev = *prev;
+	}
+
+	inserted->m_next = std::exchange(*link, nullptr);
+	if constexpr (track_tail) {
+		if (!inserted->m_next)
+			this->m_tail = node;
+	}
+
+	*link = std::move(node);
+	if constexpr (track_size)
+		++this->m_size;
+}
+
+// Removes and returns the element at index, the last one by default.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+T BasicList<T, Features, Traversal, Allocator, Instrumentation>::pop(std::optional<size_t> index) {
+	if (!m_head)
+		throw std::out_of_range(index_error);
+	if constexpr (track_size) {
+		if (index && *index >= this->m_size)
+			throw std::out_of_range(index_error);
+	}
+
+	auto probe{ instrumentation().probe(ListOperation::Pop) };
+	Link* link{ &m_head };
+	const Link* prev{ nullptr };
+	Lookahead ahead{ address(m_head) };
+
+	for (size_t position = 0; index ? position < *index : address(*link)->m_next != nullptr; ++position) {
+		prev = link;
+		link = &address(*link)->m_next;
+		// without a count the walk is what finds an index past the end
+		if constexpr (!track_size) {
+			if (!*link)
+				throw std::out_of_range(index_error);
+		}
+		ahead.step();
+		probe.visit();
+	}
+
+	Link node{ detach(*link, prev) };
+	T data{ release(node) };
+	dispose(std::move(node));
+
+	return data;
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::remove(T data) {
+	auto probe{ instrumentation().probe(ListOperation::Remove) };
+	Link* link{ &m_head };
+	const Link* prev{ nullptr };
+	Lookahead ahead{ address(m_head) };
+
+	while (*link) {
+		if (address(*link)->m_data == data) {
+			dispose(detach(*link, prev));
+			return;
+		}
+
+		prev = link;
+		link = &address(*link)->m_next;
+		ahead.step();
+		probe.visit();
+	}
+}
+
+// data is taken by value, as it may be one of the elements about to be freed.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::remove_all(T data) {
+	auto probe{ instrumentation().probe(ListOperation::RemoveAll) };
+	Link* link{ &m_head };
+	const Link* prev{ nullptr };
+	Lookahead ahead{ address(m_head) };
+
+	while (*link) {
+		ahead.step();
+		if (address(*link)->m_data == data)
+			dispose(detach(*link, prev));
+		else {
+			prev = link;
+			link = &address(*link)->m_next;
+		}
+
+		probe.visit();
+	}
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+T BasicList<T, Features, Traversal, Allocator, Instrumentation>::index(size_t index) {
+	if constexpr (track_size) {
+		if (index >= this->m_size)
+			throw std::out_of_range(index_error);
+	}
+
+	auto probe{ instrumentation().probe(ListOperation::Index) };
+	const Node* current = address(m_head);
+	Lookahead ahead{ current };
+
+	for (size_t position = 0; current && position < index; ++position) {
+		current = current->next_node();
+		ahead.step();
+		probe.visit();
+	}
+
+	if constexpr (!track_size) {
+		if (!current)
+			throw std::out_of_range(index_error);
+	}
+
+	return current->m_data;
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+int BasicList<T, Features, Traversal, Allocator, Instrumentation>::count(const T& data) {
+	auto probe{ instrumentation().probe(ListOperation::Count) };
+	int cnt{ 0 };
+	const Node* current = address(m_head);
+	Lookahead ahead{ current };
+
+	while (current) {
+		if (current->m_data == data)
+			++cnt;
+		current = current->next_node();
+		ahead.step();
+		probe.visit();
+	}
+
+	return cnt;
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::clear() {
+	if constexpr (track_tail)
+		this->m_tail = nullptr;
+
+	if constexpr (shared)
+		m_head.reset();
+	else {
+		while (m_head) {
+			Link node = std::exchange(m_head, m_head->m_next);
+			dispose(node);
+		}
+	}
+
+	if constexpr (track_size)
+		this->m_size = 0;
+	if constexpr (compaction)
+		++this->m_generation;
+}
+
+// O(1) with a count, otherwise a walk over the list.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+size_t BasicList<T, Features, Traversal, Allocator, Instrumentation>::size() const {
+	if constexpr (track_size)
+		return this->m_size;
+	else {
+		size_t length{ 0 };
+		for (const Node* current = address(m_head); current; current = current->next_node())
+			++length;
+
+		return length;
+	}
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Handle BasicList<T, Features, Traversal, Allocator, Instrumentation>::front() const {
+
+	return m_head;
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Handle BasicList<T, Features, Traversal, Allocator, Instrumentation>::back() const {
+
+	return last();
+}
+
+// Inserts data right after node in O(1) and returns the new node.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Handle BasicList<T, Features, Traversal, Allocator, Instrumentation>::insert_after(const Handle& node, T data) {
+	Link inserted{ create(std::move(data)) };
+	Node* raw = address(inserted);
+
+	raw->m_next = std::exchange(node->m_next, nullptr);
+	if constexpr (back_links) {
+		raw->m_prev = node;
+		if (raw->m_next)
+			address(raw->m_next)->m_prev = inserted;
+	}
+	if constexpr (track_tail) {
+		if (!raw->m_next)
+			this->m_tail = inserted;
+	}
+
+	node->m_next = inserted;
+	if constexpr (track_size)
+		++this->m_size;
+
+	return inserted;
+}
+
+// Removes the node after prev, or the front node when prev is null, in O(1).
+// prev is a handle from front(), back() or a walk from them.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::erase_after(const Handle& prev) {
+	dispose(detach(prev ? prev->m_next : m_head, prev ? &prev : nullptr));
+}
+
+// Removes node, a handle from front(), back() or an earlier call, in O(1).
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::erase(const Handle& node) {
+	static_assert(back_links, "erase() needs back links; use erase_after()");
+	if constexpr (back_links) {
+		Link prev{ lock(node->m_prev) };
+		dispose(detach(prev ? address(prev)->m_next : m_head, prev ? &prev : nullptr));
+	}
+}
+
+// Relinks node at the tail in O(1); the node is neither copied nor
+// reallocated, so handles to it stay valid.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::move_to_back(const Handle& node) {
+	static_assert(back_links, "move_to_back() needs back links");
+	if constexpr (back_links) {
+		if (node == last())
+			return;
+
+		Link prev{ lock(node->m_prev) };
+		link_back(detach(prev ? address(prev)->m_next : m_head, prev ? &prev : nullptr));
+	}
+}
+
+// Moves node from other to the tail of this list in O(1), again without
+// copying or reallocating it. Both lists must share an allocator.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::splice_back(BasicList& other, const Handle& node) {
+	static_assert(back_links, "splice_back() needs back links; use splice_back_after()");
+	if constexpr (back_links) {
+		if (&other == this) {
+			move_to_back(node);
+			return;
+		}
+
+		Link prev{ lock(node->m_prev) };
+		link_back(other.detach(prev ? address(prev)->m_next : other.m_head, prev ? &prev : nullptr));
+	}
+}
+
+// Moves the node after prev in other, or other's front node when prev is
+// null, to the tail of this list in O(1) with a tail link. The node is
+// neither copied nor reallocated; both lists must share an allocator.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::splice_back_after(BasicList& other, const Handle& prev) {
+	link_back(other.detach(prev ? prev->m_next : other.m_head, prev ? &prev : nullptr));
+}
+
+// Relocates every node, in traversal order, into a fresh contiguous arena.
+// Handles to relocated nodes obtained earlier no longer belong to the list;
+// nodes whose handle is still held by a caller are left in place. Without
+// shared ownership there is no telling which handles are held, every node is
+// relocated through the allocator and earlier handles are invalidated.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::compact() {
+	static_assert(compaction, "compact() needs a list with the Compaction feature");
+
+	this->m_compaction = CompactionCursor<Node>{};
+	compact_step(SIZE_MAX);
+}
+
+// Relocates at most budget nodes and returns true once the whole list has
+// been compacted. The list may be modified between steps.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+bool BasicList<T, Features, Traversal, Allocator, Instrumentation>::compact_step(size_t budget) {
+	static_assert(compaction, "compact_step() needs a list with the Compaction feature");
+
+	auto& cursor = this->m_compaction;
+
+	if (!cursor.running) {
+		if constexpr (shared)
+			cursor.arena = NodeArena::create(compaction_block_size(size(), sizeof(Node)));
+		cursor.running = true;
+		cursor.prev = nullptr;
+		cursor.position = 0;
+		cursor.generation = this->m_generation;
+	}
+	else if (cursor.generation != this->m_generation) {
+		// seek back to the position reached, or the tail if the list is now
+		// shorter than that
+		size_t position{ 0 };
+		cursor.prev = nullptr;
+		for (Node* current = address(m_head); current && position < cursor.position; ++position) {
+			cursor.prev = current;
+			current = current->next_node();
+		}
+
+		cursor.position = position;
+		cursor.generation = this->m_generation;
+	}
+
+	if constexpr (shared) {
+		auto allocator{ with_upstream(node_allocator(), ArenaAllocator<Node>{ cursor.arena.get() }) };
+
+		return relocate(budget, [&](T data) { return std::allocate_shared<Node>(allocator, std::move(data)); });
+	}
+	else
+		return relocate(budget, [this](T data) { return create(std::move(data)); });
+}
+
+// Writes the list in the format described in ListSerialization.h.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::save(std::ostream& out) const {
+	list_serialization::write_header(out, ListSerializer<T>::width, size());
+	list_serialization::write_elements<T>(out, address(m_head), [](const Node* node) { return node->next_node(); });
+	list_serialization::check_written(out);
+}
+
+// Replaces the contents with a list written by save(), leaving them as they
+// were if the stream does not hold one. Raw elements are read with one read()
+// and, with shared ownership, their nodes allocated back to back from one
+// arena, as compact() would leave them.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::load(std::istream& in) {
+	BasicList loaded{ Allocator(node_allocator()) };
+	auto count = list_serialization::read_header(in, ListSerializer<T>::width);
+
+	// nodes are chained here rather than appended, which would walk the
+	// list each time without a tail link
+	Link* end{ &loaded.m_head };
+	const Link* prev{ nullptr };
+	auto chain = [&](Link node) {
+		if constexpr (back_links) {
+			if (prev)
+				address(node)->m_prev = *prev;
+		}
+		*end = std::move(node);
+		prev = end;
+		end = &address(*end)->m_next;
+	};
+
+	if constexpr (ListSerializer<T>::bulk) {
+		if (count) {
+			auto values{ list_serialization::read_bulk<T>(in, count) };
+
+			if constexpr (shared) {
+				auto arena{ NodeArena::create(compaction_block_size(static_cast<size_t>(count), sizeof(Node))) };
+				auto allocator{ with_upstream(node_allocator(), ArenaAllocator<Node>{ arena.get() }) };
+
+				for (uint64_t idx = 0; idx < count; ++idx)
+					chain(std::allocate_shared<Node>(allocator, values.get()[idx]));
+			}
+			else {
+				for (uint64_t idx = 0; idx < count; ++idx)
+					chain(loaded.create(values.get()[idx]));
+			}
+		}
+	}
+	else {
+		for (uint64_t idx = 0; idx < count; ++idx)
+			chain(loaded.create(ListSerializer<T>::read(in)));
+	}
+
+	if constexpr (track_tail) {
+		if (prev)
+			loaded.m_tail = *prev;
+	}
+	if constexpr (track_size)
+		loaded.m_size = static_cast<size_t>(count);
+
+	clear();
+	steal(loaded);
+}
+
+// Requires the list to be instantiated with a CountingAllocator.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+AllocationStats BasicList<T, Features, Traversal, Allocator, Instrumentation>::stats() const {
+
+	return node_allocator().stats();
+}
+
+// Both require the list to be instantiated with HistogramInstrumentation.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+const ListHistograms& BasicList<T, Features, Traversal, Allocator, Instrumentation>::histograms() const {
+
+	return instrumentation().histograms();
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::reset_histograms() {
+	instrumentation().reset();
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Link BasicList<T, Features, Traversal, Allocator, Instrumentation>::lock(const BackLink& link) noexcept {
+	if constexpr (shared)
+		return link.lock();
+	else
+		return link;
+}
+
+// Moves the element out of a node the list has let go of, or copies it if a
+// caller's handle can still see it.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+T BasicList<T, Features, Traversal, Allocator, Instrumentation>::release(Link& node) {
+	if constexpr (shared) {
+		if (node.use_count() > 1)
+			return node->m_data;
+	}
+
+	return std::move(address(node)->m_data);
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Link BasicList<T, Features, Traversal, Allocator, Instrumentation>::create(T data) {
+	if constexpr (shared)
+		return std::allocate_shared<Node>(node_allocator(), std::move(data));
+	else {
+		Node* node = NodeTraits::allocate(node_allocator(), 1);
+		try {
+			NodeTraits::construct(node_allocator(), node, std::move(data));
+		}
+		catch (...) {
+			NodeTraits::deallocate(node_allocator(), node, 1);
+			throw;
+		}
+
+		return node;
+	}
+}
+
+// Frees a node the list has unlinked; a shared node goes with its last handle.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::dispose(Link node) noexcept {
+	if constexpr (!shared) {
+		NodeTraits::destroy(node_allocator(), node);
+		NodeTraits::deallocate(node_allocator(), node, 1);
+	}
+}
+
+// The link to the last node, null for an empty list.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+const typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Link& BasicList<T, Features, Traversal, Allocator, Instrumentation>::last() const noexcept {
+	if constexpr (track_tail)
+		return this->m_tail;
+	else {
+		const Link* link{ &m_head };
+		while (*link && address(*link)->m_next)
+			link = &address(*link)->m_next;
+
+		return *link;
+	}
+}
+
+// Unlinks the node link points to, which follows the node prev points to
+// (nullptr for the head), and hands it to the caller.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+typename BasicList<T, Features, Traversal, Allocator, Instrumentation>::Link BasicList<T, Features, Traversal, Allocator, Instrumentation>::detach(Link& link, const Link* prev) noexcept {
+	Link node{ std::exchange(link, nullptr) };
+	Node* raw = address(node);
+
+	link = std::exchange(raw->m_next, nullptr);
+	if constexpr (back_links) {
+		if (link)
+			address(link)->m_prev = prev ? BackLink(*prev) : BackLink();
+		raw->m_prev = BackLink();
+	}
+	if constexpr (track_tail) {
+		if (!link)
+			this->m_tail = prev ? *prev : Link();
+	}
+
+	if constexpr (track_size)
+		--this->m_size;
+	if constexpr (compaction)
+		++this->m_generation;
+
+	return node;
+}
+
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::link_back(Link node) noexcept {
+	const Link& tail = last();
+	Node* previous = address(tail);
+
+	if constexpr (back_links)
+		address(node)->m_prev = tail;
+	if constexpr (track_tail)
+		this->m_tail = node;
+
+	(previous ? previous->m_next : m_head) = std::move(node);
+	if constexpr (track_size)
+		++this->m_size;
+}
+
+// The relocation loop of compact_step(); make builds the replacement node.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+template <typename Make>
+bool BasicList<T, Features, Traversal, Allocator, Instrumentation>::relocate(size_t budget, Make make) {
+	auto& cursor = this->m_compaction;
+
+	while (true) {
+		Link& link = cursor.prev ? cursor.prev->m_next : m_head;
+
+		if (!link) {
+			cursor = CompactionCursor<Node>{};
+			return true;
+		}
+
+		if (budget == 0)
+			return false;
+
+		bool held{ false };
+		if constexpr (shared) {
+			long owners{ 1 };
+			if constexpr (track_tail)
+				owners += link == this->m_tail ? 1 : 0;
+
+			// nodes a caller still holds a handle to stay where they are
+			held = link.use_count() != owners;
+		}
+
+		if (!held) {
+			Node* old = address(link);
+			Link node{ make(std::move(old->m_data)) };
+			Node* raw = address(node);
+
+			raw->m_next = std::exchange(old->m_next, nullptr);
+			if constexpr (back_links) {
+				raw->m_prev = old->m_prev;
+				if (raw->m_next)
+					address(raw->m_next)->m_prev = node;
+			}
+			if constexpr (track_tail) {
+				if (!raw->m_next)
+					this->m_tail = node;
+			}
+
+			dispose(std::exchange(link, std::move(node)));
+		}
+
+		cursor.prev = address(link);
+		++cursor.position;
+		--budget;
+	}
+}
+
+// Takes other's nodes, leaving it empty; the caller has emptied this list.
+template <typename T, typename Features, typename Traversal, typename Allocator, typename Instrumentation>
+void BasicList<T, Features, Traversal, Allocator, Instrumentation>::steal(BasicList& other) noexcept {
+	m_head = std::exchange(other.m_head, nullptr);
+	if constexpr (track_tail)
+		this->m_tail = std::exchange(other.m_tail, nullptr);
+	if constexpr (track_size)
+		this->m_size = std::exchange(other.m_size, 0);
+
+	if constexpr (compaction) {
+		++this->m_generation;
+		++other.m_generation;
+	}
+}
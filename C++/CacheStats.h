@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+// Hits, misses and evictions of one cache since it was created or last reset.
+// Every cache in the library reports through this shape, so their hit rates
+// can be compared on the same trace.
+struct CacheStats {
+	uint64_t hits{ 0 };
+	uint64_t misses{ 0 };
+	uint64_t insertions{ 0 };
+	uint64_t evictions{ 0 };
+
+	double hit_rate() const noexcept {
+		uint64_t lookups = hits + misses;
+		return lookups ? static_cast<double>(hits) / lookups : 0.0;
+	}
+};
@@ -0,0 +1,341 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <new>
+#include <utility>
+#include "BasicList.h"
+#include "NodePool.h"
+
+// Hash map with separate chaining: each bucket is a singly linked list of
+// key-value entries, and every bucket draws its nodes from one shared
+// Allocator, by default a PoolAllocator, so the map's nodes come from the
+// same free lists.
+//
+// The table doubles once the map holds more entries than buckets, but not
+// in one go as std::unordered_map does. Growing only reserves the larger
+// table; every later insert, erase or non-const find then moves rehash_step
+// buckets from the old table to the new one, splicing their nodes without
+// reallocating them. Until the old table is empty, each key is looked up in
+// whichever table owns its bucket at the time. No single operation pays for
+// the whole rehash, so insert latency stays flat as the map grows.
+//
+// Bucket counts are powers of two. The key's hash is mixed with a
+// multiplicative hash and its high bits pick the bucket, so identity hashes
+// of integers spread across the table, and old bucket i splits exactly into
+// new buckets 2i and 2i + 1; the new table's buckets are created as the old
+// ones are moved, not all when the rehash starts, and each old bucket is
+// destroyed once it is empty, so retiring the old table is not a pause of its
+// own either.
+//
+// A bucket is a BasicList without a count, a tail link, reference counted
+// nodes or compaction, none of which a chain needs: the map keeps its own
+// count, new entries go in at the front and rehashing moves nodes without
+// reallocating them. That leaves the head link, one pointer per bucket as in
+// std::unordered_map.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>,
+	typename Allocator = PoolAllocator<std::pair<K, V>>>
+class ChainedHashMap {
+public:
+	using Entry = std::pair<K, V>;
+
+	// Buckets moved to the new table per operation while a rehash is under way.
+	static constexpr size_t rehash_step{ 4 };
+	static constexpr size_t min_buckets{ 8 };
+private:
+	using Bucket = BasicList<Entry, ListFeatures<false, false, false, ExclusiveOwnership, false>, DirectTraversal, Allocator>;
+	using Node = typename Bucket::Node;
+
+	// 2^bits buckets in storage allocated up front, of which only those in
+	// [first, last) exist: a table being filled creates buckets at the back,
+	// one being emptied destroys them from the front.
+	class Table {
+	private:
+		Bucket* m_buckets{ nullptr };
+		size_t m_first{ 0 };
+		size_t m_last{ 0 };
+		unsigned m_bits{ 0 };
+
+		void release() noexcept;
+	public:
+		Table() {};
+		explicit Table(unsigned bits);
+		Table(Table&& other) noexcept;
+		Table& operator=(Table&& other) noexcept;
+		~Table() { release(); }
+
+		void emplace_back(const Allocator& allocator);
+		void destroy_front() noexcept;
+
+		Bucket& operator[](size_t idx) noexcept { return m_buckets[idx]; }
+		const Bucket& operator[](size_t idx) const noexcept { return m_buckets[idx]; }
+		size_t first() const noexcept { return m_first; }
+		size_t last() const noexcept { return m_last; }
+		size_t capacity() const noexcept { return m_buckets ? size_t{ 1 } << m_bits : 0; }
+		unsigned bits() const noexcept { return m_bits; }
+
+		size_t index(uint64_t hash) const noexcept {
+			return m_bits ? static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> (64 - m_bits)) : 0;
+		}
+	};
+
+	Allocator m_allocator;
+	Hash m_hash;
+	KeyEqual m_equal;
+	size_t m_size{ 0 };
+	Table m_table;
+	// the table being filled while a rehash is under way
+	Table m_next;
+	bool m_rehashing{ false };
+	// buckets of m_table below this index have been moved to m_next
+	size_t m_migrated{ 0 };
+
+	static unsigned bits_for(size_t buckets) noexcept;
+	void reset_table(unsigned bits);
+	Bucket& bucket_for(uint64_t hash);
+	const Bucket& bucket_for(uint64_t hash) const;
+	Node* find_node(const Bucket& bucket, const K& key) const;
+	void grow();
+	void migrate(size_t buckets);
+public:
+	explicit ChainedHashMap(size_t buckets = min_buckets, const Allocator& allocator = Allocator());
+	ChainedHashMap(const ChainedHashMap&) = delete;
+	ChainedHashMap& operator=(const ChainedHashMap&) = delete;
+
+	// Inserts key or replaces its value; returns true if key was new.
+	bool insert_or_assign(const K& key, V value);
+	V* find(const K& key);
+	const V* find(const K& key) const;
+	bool contains(const K& key) const { return find(key) != nullptr; }
+	bool erase(const K& key);
+	void clear();
+
+	// Calls visit(key, value) for every entry, in no particular order.
+	template <typename Visit>
+	void for_each(Visit visit) const;
+
+	size_t size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+	// Buckets in the table that owns new entries: the larger one mid-rehash.
+	size_t bucket_count() const noexcept { return rehashing() ? m_next.capacity() : m_table.capacity(); }
+	double load_factor() const noexcept { return static_cast<double>(m_size) / bucket_count(); }
+	bool rehashing() const noexcept { return m_rehashing; }
+	const Allocator& get_allocator() const noexcept { return m_allocator; }
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::ChainedHashMap(size_t buckets, const Allocator& allocator) :
+	m_allocator(allocator) {
+	reset_table(bits_for(buckets));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Table::Table(unsigned bits) :
+	m_buckets(std::allocator<Bucket>().allocate(size_t{ 1 } << bits)), m_bits(bits) {}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Table::Table(Table&& other) noexcept :
+	m_buckets(std::exchange(other.m_buckets, nullptr)), m_first(std::exchange(other.m_first, 0)),
+	m_last(std::exchange(other.m_last, 0)), m_bits(std::exchange(other.m_bits, 0)) {}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+typename ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Table&
+ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Table::operator=(Table&& other) noexcept {
+	if (this != &other) {
+		release();
+		m_buckets = std::exchange(other.m_buckets, nullptr);
+		m_first = std::exchange(other.m_first, 0);
+		m_last = std::exchange(other.m_last, 0);
+		m_bits = std::exchange(other.m_bits, 0);
+	}
+
+	return *this;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Table::release() noexcept {
+	if (!m_buckets)
+		return;
+
+	for (size_t idx = m_first; idx < m_last; ++idx)
+		m_buckets[idx].~Bucket();
+	std::allocator<Bucket>().deallocate(m_buckets, size_t{ 1 } << m_bits);
+
+	m_buckets = nullptr;
+	m_first = 0;
+	m_last = 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Table::emplace_back(const Allocator& allocator) {
+	::new (static_cast<void*>(m_buckets + m_last)) Bucket(allocator);
+	++m_last;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Table::destroy_front() noexcept {
+	m_buckets[m_first].~Bucket();
+	++m_first;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::reset_table(unsigned bits) {
+	m_table = Table(bits);
+	for (size_t idx = 0; idx < m_table.capacity(); ++idx)
+		m_table.emplace_back(m_allocator);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+unsigned ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::bits_for(size_t buckets) noexcept {
+	unsigned bits{ 0 };
+	while ((size_t{ 1 } << bits) < buckets || (size_t{ 1 } << bits) < min_buckets)
+		++bits;
+
+	return bits;
+}
+
+// The bucket that owns hash now: in the new table if the old table's bucket
+// for it has already been moved.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+typename ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Bucket&
+ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::bucket_for(uint64_t hash) {
+	size_t idx = m_table.index(hash);
+	if (rehashing() && idx < m_migrated)
+		return m_next[m_next.index(hash)];
+
+	return m_table[idx];
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+const typename ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Bucket&
+ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::bucket_for(uint64_t hash) const {
+	size_t idx = m_table.index(hash);
+	if (rehashing() && idx < m_migrated)
+		return m_next[m_next.index(hash)];
+
+	return m_table[idx];
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+typename ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::Node*
+ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::find_node(const Bucket& bucket, const K& key) const {
+	for (Node* node = bucket.front(); node; node = node->next_node())
+		if (m_equal(node->data().first, key))
+			return node;
+
+	return nullptr;
+}
+
+// Starts a rehash into a table twice the size. Only the new table's storage
+// is reserved here; its buckets are created by later operations as they move
+// the old ones over.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::grow() {
+	m_next = Table(m_table.bits() + 1);
+	m_rehashing = true;
+	m_migrated = 0;
+}
+
+// Moves up to count buckets from the old table into the pairs of buckets
+// they split into, and retires the old table once every bucket is moved.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::migrate(size_t count) {
+	if (!rehashing())
+		return;
+
+	for (; count > 0 && m_migrated < m_table.capacity(); --count, ++m_migrated) {
+		m_next.emplace_back(m_allocator);
+		m_next.emplace_back(m_allocator);
+
+		Bucket& from = m_table[m_migrated];
+		while (!from.empty()) {
+			uint64_t hash = static_cast<uint64_t>(m_hash(from.front()->data().first));
+			m_next[m_next.index(hash)].splice_back_after(from, nullptr);
+		}
+		m_table.destroy_front();
+	}
+
+	if (m_migrated == m_table.capacity()) {
+		m_table = std::move(m_next);
+		m_next = Table{};
+		m_rehashing = false;
+		m_migrated = 0;
+	}
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::insert_or_assign(const K& key, V value) {
+	migrate(rehash_step);
+
+	uint64_t hash = static_cast<uint64_t>(m_hash(key));
+	Bucket& bucket = bucket_for(hash);
+
+	if (Node* found = find_node(bucket, key)) {
+		found->data().second = std::move(value);
+		return false;
+	}
+
+	bucket.insert(0, Entry(key, std::move(value)));
+	++m_size;
+
+	if (!rehashing() && m_size > m_table.capacity())
+		grow();
+
+	return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+V* ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::find(const K& key) {
+	migrate(rehash_step);
+
+	Node* found = find_node(bucket_for(static_cast<uint64_t>(m_hash(key))), key);
+
+	return found ? &found->data().second : nullptr;
+}
+
+// Looks key up without moving any buckets.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+const V* ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::find(const K& key) const {
+	const Node* found = find_node(bucket_for(static_cast<uint64_t>(m_hash(key))), key);
+
+	return found ? &found->data().second : nullptr;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::erase(const K& key) {
+	migrate(rehash_step);
+
+	Bucket& bucket = bucket_for(static_cast<uint64_t>(m_hash(key)));
+	Node* prev{ nullptr };
+
+	for (auto node = bucket.front(); node; prev = node, node = node->next()) {
+		if (m_equal(node->data().first, key)) {
+			bucket.erase_after(prev);
+			--m_size;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Empties the map and drops back to the smallest table.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::clear() {
+	m_next = Table{};
+	m_rehashing = false;
+	m_migrated = 0;
+	reset_table(bits_for(min_buckets));
+	m_size = 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+template <typename Visit>
+void ChainedHashMap<K, V, Hash, KeyEqual, Allocator>::for_each(Visit visit) const {
+	for (const Table* table : { &m_table, &m_next })
+		for (size_t idx = table->first(); idx < table->last(); ++idx)
+			for (const Node* node = (*table)[idx].front(); node; node = node->next_node())
+				visit(node->data().first, node->data().second);
+}
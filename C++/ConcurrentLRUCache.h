@@ -0,0 +1,329 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "LRUCache.h"
+
+// Recency policies for ConcurrentLRUCache.
+//
+// With ExactRecency, the default, every hit takes its shard's lock and makes
+// the entry the most recent one straight away, exactly as LRUCache does.
+//
+// With BufferedRecency, hits take the shard's lock shared, so any number of
+// readers look up a shard at once, and note the key in a per-shard
+// AccessBuffer instead of promoting it. The buffer is replayed against the
+// recency list in one batch by whichever thread next holds the lock
+// exclusively: a reader once the buffer is half full (if the lock is free),
+// or any writer before it inserts or erases. The buffer is lossy; when a
+// slot is still occupied the access is dropped, so under heavy load the
+// eviction order only approximates LRU.
+
+// Bounded multi-producer, single-consumer buffer of recent accesses. Writers
+// never block: each claims the next slot and gives up if that slot has not
+// been drained yet. Only a thread holding the shard's exclusive lock drains.
+template <typename K, size_t Slots>
+class AccessBuffer {
+private:
+	enum State : uint8_t {
+		Empty,
+		Writing,
+		Full,
+	};
+
+	struct Slot {
+		std::atomic<uint8_t> state{ Empty };
+		std::optional<K> key;
+	};
+
+	std::array<Slot, Slots> m_slots;
+	std::atomic<size_t> m_next{ 0 };
+	std::atomic<size_t> m_pending{ 0 };
+	std::atomic<uint64_t> m_dropped{ 0 };
+public:
+	// Returns true once the buffer is worth draining.
+	bool record(const K& key);
+
+	// Calls promote(key) for every buffered access and returns how many there were.
+	template <typename Promote>
+	size_t drain(Promote promote);
+
+	uint64_t dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+};
+
+template <typename K, size_t Slots>
+bool AccessBuffer<K, Slots>::record(const K& key) {
+	Slot& slot = m_slots[m_next.fetch_add(1, std::memory_order_relaxed) % Slots];
+
+	uint8_t expected{ Empty };
+	if (!slot.state.compare_exchange_strong(expected, Writing, std::memory_order_acquire)) {
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	slot.key = key;
+	slot.state.store(Full, std::memory_order_release);
+
+	return m_pending.fetch_add(1, std::memory_order_relaxed) + 1 >= Slots / 2;
+}
+
+template <typename K, size_t Slots>
+template <typename Promote>
+size_t AccessBuffer<K, Slots>::drain(Promote promote) {
+	size_t drained{ 0 };
+
+	for (auto& slot : m_slots) {
+		if (slot.state.load(std::memory_order_acquire) != Full)
+			continue;
+
+		promote(*slot.key);
+		slot.state.store(Empty, std::memory_order_release);
+		++drained;
+	}
+
+	m_pending.fetch_sub(drained, std::memory_order_relaxed);
+
+	return drained;
+}
+
+struct ExactRecency {
+	static constexpr bool buffered{ false };
+
+	template <typename K>
+	struct Buffer {};
+};
+
+template <size_t Slots = 64>
+struct BufferedRecency {
+	static constexpr bool buffered{ true };
+
+	template <typename K>
+	using Buffer = AccessBuffer<K, Slots>;
+};
+
+// What one shard has seen. hits and misses are counted as lookups happen;
+// the buffered counts stay at 0 with ExactRecency.
+struct ShardStats {
+	CacheStats cache;
+	size_t size{ 0 };
+	size_t capacity{ 0 };
+	uint64_t buffered_promotions{ 0 };
+	uint64_t dropped_promotions{ 0 };
+	uint64_t drains{ 0 };
+};
+
+// LRU cache for many threads: keys are spread by hash over a power-of-two
+// number of shards, each an independently locked LRUCache with an equal share
+// of the capacity. Eviction is LRU within a shard, not across the cache.
+//
+// Each shard is allocated on its own and aligned to a cache line, so threads
+// working on different shards do not contend on the same line.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>,
+	typename Recency = ExactRecency, typename Allocator = PoolAllocator<std::pair<K, V>>>
+class ConcurrentLRUCache {
+private:
+	using Cache = LRUCache<K, V, Hash, KeyEqual, Allocator>;
+	using Mutex = std::conditional_t<Recency::buffered, std::shared_mutex, std::mutex>;
+
+	struct alignas(64) Shard {
+		mutable Mutex mutex;
+		Cache cache;
+		typename Recency::template Buffer<K> reads;
+		std::atomic<uint64_t> hits{ 0 };
+		std::atomic<uint64_t> misses{ 0 };
+		uint64_t buffered_promotions{ 0 };
+		uint64_t drains{ 0 };
+
+		Shard(size_t capacity) : cache(capacity) {};
+		// Caller holds the lock exclusively.
+		void drain();
+	};
+
+	size_t m_capacity;
+	size_t m_mask;
+	std::vector<std::unique_ptr<Shard>> m_shards;
+	Hash m_hash;
+
+	Shard& shard_for(const K& key) const;
+public:
+	// Four shards per hardware thread, rounded up to a power of two.
+	static size_t default_shards();
+
+	explicit ConcurrentLRUCache(size_t capacity, size_t shards = default_shards());
+	ConcurrentLRUCache(const ConcurrentLRUCache&) = delete;
+	ConcurrentLRUCache& operator=(const ConcurrentLRUCache&) = delete;
+
+	std::optional<V> get(const K& key);
+	void put(const K& key, V value);
+	bool erase(const K& key);
+	void clear();
+
+	size_t size() const;
+	size_t capacity() const noexcept { return m_capacity; }
+	size_t shard_count() const noexcept { return m_mask + 1; }
+
+	ShardStats shard_stats(size_t shard) const;
+	CacheStats stats() const;
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+void ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::Shard::drain() {
+	if constexpr (Recency::buffered) {
+		size_t drained = reads.drain([this](const K& key) { cache.promote(key); });
+		if (drained) {
+			buffered_promotions += drained;
+			++drains;
+		}
+	}
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+size_t ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::default_shards() {
+	size_t wanted = 4 * std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	size_t shards{ 1 };
+	while (shards < wanted)
+		shards <<= 1;
+
+	return shards;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::ConcurrentLRUCache(size_t capacity, size_t shards) :
+	m_capacity(capacity) {
+	if (shards == 0 || (shards & (shards - 1)) != 0)
+		throw std::invalid_argument("ConcurrentLRUCache shard count must be a power of two");
+	if (capacity < shards)
+		throw std::invalid_argument("ConcurrentLRUCache capacity must be at least the shard count");
+
+	m_mask = shards - 1;
+
+	// the first capacity % shards shards take one entry more than the rest
+	m_shards.reserve(shards);
+	for (size_t idx = 0; idx < shards; ++idx)
+		m_shards.push_back(std::make_unique<Shard>(capacity / shards + (idx < capacity % shards ? 1 : 0)));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+typename ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::Shard&
+ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::shard_for(const K& key) const {
+	// std::hash is the identity for integers on common standard libraries, so
+	// the hash is mixed before its high bits pick the shard.
+	uint64_t hash = static_cast<uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ull;
+
+	return *m_shards[(hash >> 32) & m_mask];
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+std::optional<V> ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::get(const K& key) {
+	Shard& shard = shard_for(key);
+	std::optional<V> value;
+
+	if constexpr (Recency::buffered) {
+		{
+			std::shared_lock<Mutex> lock(shard.mutex);
+			value = shard.cache.peek(key);
+		}
+
+		if (value && shard.reads.record(key)) {
+			std::unique_lock<Mutex> lock(shard.mutex, std::try_to_lock);
+			if (lock)
+				shard.drain();
+		}
+	}
+	else {
+		std::lock_guard<Mutex> lock(shard.mutex);
+		value = shard.cache.get(key);
+	}
+
+	(value ? shard.hits : shard.misses).fetch_add(1, std::memory_order_relaxed);
+
+	return value;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+void ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::put(const K& key, V value) {
+	Shard& shard = shard_for(key);
+	std::lock_guard<Mutex> lock(shard.mutex);
+
+	shard.drain();
+	shard.cache.put(key, std::move(value));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+bool ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::erase(const K& key) {
+	Shard& shard = shard_for(key);
+	std::lock_guard<Mutex> lock(shard.mutex);
+
+	shard.drain();
+	return shard.cache.erase(key);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+void ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::clear() {
+	for (size_t idx = 0; idx <= m_mask; ++idx) {
+		Shard& shard = *m_shards[idx];
+		std::lock_guard<Mutex> lock(shard.mutex);
+		shard.drain();
+		shard.cache.clear();
+	}
+}
+
+// Sum of the shard sizes, each taken under its own lock; not a snapshot of
+// the whole cache at one moment while other threads are writing.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+size_t ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::size() const {
+	size_t total{ 0 };
+	for (size_t idx = 0; idx <= m_mask; ++idx) {
+		std::lock_guard<Mutex> lock(m_shards[idx]->mutex);
+		total += m_shards[idx]->cache.size();
+	}
+
+	return total;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+ShardStats ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::shard_stats(size_t shard) const {
+	if (shard > m_mask)
+		throw std::out_of_range("ConcurrentLRUCache shard out of range");
+
+	const Shard& selected = *m_shards[shard];
+	std::lock_guard<Mutex> lock(selected.mutex);
+
+	ShardStats stats;
+	stats.cache = selected.cache.stats();
+	stats.cache.hits = selected.hits.load(std::memory_order_relaxed);
+	stats.cache.misses = selected.misses.load(std::memory_order_relaxed);
+	stats.size = selected.cache.size();
+	stats.capacity = selected.cache.capacity();
+	stats.buffered_promotions = selected.buffered_promotions;
+	stats.drains = selected.drains;
+	if constexpr (Recency::buffered)
+		stats.dropped_promotions = selected.reads.dropped();
+
+	return stats;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Recency, typename Allocator>
+CacheStats ConcurrentLRUCache<K, V, Hash, KeyEqual, Recency, Allocator>::stats() const {
+	CacheStats total;
+	for (size_t idx = 0; idx <= m_mask; ++idx) {
+		CacheStats shard = shard_stats(idx).cache;
+		total.hits += shard.hits;
+		total.misses += shard.misses;
+		total.insertions += shard.insertions;
+		total.evictions += shard.evictions;
+	}
+
+	return total;
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Snapshot of what one container has allocated through its CountingAllocator.
+// A list node and its shared_ptr control block are a single allocation, so
+// live_nodes is the number of nodes currently alive.
+struct AllocationStats {
+	size_t allocations{ 0 };
+	size_t frees{ 0 };
+	size_t live_nodes{ 0 };
+	size_t live_bytes{ 0 };
+	size_t peak_bytes{ 0 };
+};
+
+// Counters shared by a CountingAllocator and every copy and rebind of it.
+//
+// Each copy holds one reference. Nodes keep a copy of the allocator in their
+// control block, so the counters stay valid until the container and the last
+// node handed out by it are both gone.
+class AllocationTracker {
+private:
+	std::atomic<size_t> m_allocations{ 0 };
+	std::atomic<size_t> m_frees{ 0 };
+	std::atomic<size_t> m_live_bytes{ 0 };
+	std::atomic<size_t> m_peak_bytes{ 0 };
+	std::atomic<size_t> m_references{ 1 };
+
+	AllocationTracker() = default;
+	~AllocationTracker() = default;
+public:
+	AllocationTracker(const AllocationTracker&) = delete;
+	AllocationTracker& operator=(const AllocationTracker&) = delete;
+
+	static AllocationTracker* create() { return new AllocationTracker(); }
+
+	void reference() noexcept;
+	void unreference() noexcept;
+	void record_allocation(size_t bytes) noexcept;
+	void record_free(size_t bytes) noexcept;
+	AllocationStats stats() const noexcept;
+};
+
+inline void AllocationTracker::reference() noexcept {
+	m_references.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void AllocationTracker::unreference() noexcept {
+	if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete this;
+}
+
+inline void AllocationTracker::record_allocation(size_t bytes) noexcept {
+	m_allocations.fetch_add(1, std::memory_order_relaxed);
+	size_t live = m_live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+	size_t peak = m_peak_bytes.load(std::memory_order_relaxed);
+	while (live > peak && !m_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+inline void AllocationTracker::record_free(size_t bytes) noexcept {
+	m_frees.fetch_add(1, std::memory_order_relaxed);
+	m_live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+inline AllocationStats AllocationTracker::stats() const noexcept {
+	AllocationStats stats;
+	stats.allocations = m_allocations.load(std::memory_order_relaxed);
+	stats.frees = m_frees.load(std::memory_order_relaxed);
+	stats.live_nodes = stats.allocations - stats.frees;
+	stats.live_bytes = m_live_bytes.load(std::memory_order_relaxed);
+	stats.peak_bytes = m_peak_bytes.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+// Standard allocator that forwards to Upstream and counts every allocation
+// and free. A default-constructed CountingAllocator starts a fresh set of
+// counters, so each container instantiated with it reports only its own
+// nodes through stats().
+//
+// The counting is opt-in per container type: lists use std::allocator unless
+// given a CountingAllocator, and then allocate exactly as make_shared would.
+template <typename T, typename Upstream = std::allocator<T>>
+class CountingAllocator {
+	template <typename U, typename V>
+	friend class CountingAllocator;
+private:
+	AllocationTracker* m_tracker;
+	Upstream m_upstream;
+
+	using UpstreamTraits = std::allocator_traits<Upstream>;
+public:
+	using value_type = T;
+
+	template <typename U>
+	struct rebind {
+		using other = CountingAllocator<U, typename UpstreamTraits::template rebind_alloc<U>>;
+	};
+
+	CountingAllocator() : m_tracker(AllocationTracker::create()) {};
+
+	CountingAllocator(AllocationTracker* tracker, Upstream upstream) noexcept :
+		m_tracker(tracker), m_upstream(std::move(upstream)) {
+		m_tracker->reference();
+	}
+
+	CountingAllocator(const CountingAllocator& other) noexcept :
+		m_tracker(other.m_tracker), m_upstream(other.m_upstream) {
+		m_tracker->reference();
+	}
+
+	template <typename U, typename V>
+	CountingAllocator(const CountingAllocator<U, V>& other) noexcept :
+		m_tracker(other.m_tracker), m_upstream(other.m_upstream) {
+		m_tracker->reference();
+	}
+
+	CountingAllocator& operator=(const CountingAllocator& other) noexcept {
+		other.m_tracker->reference();
+		m_tracker->unreference();
+		m_tracker = other.m_tracker;
+		m_upstream = other.m_upstream;
+
+		return *this;
+	}
+
+	~CountingAllocator() {
+		m_tracker->unreference();
+	}
+
+	T* allocate(size_t count) {
+		T* address = UpstreamTraits::allocate(m_upstream, count);
+		m_tracker->record_allocation(count * sizeof(T));
+
+		return address;
+	}
+
+	void deallocate(T* address, size_t count) noexcept {
+		UpstreamTraits::deallocate(m_upstream, address, count);
+		m_tracker->record_free(count * sizeof(T));
+	}
+
+	AllocationStats stats() const noexcept { return m_tracker->stats(); }
+	AllocationTracker* tracker() const noexcept { return m_tracker; }
+
+	template <typename U, typename V>
+	bool operator==(const CountingAllocator<U, V>& other) const noexcept {
+		return m_tracker == other.m_tracker && m_upstream == other.m_upstream;
+	}
+
+	template <typename U, typename V>
+	bool operator!=(const CountingAllocator<U, V>& other) const noexcept {
+		return !(*this == other);
+	}
+};
+
+// Allocator drawing from upstream that counts into the same tracker as
+// allocator, so nodes a list relocates into a compaction arena stay counted.
+// An allocator that does not count just gives back upstream.
+template <typename Allocator, typename Upstream>
+Upstream with_upstream(const Allocator&, Upstream upstream) {
+
+	return upstream;
+}
+
+template <typename T, typename Previous, typename Upstream>
+CountingAllocator<typename Upstream::value_type, Upstream> with_upstream(
+	const CountingAllocator<T, Previous>& allocator, Upstream upstream) {
+
+	return { allocator.tracker(), std::move(upstream) };
+}
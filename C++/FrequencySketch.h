@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Approximate access counts for an admission policy: a count-min sketch of
+// four rows of 4-bit counters, which saturate at 15.
+//
+// A key's hash picks one counter in each row; increment() bumps all four and
+// estimate() returns the smallest, which overestimates only when every row
+// collides. Each row has a power-of-two number of counters, at least four
+// per entry the sketch was sized for, so it takes about 8 bytes per entry.
+//
+// Once the sketch has counted ten accesses per entry it halves every
+// counter, so frequencies age and keys that were popular long ago lose out
+// to keys that are popular now.
+class FrequencySketch {
+public:
+	static constexpr size_t depth{ 4 };
+	static constexpr uint8_t max_count{ 15 };
+private:
+	// two counters to a byte, rows one after another
+	std::vector<uint8_t> m_table;
+	size_t m_width;
+	size_t m_additions{ 0 };
+	size_t m_sample_size;
+
+	size_t index(uint64_t hash, size_t row) const noexcept;
+	uint8_t counter(size_t idx) const noexcept;
+	void halve() noexcept;
+public:
+	explicit FrequencySketch(size_t capacity);
+
+	// Counts one access to the key with this hash.
+	void increment(uint64_t hash) noexcept;
+	uint8_t estimate(uint64_t hash) const noexcept;
+	void clear() noexcept;
+
+	size_t width() const noexcept { return m_width; }
+	size_t additions() const noexcept { return m_additions; }
+	size_t sample_size() const noexcept { return m_sample_size; }
+};
+
+inline FrequencySketch::FrequencySketch(size_t capacity) : m_width(16) {
+	while (m_width < 4 * capacity)
+		m_width <<= 1;
+
+	m_table.assign(depth * m_width / 2, 0);
+	m_sample_size = 10 * (m_width / 4);
+}
+
+// Counter for hash in row: the hash is multiplied by an odd constant per row
+// and its high bits kept, so the rows disagree on which keys collide.
+inline size_t FrequencySketch::index(uint64_t hash, size_t row) const noexcept {
+	static constexpr uint64_t seeds[depth]{
+		0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull,
+	};
+
+	uint64_t mixed = hash * seeds[row];
+	mixed ^= mixed >> 29;
+
+	return row * m_width + ((mixed >> 32) & (m_width - 1));
+}
+
+inline uint8_t FrequencySketch::counter(size_t idx) const noexcept {
+
+	return (m_table[idx / 2] >> (idx % 2 * 4)) & 0x0F;
+}
+
+inline void FrequencySketch::increment(uint64_t hash) noexcept {
+	for (size_t row = 0; row < depth; ++row) {
+		size_t idx = index(hash, row);
+		if (counter(idx) < max_count)
+			m_table[idx / 2] += static_cast<uint8_t>(1u << (idx % 2 * 4));
+	}
+
+	if (++m_additions == m_sample_size)
+		halve();
+}
+
+inline uint8_t FrequencySketch::estimate(uint64_t hash) const noexcept {
+	uint8_t lowest{ max_count };
+	for (size_t row = 0; row < depth; ++row) {
+		uint8_t count = counter(index(hash, row));
+		if (count < lowest)
+			lowest = count;
+	}
+
+	return lowest;
+}
+
+inline void FrequencySketch::halve() noexcept {
+	// shifting the byte right halves both counters; the mask drops the bit the
+	// high counter shifts into the low one
+	for (auto& pair : m_table)
+		pair = (pair >> 1) & 0x77;
+
+	m_additions /= 2;
+}
+
+inline void FrequencySketch::clear() noexcept {
+	m_table.assign(m_table.size(), 0);
+	m_additions = 0;
+}
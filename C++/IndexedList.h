@@ -0,0 +1,327 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Singly linked list whose nodes live in one contiguous vector and link to
+// each other by 32-bit slot index instead of by pointer. Unlinked slots are
+// threaded onto a free list and recycled by later appends and inserts; a
+// freed slot is reset to T() so it does not keep resources alive, which needs
+// T to be default constructible.
+//
+// Growing the pool may move the nodes, so references to elements are only
+// stable until the next append or insert.
+template <typename T>
+class IndexedList {
+public:
+	class Node;
+	class Iterator;
+
+	static constexpr uint32_t npos{ UINT32_MAX };
+private:
+	std::vector<Node> m_nodes;
+	size_t m_size{ 0 };
+	uint32_t m_head{ npos };
+	uint32_t m_tail{ npos };
+	uint32_t m_free{ npos };
+
+	uint32_t allocate(T data);
+	void release(uint32_t slot);
+	uint32_t unlink(uint32_t prev, uint32_t current);
+public:
+	IndexedList() {};
+	IndexedList(T arr[], int size);
+
+	Iterator begin();
+	Iterator end();
+
+	void append(T data);
+	void insert(int index, T data);
+	T pop(std::optional<size_t> index = std::nullopt);
+	void remove(T data);
+	void remove_all(T data);
+	T index(size_t index);
+	int count(T data);
+	void clear();
+	size_t size();
+	size_t capacity() const;
+	void reserve(size_t capacity);
+	T& front();
+	T& back();
+};
+
+template <typename T>
+IndexedList<T>::IndexedList(T arr[], int size) {
+	reserve(size);
+	for (auto idx = 0; idx < size; ++idx)
+		append(arr[idx]);
+}
+
+template <typename T>
+class IndexedList<T>::Node {
+	friend class IndexedList;
+private:
+	T m_data;
+	uint32_t m_next{ npos };
+public:
+	Node(T value) : m_data(value) {};
+	T& data() { return m_data; }
+	uint32_t next() const { return m_next; }
+};
+
+template <typename T>
+class IndexedList<T>::Iterator {
+public:
+	std::vector<Node>* m_nodes{ nullptr };
+	uint32_t m_current{ npos };
+	Iterator(std::vector<Node>* nodes, uint32_t slot) noexcept : m_nodes(nodes), m_current(slot) {};
+
+	// prefix operator
+	IndexedList<T>::Iterator& operator++() {
+		if (m_current != npos)
+			m_current = (*m_nodes)[m_current].m_next;
+
+		return *this;
+	};
+
+	// postfix operator
+	IndexedList<T>::Iterator operator++(int) {
+
+		Iterator iterator = *this;
+		++* this;
+
+		return iterator;
+	}
+
+	bool operator!=(const IndexedList<T>::Iterator& iterator) const {
+		return m_current != iterator.m_current;
+	}
+
+	T& operator*() {
+		return (*m_nodes)[m_current].m_data;
+	}
+};
+
+template <typename T>
+typename IndexedList<T>::Iterator IndexedList<T>::begin() {
+
+	return Iterator(&m_nodes, m_head);
+}
+
+template <typename T>
+typename IndexedList<T>::Iterator IndexedList<T>::end() {
+
+	return Iterator(&m_nodes, npos);
+}
+
+// Takes a slot from the free list, or grows the pool when it is empty.
+template <typename T>
+uint32_t IndexedList<T>::allocate(T data) {
+	if (m_free != npos) {
+		uint32_t slot = m_free;
+		m_free = m_nodes[slot].m_next;
+		m_nodes[slot].m_data = std::move(data);
+		m_nodes[slot].m_next = npos;
+
+		return slot;
+	}
+
+	if (m_nodes.size() >= npos)
+		throw std::length_error("IndexedList is limited to 2^32 - 1 nodes");
+
+	m_nodes.emplace_back(std::move(data));
+
+	return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+template <typename T>
+void IndexedList<T>::release(uint32_t slot) {
+	m_nodes[slot].m_data = T();
+	m_nodes[slot].m_next = m_free;
+	m_free = slot;
+}
+
+// Unlinks current, whose predecessor is prev (npos for the head), and returns
+// the slot that followed it.
+template <typename T>
+uint32_t IndexedList<T>::unlink(uint32_t prev, uint32_t current) {
+	uint32_t next = m_nodes[current].m_next;
+
+	if (prev == npos)
+		m_head = next;
+	else
+		m_nodes[prev].m_next = next;
+
+	if (current == m_tail)
+		m_tail = prev;
+
+	release(current);
+	--m_size;
+
+	return next;
+}
+
+template <typename T>
+void IndexedList<T>::append(T data) {
+	uint32_t slot = allocate(std::move(data));
+
+	if (m_head == npos)
+		m_head = slot;
+	else
+		m_nodes[m_tail].m_next = slot;
+
+	m_tail = slot;
+	++m_size;
+}
+
+// Inserts data before the element at index; an index at or past the end, or
+// negative, appends it, as SinglyLinkedList does.
+template <typename T>
+void IndexedList<T>::insert(int index, T data) {
+	if (index < 0 || static_cast<size_t>(index) >= m_size) {
+		append(std::move(data));
+		return;
+	}
+
+	if (index == 0) {
+		uint32_t slot = allocate(std::move(data));
+		m_nodes[slot].m_next = m_head;
+		m_head = slot;
+
+		++m_size;
+		return;
+	}
+
+	uint32_t prev = m_head;
+	for (int position = 1; position < index; ++position)
+		prev = m_nodes[prev].m_next;
+
+	uint32_t slot = allocate(std::move(data));
+	m_nodes[slot].m_next = m_nodes[prev].m_next;
+	m_nodes[prev].m_next = slot;
+
+	++m_size;
+}
+
+template <typename T>
+T IndexedList<T>::pop(std::optional<size_t> index) {
+	if (m_size == 0)
+		throw std::out_of_range("pop from empty IndexedList");
+
+	size_t target = index.value_or(m_size - 1);
+	if (target >= m_size)
+		throw std::out_of_range("IndexedList index out of range");
+
+	uint32_t prev = npos;
+	uint32_t current = m_head;
+	for (size_t position = 0; position < target; ++position) {
+		prev = current;
+		current = m_nodes[current].m_next;
+	}
+
+	T data = std::move(m_nodes[current].m_data);
+	unlink(prev, current);
+
+	return data;
+}
+
+template <typename T>
+void IndexedList<T>::remove(T data) {
+	uint32_t prev = npos;
+	uint32_t current = m_head;
+
+	while (current != npos) {
+		if (m_nodes[current].m_data == data) {
+			unlink(prev, current);
+			return;
+		}
+
+		prev = current;
+		current = m_nodes[current].m_next;
+	}
+}
+
+template <typename T>
+void IndexedList<T>::remove_all(T data) {
+	uint32_t prev = npos;
+	uint32_t current = m_head;
+
+	while (current != npos) {
+		if (m_nodes[current].m_data == data) {
+			current = unlink(prev, current);
+			continue;
+		}
+
+		prev = current;
+		current = m_nodes[current].m_next;
+	}
+}
+
+template <typename T>
+T IndexedList<T>::index(size_t index) {
+	if (index >= m_size)
+		throw std::out_of_range("IndexedList index out of range");
+
+	uint32_t current = m_head;
+	for (size_t position = 0; position < index; ++position)
+		current = m_nodes[current].m_next;
+
+	return m_nodes[current].m_data;
+}
+
+template <typename T>
+int IndexedList<T>::count(T data) {
+	int cnt{ 0 };
+
+	for (uint32_t current = m_head; current != npos; current = m_nodes[current].m_next) {
+		if (m_nodes[current].m_data == data)
+			++cnt;
+	}
+
+	return cnt;
+}
+
+template <typename T>
+void IndexedList<T>::clear() {
+	m_nodes.clear();
+	m_head = npos;
+	m_tail = npos;
+	m_free = npos;
+	m_size = 0;
+}
+
+template <typename T>
+size_t IndexedList<T>::size() {
+
+	return m_size;
+}
+
+template <typename T>
+size_t IndexedList<T>::capacity() const {
+
+	return m_nodes.capacity();
+}
+
+template <typename T>
+void IndexedList<T>::reserve(size_t capacity) {
+
+	m_nodes.reserve(capacity);
+}
+
+template <typename T>
+T& IndexedList<T>::front() {
+	if (m_head == npos)
+		throw std::out_of_range("front of empty IndexedList");
+
+	return m_nodes[m_head].m_data;
+}
+
+template <typename T>
+T& IndexedList<T>::back() {
+	if (m_tail == npos)
+		throw std::out_of_range("back of empty IndexedList");
+
+	return m_nodes[m_tail].m_data;
+}
@@ -0,0 +1,200 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Instrumentation policies for the linked lists.
+//
+// Every operation that walks the list (insert, pop, remove, remove_all,
+// index and count) opens a Probe when it starts and calls visit() each time
+// its cursor moves one node forward; the probe records when it goes out of
+// scope. With NoInstrumentation, the default, the probe is empty and the
+// calls compile away.
+
+// Index of the highest set bit; value must not be zero.
+inline unsigned highest_bit(uint64_t value) noexcept {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return static_cast<unsigned>(index);
+#else
+	return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+// Log-linear histogram in the style of HdrHistogram. A value is bucketed by
+// its highest set bit and the sub_bucket_bits bits below it, so anything
+// from 0 to 2^64 - 1 is kept to within 1/16 of its size in a fixed 976
+// counters. Values below 16 are exact.
+class Histogram {
+public:
+	static constexpr unsigned sub_bucket_bits{ 4 };
+	static constexpr size_t sub_buckets{ size_t{ 1 } << sub_bucket_bits };
+	static constexpr size_t bucket_count{ (64 - sub_bucket_bits + 1) * sub_buckets };
+private:
+	std::array<uint64_t, bucket_count> m_counts{};
+	uint64_t m_count{ 0 };
+	uint64_t m_sum{ 0 };
+	uint64_t m_min{ UINT64_MAX };
+	uint64_t m_max{ 0 };
+
+	static size_t bucket_of(uint64_t value) noexcept;
+	static uint64_t highest_in(size_t bucket) noexcept;
+public:
+	void record(uint64_t value) noexcept;
+	void reset() noexcept;
+
+	uint64_t count() const noexcept { return m_count; }
+	uint64_t min() const noexcept { return m_count ? m_min : 0; }
+	uint64_t max() const noexcept { return m_max; }
+	double mean() const noexcept;
+	uint64_t percentile(double percent) const noexcept;
+};
+
+inline size_t Histogram::bucket_of(uint64_t value) noexcept {
+	if (value < sub_buckets)
+		return static_cast<size_t>(value);
+
+	unsigned shift = highest_bit(value) - sub_bucket_bits;
+	size_t group = shift + 1;
+
+	return group * sub_buckets + static_cast<size_t>((value >> shift) - sub_buckets);
+}
+
+inline uint64_t Histogram::highest_in(size_t bucket) noexcept {
+	size_t group = bucket / sub_buckets;
+	uint64_t sub_bucket = bucket % sub_buckets;
+
+	if (group == 0)
+		return sub_bucket;
+
+	unsigned shift = static_cast<unsigned>(group - 1);
+	return ((sub_buckets + sub_bucket) << shift) + ((uint64_t{ 1 } << shift) - 1);
+}
+
+inline void Histogram::record(uint64_t value) noexcept {
+	++m_counts[bucket_of(value)];
+	++m_count;
+	m_sum += value;
+
+	if (value < m_min)
+		m_min = value;
+	if (value > m_max)
+		m_max = value;
+}
+
+inline void Histogram::reset() noexcept {
+	*this = Histogram{};
+}
+
+inline double Histogram::mean() const noexcept {
+
+	return m_count ? static_cast<double>(m_sum) / m_count : 0.0;
+}
+
+// Smallest recorded bucket bound that at least percent of the values fall
+// under, clamped to the largest value seen.
+inline uint64_t Histogram::percentile(double percent) const noexcept {
+	if (m_count == 0)
+		return 0;
+
+	double wanted = percent / 100.0 * m_count;
+	uint64_t target = wanted < 1.0 ? 1 : static_cast<uint64_t>(wanted + 0.5);
+	uint64_t seen{ 0 };
+
+	for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+		seen += m_counts[bucket];
+		if (seen >= target) {
+			uint64_t bound = highest_in(bucket);
+			return bound < m_max ? bound : m_max;
+		}
+	}
+
+	return m_max;
+}
+
+enum class ListOperation : size_t {
+	Insert,
+	Pop,
+	Remove,
+	RemoveAll,
+	Index,
+	Count,
+};
+
+constexpr size_t list_operation_count{ 6 };
+
+struct OperationHistograms {
+	Histogram latency_ns;
+	Histogram nodes_visited;
+};
+
+// One pair of histograms per walking operation.
+class ListHistograms {
+private:
+	std::array<OperationHistograms, list_operation_count> m_operations{};
+public:
+	OperationHistograms& operator[](ListOperation operation) noexcept {
+		return m_operations[static_cast<size_t>(operation)];
+	}
+
+	const OperationHistograms& operator[](ListOperation operation) const noexcept {
+		return m_operations[static_cast<size_t>(operation)];
+	}
+
+	void reset() noexcept {
+		for (auto& operation : m_operations) {
+			operation.latency_ns.reset();
+			operation.nodes_visited.reset();
+		}
+	}
+};
+
+// Records nothing.
+struct NoInstrumentation {
+	class Probe {
+	public:
+		void visit() noexcept {};
+	};
+
+	Probe probe(ListOperation) noexcept { return {}; }
+};
+
+// Records, for every walking operation, the nodes it visited and how long it
+// took. The histograms live inside the list (about 90 KB), so this is meant
+// for profiling builds and long-lived lists rather than many small ones.
+class HistogramInstrumentation {
+private:
+	ListHistograms m_histograms;
+public:
+	class Probe {
+	private:
+		OperationHistograms& m_target;
+		uint64_t m_visited{ 0 };
+		std::chrono::steady_clock::time_point m_start;
+	public:
+		explicit Probe(OperationHistograms& target) noexcept :
+			m_target(target), m_start(std::chrono::steady_clock::now()) {};
+		Probe(const Probe&) = delete;
+		Probe& operator=(const Probe&) = delete;
+
+		~Probe() {
+			auto elapsed = std::chrono::steady_clock::now() - m_start;
+			m_target.latency_ns.record(static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+			m_target.nodes_visited.record(m_visited);
+		}
+
+		void visit() noexcept { ++m_visited; };
+	};
+
+	Probe probe(ListOperation operation) noexcept { return Probe(m_histograms[operation]); }
+
+	const ListHistograms& histograms() const noexcept { return m_histograms; }
+	void reset() noexcept { m_histograms.reset(); }
+};
@@ -0,0 +1,498 @@
+#pragma once
+#include <stdexcept>
+
+// Intrusive lists: instead of copying values into list-owned nodes, the user
+// type derives from a hook and the list links existing objects together.
+// Linking and unlinking never allocate, and the list never owns or destroys
+// the objects it links.
+//
+// The Tag parameter lets one object sit in several lists at once, one hook
+// base per list:
+//
+//	struct Task : DoublyListHook<struct ReadyTag>, DoublyListHook<struct AllTag> { ... };
+//	IntrusiveDoublyLinkedList<Task, ReadyTag> ready;
+//	IntrusiveDoublyLinkedList<Task, AllTag> all;
+
+template <typename T, typename Tag>
+class IntrusiveSinglyLinkedList;
+
+template <typename T, typename Tag>
+class IntrusiveDoublyLinkedList;
+
+// Singly linked hook. A linked hook's m_next is never null, the last one in a
+// list links to itself, so the hook knows whether it is linked. It cannot
+// unlink itself without its predecessor, though, so unlike DoublyListHook it
+// does nothing when the object is destroyed: remove a linked object from its
+// list first, or the list is left pointing at freed memory.
+template <typename Tag = void>
+class SinglyListHook {
+	template <typename, typename>
+	friend class IntrusiveSinglyLinkedList;
+private:
+	SinglyListHook* m_next{ nullptr };
+public:
+	SinglyListHook() noexcept {};
+	SinglyListHook(const SinglyListHook&) noexcept {};
+	SinglyListHook& operator=(const SinglyListHook&) noexcept { return *this; }
+
+	bool is_linked() const noexcept { return m_next != nullptr; }
+};
+
+// Doubly linked hook. It can unlink itself in O(1) without the list, and it
+// does so automatically when the object is destroyed. Because of that the
+// list does not cache its size.
+template <typename Tag = void>
+class DoublyListHook {
+	template <typename, typename>
+	friend class IntrusiveDoublyLinkedList;
+private:
+	DoublyListHook* m_prev{ nullptr };
+	DoublyListHook* m_next{ nullptr };
+public:
+	DoublyListHook() noexcept {};
+	DoublyListHook(const DoublyListHook&) noexcept {};
+	DoublyListHook& operator=(const DoublyListHook&) noexcept { return *this; }
+	~DoublyListHook() { unlink(); }
+
+	bool is_linked() const noexcept { return m_next != nullptr; }
+	void unlink() noexcept;
+};
+
+template <typename Tag>
+void DoublyListHook<Tag>::unlink() noexcept {
+	if (!is_linked())
+		return;
+
+	m_prev->m_next = m_next;
+	m_next->m_prev = m_prev;
+	m_prev = nullptr;
+	m_next = nullptr;
+}
+
+template <typename T, typename Tag = void>
+class IntrusiveSinglyLinkedList {
+	using Hook = SinglyListHook<Tag>;
+public:
+	class Iterator;
+private:
+	size_t m_size{ 0 };
+	Hook* m_head{ nullptr };
+	Hook* m_tail{ nullptr };
+
+	static T& object(Hook* hook) noexcept { return *static_cast<T*>(hook); }
+	static Hook* next(const Hook* hook) noexcept { return hook->m_next == hook ? nullptr : hook->m_next; }
+	static Hook* check_unlinked(T& item);
+public:
+	IntrusiveSinglyLinkedList() {};
+	IntrusiveSinglyLinkedList(const IntrusiveSinglyLinkedList&) = delete;
+	IntrusiveSinglyLinkedList& operator=(const IntrusiveSinglyLinkedList&) = delete;
+	~IntrusiveSinglyLinkedList();
+
+	Iterator begin();
+	Iterator end();
+
+	void append(T& item);
+	void prepend(T& item);
+	T& pop_front();
+	bool remove(T& item);
+	T& front();
+	T& back();
+	void clear();
+	size_t size() const;
+};
+
+template <typename T, typename Tag>
+class IntrusiveSinglyLinkedList<T, Tag>::Iterator {
+public:
+	Hook* m_current{ nullptr };
+	Iterator(Hook* hook) noexcept : m_current(hook) {};
+
+	// prefix operator
+	IntrusiveSinglyLinkedList<T, Tag>::Iterator& operator++() {
+		if (m_current)
+			m_current = IntrusiveSinglyLinkedList<T, Tag>::next(m_current);
+
+		return *this;
+	};
+
+	// postfix operator
+	IntrusiveSinglyLinkedList<T, Tag>::Iterator operator++(int) {
+
+		Iterator iterator = *this;
+		++* this;
+
+		return iterator;
+	}
+
+	bool operator!=(const IntrusiveSinglyLinkedList<T, Tag>::Iterator& iterator) const {
+		return m_current != iterator.m_current;
+	}
+
+	T& operator*() {
+		return IntrusiveSinglyLinkedList<T, Tag>::object(m_current);
+	}
+};
+
+// Unlinks the objects still in the list so that they can join another one.
+template <typename T, typename Tag>
+IntrusiveSinglyLinkedList<T, Tag>::~IntrusiveSinglyLinkedList() {
+	clear();
+}
+
+template <typename T, typename Tag>
+typename IntrusiveSinglyLinkedList<T, Tag>::Iterator IntrusiveSinglyLinkedList<T, Tag>::begin() {
+
+	return Iterator(m_head);
+}
+
+template <typename T, typename Tag>
+typename IntrusiveSinglyLinkedList<T, Tag>::Iterator IntrusiveSinglyLinkedList<T, Tag>::end() {
+
+	return Iterator(nullptr);
+}
+
+template <typename T, typename Tag>
+typename IntrusiveSinglyLinkedList<T, Tag>::Hook* IntrusiveSinglyLinkedList<T, Tag>::check_unlinked(T& item) {
+	Hook* hook = &static_cast<Hook&>(item);
+	if (hook->is_linked())
+		throw std::invalid_argument("object is already linked into a list with this hook");
+
+	return hook;
+}
+
+template <typename T, typename Tag>
+void IntrusiveSinglyLinkedList<T, Tag>::append(T& item) {
+	Hook* hook = check_unlinked(item);
+	hook->m_next = hook;
+
+	if (!m_head)
+		m_head = hook;
+	else
+		m_tail->m_next = hook;
+
+	m_tail = hook;
+	++m_size;
+}
+
+template <typename T, typename Tag>
+void IntrusiveSinglyLinkedList<T, Tag>::prepend(T& item) {
+	Hook* hook = check_unlinked(item);
+	hook->m_next = m_head ? m_head : hook;
+
+	if (!m_head)
+		m_tail = hook;
+
+	m_head = hook;
+	++m_size;
+}
+
+template <typename T, typename Tag>
+T& IntrusiveSinglyLinkedList<T, Tag>::pop_front() {
+	if (!m_head)
+		throw std::out_of_range("pop from empty IntrusiveSinglyLinkedList");
+
+	Hook* hook = m_head;
+	m_head = next(hook);
+	if (!m_head)
+		m_tail = nullptr;
+
+	hook->m_next = nullptr;
+	--m_size;
+
+	return object(hook);
+}
+
+// O(n): a singly linked hook has no way back to its predecessor.
+template <typename T, typename Tag>
+bool IntrusiveSinglyLinkedList<T, Tag>::remove(T& item) {
+	Hook* hook = &static_cast<Hook&>(item);
+	Hook* prev{ nullptr };
+
+	for (Hook* current = m_head; current; current = next(current)) {
+		if (current == hook) {
+			Hook* following = next(hook);
+			if (prev)
+				prev->m_next = following ? following : prev;
+			else
+				m_head = following;
+
+			if (hook == m_tail)
+				m_tail = prev;
+
+			hook->m_next = nullptr;
+			--m_size;
+			return true;
+		}
+
+		prev = current;
+	}
+
+	return false;
+}
+
+template <typename T, typename Tag>
+T& IntrusiveSinglyLinkedList<T, Tag>::front() {
+	if (!m_head)
+		throw std::out_of_range("front of empty IntrusiveSinglyLinkedList");
+
+	return object(m_head);
+}
+
+template <typename T, typename Tag>
+T& IntrusiveSinglyLinkedList<T, Tag>::back() {
+	if (!m_tail)
+		throw std::out_of_range("back of empty IntrusiveSinglyLinkedList");
+
+	return object(m_tail);
+}
+
+template <typename T, typename Tag>
+void IntrusiveSinglyLinkedList<T, Tag>::clear() {
+	while (m_head) {
+		Hook* following = next(m_head);
+		m_head->m_next = nullptr;
+		m_head = following;
+	}
+
+	m_tail = nullptr;
+	m_size = 0;
+}
+
+template <typename T, typename Tag>
+size_t IntrusiveSinglyLinkedList<T, Tag>::size() const {
+
+	return m_size;
+}
+
+// Circular list around a sentinel hook owned by the list, so linking and
+// unlinking never special-case the ends. The sentinel's address is part of
+// the ring, which is why the list can be neither copied nor moved.
+template <typename T, typename Tag = void>
+class IntrusiveDoublyLinkedList {
+	using Hook = DoublyListHook<Tag>;
+public:
+	class Iterator;
+	class Reverse_Iterator;
+private:
+	Hook m_sentinel;
+
+	static T& object(Hook* hook) noexcept { return *static_cast<T*>(hook); }
+	static void link_before(Hook* position, Hook* hook);
+public:
+	IntrusiveDoublyLinkedList();
+	IntrusiveDoublyLinkedList(const IntrusiveDoublyLinkedList&) = delete;
+	IntrusiveDoublyLinkedList& operator=(const IntrusiveDoublyLinkedList&) = delete;
+	~IntrusiveDoublyLinkedList();
+
+	Iterator begin();
+	Iterator end();
+
+	Reverse_Iterator rbegin();
+	Reverse_Iterator rend();
+
+	void append(T& item);
+	void prepend(T& item);
+	void insert_before(T& position, T& item);
+	T& pop_front();
+	T& pop_back();
+	static void remove(T& item) noexcept;
+	T& front();
+	T& back();
+	void clear();
+	bool empty() const;
+	size_t size() const;
+};
+
+template <typename T, typename Tag>
+IntrusiveDoublyLinkedList<T, Tag>::IntrusiveDoublyLinkedList() {
+	m_sentinel.m_prev = &m_sentinel;
+	m_sentinel.m_next = &m_sentinel;
+}
+
+template <typename T, typename Tag>
+IntrusiveDoublyLinkedList<T, Tag>::~IntrusiveDoublyLinkedList() {
+	clear();
+	m_sentinel.m_prev = nullptr;
+	m_sentinel.m_next = nullptr;
+}
+
+template <typename T, typename Tag>
+class IntrusiveDoublyLinkedList<T, Tag>::Iterator {
+public:
+	Hook* m_current{ nullptr };
+	Iterator(Hook* hook) noexcept : m_current(hook) {};
+
+	// prefix operator
+	IntrusiveDoublyLinkedList<T, Tag>::Iterator& operator++() {
+		m_current = m_current->m_next;
+
+		return *this;
+	};
+
+	// postfix operator
+	IntrusiveDoublyLinkedList<T, Tag>::Iterator operator++(int) {
+
+		Iterator iterator = *this;
+		++* this;
+
+		return iterator;
+	}
+
+	bool operator!=(const IntrusiveDoublyLinkedList<T, Tag>::Iterator& iterator) const {
+		return m_current != iterator.m_current;
+	}
+
+	T& operator*() {
+		return IntrusiveDoublyLinkedList<T, Tag>::object(m_current);
+	}
+};
+
+template <typename T, typename Tag>
+class IntrusiveDoublyLinkedList<T, Tag>::Reverse_Iterator {
+public:
+	Hook* m_current{ nullptr };
+	Reverse_Iterator(Hook* hook) noexcept : m_current(hook) {};
+
+	IntrusiveDoublyLinkedList<T, Tag>::Reverse_Iterator& operator++() {
+		m_current = m_current->m_prev;
+
+		return *this;
+	}
+
+	IntrusiveDoublyLinkedList<T, Tag>::Reverse_Iterator operator++(int) {
+
+		Reverse_Iterator riterator = *this;
+		++* this;
+
+		return riterator;
+	}
+
+	bool operator!=(const IntrusiveDoublyLinkedList<T, Tag>::Reverse_Iterator& riterator) const {
+		return m_current != riterator.m_current;
+	}
+
+	T& operator*() {
+		return IntrusiveDoublyLinkedList<T, Tag>::object(m_current);
+	}
+};
+
+template <typename T, typename Tag>
+typename IntrusiveDoublyLinkedList<T, Tag>::Iterator IntrusiveDoublyLinkedList<T, Tag>::begin() {
+
+	return Iterator(m_sentinel.m_next);
+}
+
+template <typename T, typename Tag>
+typename IntrusiveDoublyLinkedList<T, Tag>::Iterator IntrusiveDoublyLinkedList<T, Tag>::end() {
+
+	return Iterator(&m_sentinel);
+}
+
+template <typename T, typename Tag>
+typename IntrusiveDoublyLinkedList<T, Tag>::Reverse_Iterator IntrusiveDoublyLinkedList<T, Tag>::rbegin() {
+
+	return Reverse_Iterator(m_sentinel.m_prev);
+}
+
+template <typename T, typename Tag>
+typename IntrusiveDoublyLinkedList<T, Tag>::Reverse_Iterator IntrusiveDoublyLinkedList<T, Tag>::rend() {
+
+	return Reverse_Iterator(&m_sentinel);
+}
+
+template <typename T, typename Tag>
+void IntrusiveDoublyLinkedList<T, Tag>::link_before(Hook* position, Hook* hook) {
+	if (hook->is_linked())
+		throw std::invalid_argument("object is already linked into a list with this hook");
+
+	hook->m_prev = position->m_prev;
+	hook->m_next = position;
+	position->m_prev->m_next = hook;
+	position->m_prev = hook;
+}
+
+template <typename T, typename Tag>
+void IntrusiveDoublyLinkedList<T, Tag>::append(T& item) {
+
+	link_before(&m_sentinel, &static_cast<Hook&>(item));
+}
+
+template <typename T, typename Tag>
+void IntrusiveDoublyLinkedList<T, Tag>::prepend(T& item) {
+
+	link_before(m_sentinel.m_next, &static_cast<Hook&>(item));
+}
+
+template <typename T, typename Tag>
+void IntrusiveDoublyLinkedList<T, Tag>::insert_before(T& position, T& item) {
+
+	link_before(&static_cast<Hook&>(position), &static_cast<Hook&>(item));
+}
+
+template <typename T, typename Tag>
+T& IntrusiveDoublyLinkedList<T, Tag>::pop_front() {
+	if (empty())
+		throw std::out_of_range("pop from empty IntrusiveDoublyLinkedList");
+
+	Hook* hook = m_sentinel.m_next;
+	hook->unlink();
+
+	return object(hook);
+}
+
+template <typename T, typename Tag>
+T& IntrusiveDoublyLinkedList<T, Tag>::pop_back() {
+	if (empty())
+		throw std::out_of_range("pop from empty IntrusiveDoublyLinkedList");
+
+	Hook* hook = m_sentinel.m_prev;
+	hook->unlink();
+
+	return object(hook);
+}
+
+// O(1) and needs only the object; equivalent to calling unlink() on its hook.
+template <typename T, typename Tag>
+void IntrusiveDoublyLinkedList<T, Tag>::remove(T& item) noexcept {
+
+	static_cast<Hook&>(item).unlink();
+}
+
+template <typename T, typename Tag>
+T& IntrusiveDoublyLinkedList<T, Tag>::front() {
+	if (empty())
+		throw std::out_of_range("front of empty IntrusiveDoublyLinkedList");
+
+	return object(m_sentinel.m_next);
+}
+
+template <typename T, typename Tag>
+T& IntrusiveDoublyLinkedList<T, Tag>::back() {
+	if (empty())
+		throw std::out_of_range("back of empty IntrusiveDoublyLinkedList");
+
+	return object(m_sentinel.m_prev);
+}
+
+template <typename T, typename Tag>
+void IntrusiveDoublyLinkedList<T, Tag>::clear() {
+	while (!empty())
+		m_sentinel.m_next->unlink();
+}
+
+template <typename T, typename Tag>
+bool IntrusiveDoublyLinkedList<T, Tag>::empty() const {
+
+	return m_sentinel.m_next == &m_sentinel;
+}
+
+// O(n), see DoublyListHook.
+template <typename T, typename Tag>
+size_t IntrusiveDoublyLinkedList<T, Tag>::size() const {
+	size_t count{ 0 };
+
+	for (const Hook* current = m_sentinel.m_next; current != &m_sentinel; current = current->m_next)
+		++count;
+
+	return count;
+}
@@ -0,0 +1,237 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "ListSerialization.h"
+#include "SinglyLinkedList.h"
+#include "WriteAheadLog.h"
+
+struct JournalOptions {
+	// records per fsync, as WriteAheadLog's group_commit
+	size_t group_commit{ 64 };
+	// log bytes past which the next change writes a snapshot and empties the
+	// log; 0 never does
+	size_t snapshot_bytes{ 64 << 20 };
+};
+
+// A list whose changes are journaled in a WriteAheadLog before they are made,
+// so the list survives a crash. Opening it restores the last snapshot and
+// replays the log after it; append(), insert(), pop(), remove(), remove_all()
+// and clear() each log one record, and are durable once the log commits the
+// group holding it. Once the log passes snapshot_bytes the list is saved with
+// save() and the log emptied, which bounds both the disk used and the time
+// replay takes.
+//
+// List is any list with SinglyLinkedList's interface and save() and load();
+// its elements are logged with the ListSerializer that save() uses. Changes
+// must go through this wrapper to be journaled, so the list itself is only
+// reachable for reading.
+template <typename T, typename List = SinglyLinkedList<T>>
+class JournaledList {
+private:
+	enum Operation : uint8_t {
+		Append,
+		Insert,
+		Pop,
+		Remove,
+		RemoveAll,
+		Clear,
+	};
+
+	List m_list;
+	WriteAheadLog m_log;
+	size_t m_snapshot_bytes;
+	std::string m_record;
+	std::ostringstream m_encoder;
+
+	void start(Operation operation);
+	template <typename Integer>
+	void encode(Integer value);
+	void encode_value(const T& value);
+	void log();
+	void snapshot_if_due();
+	void replay(const char* payload, size_t bytes);
+public:
+	explicit JournaledList(const std::string& path, JournalOptions options = JournalOptions());
+	JournaledList(const JournaledList&) = delete;
+	JournaledList& operator=(const JournaledList&) = delete;
+
+	auto begin() const { return m_list.begin(); }
+	auto end() const { return m_list.end(); }
+
+	void append(T data);
+	void insert(int index, T data);
+	T pop(std::optional<size_t> index = std::nullopt);
+	void remove(T data);
+	void remove_all(T data);
+	void clear();
+	T index(size_t index) { return m_list.index(index); }
+	int count(T data) { return m_list.count(std::move(data)); }
+	size_t size() const { return m_list.size(); }
+	const List& list() const noexcept { return m_list; }
+
+	void commit() { m_log.commit(); }
+	void snapshot();
+	const WriteAheadLog& journal() const noexcept { return m_log; }
+};
+
+template <typename T, typename List>
+JournaledList<T, List>::JournaledList(const std::string& path, JournalOptions options) :
+	m_log(path, options.group_commit), m_snapshot_bytes(options.snapshot_bytes) {
+	m_log.recover([this](std::istream& in) { m_list.load(in); },
+		[this](uint64_t, const char* payload, size_t bytes) { replay(payload, bytes); });
+}
+
+template <typename T, typename List>
+void JournaledList<T, List>::start(Operation operation) {
+	m_record.clear();
+	m_record.push_back(static_cast<char>(operation));
+}
+
+template <typename T, typename List>
+template <typename Integer>
+void JournaledList<T, List>::encode(Integer value) {
+	m_record.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T, typename List>
+void JournaledList<T, List>::encode_value(const T& value) {
+	if constexpr (ListSerializer<T>::bulk)
+		m_record.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	else {
+		m_encoder.str(std::string());
+		ListSerializer<T>::write(m_encoder, value);
+		m_record += m_encoder.str();
+	}
+}
+
+// Logs the record just encoded. Called before the change is made; a failure
+// to log, including a failed group commit, leaves the list and the log as
+// they were.
+template <typename T, typename List>
+void JournaledList<T, List>::log() {
+	m_log.append(m_record.data(), m_record.size());
+}
+
+template <typename T, typename List>
+void JournaledList<T, List>::snapshot_if_due() {
+	if (m_snapshot_bytes && m_log.bytes() >= m_snapshot_bytes)
+		snapshot();
+}
+
+// Makes the change one record describes, without logging it again.
+template <typename T, typename List>
+void JournaledList<T, List>::replay(const char* payload, size_t bytes) {
+	std::istringstream in(std::string(payload, bytes));
+	auto operation = list_serialization::read_integer<uint8_t>(in);
+	auto value = [&in] {
+		if constexpr (ListSerializer<T>::bulk)
+			return list_serialization::read_integer<T>(in);
+		else
+			return ListSerializer<T>::read(in);
+	};
+
+	switch (operation) {
+	case Append:
+		m_list.append(value());
+		break;
+	case Insert: {
+		auto index = list_serialization::read_integer<int32_t>(in);
+		m_list.insert(index, value());
+		break;
+	}
+	case Pop: {
+		auto has_index = list_serialization::read_integer<uint8_t>(in);
+		auto index = list_serialization::read_integer<uint64_t>(in);
+		if (m_list.size() == 0 || (has_index && index >= m_list.size()))
+			throw std::runtime_error("JournaledList log pops past the end of the list");
+		m_list.pop(has_index ? std::optional<size_t>(static_cast<size_t>(index)) : std::nullopt);
+		break;
+	}
+	case Remove:
+		m_list.remove(value());
+		break;
+	case RemoveAll:
+		m_list.remove_all(value());
+		break;
+	case Clear:
+		m_list.clear();
+		break;
+	default:
+		throw std::runtime_error("JournaledList log holds an unknown operation");
+	}
+}
+
+template <typename T, typename List>
+void JournaledList<T, List>::append(T data) {
+	start(Append);
+	encode_value(data);
+	log();
+	m_list.append(std::move(data));
+	snapshot_if_due();
+}
+
+template <typename T, typename List>
+void JournaledList<T, List>::insert(int index, T data) {
+	start(Insert);
+	encode<int32_t>(index);
+	encode_value(data);
+	log();
+	m_list.insert(index, std::move(data));
+	snapshot_if_due();
+}
+
+// Unlike the lists themselves, checks the index, since a pop that could not
+// be replayed would make the log unreadable.
+template <typename T, typename List>
+T JournaledList<T, List>::pop(std::optional<size_t> index) {
+	if (m_list.size() == 0 || (index && *index >= m_list.size()))
+		throw std::out_of_range("JournaledList index out of range");
+
+	start(Pop);
+	encode<uint8_t>(index.has_value());
+	encode<uint64_t>(index.value_or(0));
+	log();
+	T data = m_list.pop(index);
+	snapshot_if_due();
+
+	return data;
+}
+
+template <typename T, typename List>
+void JournaledList<T, List>::remove(T data) {
+	start(Remove);
+	encode_value(data);
+	log();
+	m_list.remove(std::move(data));
+	snapshot_if_due();
+}
+
+template <typename T, typename List>
+void JournaledList<T, List>::remove_all(T data) {
+	start(RemoveAll);
+	encode_value(data);
+	log();
+	m_list.remove_all(std::move(data));
+	snapshot_if_due();
+}
+
+template <typename T, typename List>
+void JournaledList<T, List>::clear() {
+	start(Clear);
+	log();
+	m_list.clear();
+	snapshot_if_due();
+}
+
+// Saves the list as it stands and empties the log; done automatically past
+// snapshot_bytes, or by callers that want a short replay on the next open.
+template <typename T, typename List>
+void JournaledList<T, List>::snapshot() {
+	m_log.checkpoint([this](std::ostream& out) { m_list.save(out); });
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include "CacheStats.h"
+#include "DoublyLinkedList.h"
+#include "NodePool.h"
+
+// Least-frequently-used cache of at most capacity entries, with O(1) get,
+// put and eviction.
+//
+// Entries are grouped into buckets by access count. The buckets form a
+// DoublyLinkedList in increasing count order and each holds its entries in a
+// DoublyLinkedList of its own, least recent at the front. A hit splices the
+// entry's node into the bucket for the next count, which is either the
+// bucket after the current one or a new bucket inserted there, and drops the
+// old bucket if that emptied it. The victim is the front entry of the front
+// bucket: the least recently used of the least frequently used entries.
+//
+// Counts never decay, so entries that were popular once stay until they are
+// erased; WTinyLFUCache ages its frequencies instead.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>,
+	typename Allocator = PoolAllocator<std::pair<K, V>>>
+class LFUCache {
+public:
+	using Entry = std::pair<K, V>;
+private:
+	using EntryList = DoublyLinkedList<Entry, DirectTraversal, Allocator>;
+	using EntryHandle = std::shared_ptr<typename EntryList::Node>;
+
+	struct Bucket {
+		uint64_t frequency;
+		EntryList entries;
+
+		Bucket(uint64_t count, const Allocator& allocator) : frequency(count), entries(allocator) {};
+	};
+
+	using BucketAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Bucket>;
+	using BucketList = DoublyLinkedList<Bucket, DirectTraversal, BucketAllocator>;
+	using BucketHandle = std::shared_ptr<typename BucketList::Node>;
+
+	struct Location {
+		EntryHandle entry;
+		BucketHandle bucket;
+	};
+
+	using MapAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const K, Location>>;
+
+	size_t m_capacity;
+	Allocator m_allocator;
+	CacheStats m_stats;
+	// declared before the map, so the map's handles are released first
+	BucketList m_buckets;
+	std::unordered_map<K, Location, Hash, KeyEqual, MapAllocator> m_entries;
+
+	void touch(Location& location);
+	void evict();
+public:
+	explicit LFUCache(size_t capacity, const Allocator& allocator = Allocator());
+	LFUCache(const LFUCache&) = delete;
+	LFUCache& operator=(const LFUCache&) = delete;
+
+	std::optional<V> get(const K& key);
+	void put(const K& key, V value);
+	bool erase(const K& key);
+	bool contains(const K& key) const;
+	void clear();
+	// Accesses counted for key, including the put that inserted it; 0 if absent.
+	uint64_t frequency(const K& key) const;
+
+	size_t size() const noexcept { return m_entries.size(); }
+	size_t capacity() const noexcept { return m_capacity; }
+
+	const CacheStats& stats() const noexcept { return m_stats; }
+	void reset_stats() noexcept { m_stats = CacheStats{}; }
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+LFUCache<K, V, Hash, KeyEqual, Allocator>::LFUCache(size_t capacity, const Allocator& allocator) :
+	m_capacity(capacity), m_allocator(allocator), m_buckets(BucketAllocator(allocator)),
+	m_entries(0, Hash(), KeyEqual(), MapAllocator(allocator)) {
+	if (capacity == 0)
+		throw std::invalid_argument("LFUCache capacity must be at least 1");
+
+	m_entries.reserve(capacity);
+}
+
+// Moves the entry into the bucket for its next count.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void LFUCache<K, V, Hash, KeyEqual, Allocator>::touch(Location& location) {
+	BucketHandle current = location.bucket;
+	uint64_t next_frequency = current->data().frequency + 1;
+
+	BucketHandle target = current->next();
+	bool missing = !target || target->data().frequency != next_frequency;
+
+	// an entry alone in its bucket takes the bucket with it
+	if (missing && current->data().entries.size() == 1) {
+		current->data().frequency = next_frequency;
+		return;
+	}
+
+	if (missing)
+		target = m_buckets.insert_after(current, Bucket(next_frequency, m_allocator));
+
+	target->data().entries.splice_back(current->data().entries, location.entry);
+	location.bucket = target;
+
+	if (current->data().entries.size() == 0)
+		m_buckets.erase(current);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+std::optional<V> LFUCache<K, V, Hash, KeyEqual, Allocator>::get(const K& key) {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end()) {
+		++m_stats.misses;
+		return std::nullopt;
+	}
+
+	++m_stats.hits;
+	touch(found->second);
+
+	return found->second.entry->data().second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void LFUCache<K, V, Hash, KeyEqual, Allocator>::put(const K& key, V value) {
+	auto found = m_entries.find(key);
+	if (found != m_entries.end()) {
+		found->second.entry->data().second = std::move(value);
+		touch(found->second);
+		return;
+	}
+
+	if (m_entries.size() == m_capacity)
+		evict();
+
+	BucketHandle first = m_buckets.front();
+	if (!first) {
+		m_buckets.append(Bucket(1, m_allocator));
+		first = m_buckets.front();
+	}
+	else if (first->data().frequency != 1) {
+		m_buckets.insert(0, Bucket(1, m_allocator));
+		first = m_buckets.front();
+	}
+
+	first->data().entries.append(Entry(key, std::move(value)));
+	m_entries.emplace(key, Location{ first->data().entries.back(), first });
+	++m_stats.insertions;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool LFUCache<K, V, Hash, KeyEqual, Allocator>::erase(const K& key) {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return false;
+
+	Location location = std::move(found->second);
+	m_entries.erase(found);
+
+	location.bucket->data().entries.erase(location.entry);
+	if (location.bucket->data().entries.size() == 0)
+		m_buckets.erase(location.bucket);
+
+	return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool LFUCache<K, V, Hash, KeyEqual, Allocator>::contains(const K& key) const {
+
+	return m_entries.find(key) != m_entries.end();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void LFUCache<K, V, Hash, KeyEqual, Allocator>::clear() {
+	m_entries.clear();
+	m_buckets.clear();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+uint64_t LFUCache<K, V, Hash, KeyEqual, Allocator>::frequency(const K& key) const {
+	auto found = m_entries.find(key);
+
+	return found == m_entries.end() ? 0 : found->second.bucket->data().frequency;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void LFUCache<K, V, Hash, KeyEqual, Allocator>::evict() {
+	BucketHandle lowest = m_buckets.front();
+	EntryHandle victim = lowest->data().entries.front();
+
+	m_entries.erase(victim->data().first);
+	lowest->data().entries.erase(victim);
+	if (lowest->data().entries.size() == 0)
+		m_buckets.erase(lowest);
+
+	++m_stats.evictions;
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include "CacheStats.h"
+#include "DoublyLinkedList.h"
+#include "NodePool.h"
+
+// Least-recently-used cache of at most capacity entries.
+//
+// Entries sit in a DoublyLinkedList in recency order, least recent at the
+// front, and a hash map from key to list node finds them. get() and put()
+// move the entry's node to the back without copying or reallocating it, and
+// a put() into a full cache erases the front node, so every operation is
+// O(1) apart from hashing.
+//
+// The list nodes and hash map nodes are allocated through Allocator, which is
+// rebound for the map; the default PoolAllocator recycles the slots of
+// evicted entries for new ones. The map reserves its buckets for capacity
+// entries up front, so it never rehashes.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>,
+	typename Allocator = PoolAllocator<std::pair<K, V>>>
+class LRUCache {
+public:
+	using Entry = std::pair<K, V>;
+	using List = DoublyLinkedList<Entry, DirectTraversal, Allocator>;
+	using Handle = std::shared_ptr<typename List::Node>;
+private:
+	using MapAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const K, Handle>>;
+
+	size_t m_capacity;
+	CacheStats m_stats;
+	// declared before the map, so the map's handles are released first and the
+	// list can then free its nodes one at a time
+	List m_recency;
+	std::unordered_map<K, Handle, Hash, KeyEqual, MapAllocator> m_entries;
+
+	void evict();
+public:
+	explicit LRUCache(size_t capacity, const Allocator& allocator = Allocator());
+	LRUCache(const LRUCache&) = delete;
+	LRUCache& operator=(const LRUCache&) = delete;
+
+	std::optional<V> get(const K& key);
+	std::optional<V> peek(const K& key) const;
+	bool promote(const K& key);
+	void put(const K& key, V value);
+	bool erase(const K& key);
+	bool contains(const K& key) const;
+	void clear();
+
+	size_t size() const noexcept { return m_entries.size(); }
+	size_t capacity() const noexcept { return m_capacity; }
+	// Least recently used entry, the next to be evicted; size() must not be 0.
+	const Entry& least_recent() const { return m_recency.front()->data(); }
+
+	const CacheStats& stats() const noexcept { return m_stats; }
+	void reset_stats() noexcept { m_stats = CacheStats{}; }
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+LRUCache<K, V, Hash, KeyEqual, Allocator>::LRUCache(size_t capacity, const Allocator& allocator) :
+	m_capacity(capacity), m_recency(allocator), m_entries(0, Hash(), KeyEqual(), MapAllocator(allocator)) {
+	if (capacity == 0)
+		throw std::invalid_argument("LRUCache capacity must be at least 1");
+
+	m_entries.reserve(capacity);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+std::optional<V> LRUCache<K, V, Hash, KeyEqual, Allocator>::get(const K& key) {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end()) {
+		++m_stats.misses;
+		return std::nullopt;
+	}
+
+	++m_stats.hits;
+	m_recency.move_to_back(found->second);
+
+	return found->second->data().second;
+}
+
+// Looks key up without making it more recent or counting a hit or miss.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+std::optional<V> LRUCache<K, V, Hash, KeyEqual, Allocator>::peek(const K& key) const {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return std::nullopt;
+
+	return found->second->data().second;
+}
+
+// Makes key the most recent entry, if it is still cached, without counting a
+// hit; for callers that look entries up with peek() and apply the recency
+// update later.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool LRUCache<K, V, Hash, KeyEqual, Allocator>::promote(const K& key) {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return false;
+
+	m_recency.move_to_back(found->second);
+
+	return true;
+}
+
+// Inserts or replaces the value for key and makes it the most recent entry,
+// evicting the least recent one if the cache is full.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void LRUCache<K, V, Hash, KeyEqual, Allocator>::put(const K& key, V value) {
+	auto found = m_entries.find(key);
+	if (found != m_entries.end()) {
+		found->second->data().second = std::move(value);
+		m_recency.move_to_back(found->second);
+		return;
+	}
+
+	if (m_entries.size() == m_capacity)
+		evict();
+
+	m_recency.append(Entry(key, std::move(value)));
+	m_entries.emplace(key, m_recency.back());
+	++m_stats.insertions;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool LRUCache<K, V, Hash, KeyEqual, Allocator>::erase(const K& key) {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return false;
+
+	m_recency.erase(found->second);
+	m_entries.erase(found);
+
+	return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool LRUCache<K, V, Hash, KeyEqual, Allocator>::contains(const K& key) const {
+
+	return m_entries.find(key) != m_entries.end();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void LRUCache<K, V, Hash, KeyEqual, Allocator>::clear() {
+	m_entries.clear();
+	m_recency.clear();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void LRUCache<K, V, Hash, KeyEqual, Allocator>::evict() {
+	Handle oldest = m_recency.front();
+
+	m_recency.erase(oldest);
+	m_entries.erase(oldest->data().first);
+	++m_stats.evictions;
+}
@@ -0,0 +1,437 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ListSerialization.h"
+
+// Streams lists through bounded memory as a sequence of chunks, for dumps
+// too large to build or buffer in one piece the way save() and load() do:
+//
+//	4 bytes   magic "DSAC"
+//	uint32    format version, 1
+//	uint32    element width, as in ListSerialization.h
+//	uint32    codec id
+//	uint32    flags: 1 if every chunk carries a checksum
+//	uint32    elements per chunk
+//	          chunks, each:
+//	uint32      element count, at most elements per chunk
+//	uint32      stored payload bytes, after compression
+//	uint32      payload bytes before compression
+//	uint32      CRC-32 of the stored payload, if the flag is set
+//	            the stored payload: the elements as save() writes them
+//	          then an end marker:
+//	uint32      0
+//	uint64      total element count
+//
+// Integers are in the writer's byte order, as in ListSerialization.h. The
+// writer holds one chunk at a time, and the reader one chunk plus however
+// many it reads ahead.
+
+// Compression hooks. A Codec has an id, stored in the stream so a reader with
+// another codec refuses it, and compress() and decompress() over one chunk's
+// payload. NoCompression stores payloads as they are.
+struct NoCompression {
+	static constexpr uint32_t id{ 0 };
+
+	static void compress(const std::byte* input, size_t bytes, std::vector<std::byte>& output) {
+		output.assign(input, input + bytes);
+	}
+
+	static void decompress(const std::byte* input, size_t bytes, size_t, std::vector<std::byte>& output) {
+		output.assign(input, input + bytes);
+	}
+};
+
+struct ChunkWriterOptions {
+	size_t chunk_elements{ 1 << 16 };
+	bool checksums{ true };
+};
+
+namespace list_chunks {
+	constexpr char magic[4]{ 'D', 'S', 'A', 'C' };
+	constexpr uint32_t version{ 1 };
+	constexpr uint32_t checksummed{ 1 };
+}
+
+// Writes elements one at a time, or whole lists, and emits a chunk each time
+// chunk_elements have accumulated. finish() writes the last, partial chunk
+// and the end marker; the destructor calls it if the caller has not, but
+// cannot report a failure doing so.
+template <typename T, typename Codec = NoCompression>
+class ListChunkWriter {
+private:
+	std::ostream& m_out;
+	ChunkWriterOptions m_options;
+	std::vector<std::byte> m_raw;
+	std::vector<std::byte> m_stored;
+	// serializes elements that are not stored as raw bytes
+	std::ostringstream m_encoder;
+	size_t m_pending{ 0 };
+	uint64_t m_total{ 0 };
+	bool m_finished{ false };
+
+	void flush_chunk();
+public:
+	explicit ListChunkWriter(std::ostream& out, ChunkWriterOptions options = ChunkWriterOptions());
+	ListChunkWriter(const ListChunkWriter&) = delete;
+	ListChunkWriter& operator=(const ListChunkWriter&) = delete;
+	~ListChunkWriter();
+
+	void write(const T& value);
+	// Writes every element of a list, front to back, through its const iterators.
+	template <typename List>
+	void write_list(const List& list);
+	void finish();
+
+	uint64_t written() const noexcept { return m_total; }
+};
+
+template <typename T, typename Codec>
+ListChunkWriter<T, Codec>::ListChunkWriter(std::ostream& out, ChunkWriterOptions options) :
+	m_out(out), m_options(options) {
+	if (options.chunk_elements == 0 || options.chunk_elements > UINT32_MAX)
+		throw std::invalid_argument("ListChunkWriter chunk size must be between 1 and 2^32 - 1 elements");
+
+	if constexpr (ListSerializer<T>::bulk)
+		m_raw.reserve(options.chunk_elements * sizeof(T));
+
+	m_out.write(list_chunks::magic, sizeof(list_chunks::magic));
+	list_serialization::write_integer(m_out, list_chunks::version);
+	list_serialization::write_integer(m_out, ListSerializer<T>::width);
+	list_serialization::write_integer(m_out, Codec::id);
+	list_serialization::write_integer<uint32_t>(m_out, options.checksums ? list_chunks::checksummed : 0);
+	list_serialization::write_integer(m_out, static_cast<uint32_t>(options.chunk_elements));
+	list_serialization::check_written(m_out);
+}
+
+template <typename T, typename Codec>
+ListChunkWriter<T, Codec>::~ListChunkWriter() {
+	try {
+		finish();
+	}
+	catch (...) {}
+}
+
+template <typename T, typename Codec>
+void ListChunkWriter<T, Codec>::write(const T& value) {
+	if (m_finished)
+		throw std::logic_error("ListChunkWriter is already finished");
+
+	if constexpr (ListSerializer<T>::bulk) {
+		auto bytes = reinterpret_cast<const std::byte*>(&value);
+		m_raw.insert(m_raw.end(), bytes, bytes + sizeof(T));
+	}
+	else
+		ListSerializer<T>::write(m_encoder, value);
+
+	++m_total;
+	if (++m_pending == m_options.chunk_elements)
+		flush_chunk();
+}
+
+template <typename T, typename Codec>
+template <typename List>
+void ListChunkWriter<T, Codec>::write_list(const List& list) {
+	for (const T& value : list)
+		write(value);
+}
+
+template <typename T, typename Codec>
+void ListChunkWriter<T, Codec>::finish() {
+	if (m_finished)
+		return;
+
+	m_finished = true;
+	if (m_pending)
+		flush_chunk();
+
+	list_serialization::write_integer<uint32_t>(m_out, 0);
+	list_serialization::write_integer(m_out, m_total);
+	m_out.flush();
+	list_serialization::check_written(m_out);
+}
+
+template <typename T, typename Codec>
+void ListChunkWriter<T, Codec>::flush_chunk() {
+	if constexpr (!ListSerializer<T>::bulk) {
+		std::string encoded = m_encoder.str();
+		auto bytes = reinterpret_cast<const std::byte*>(encoded.data());
+		m_raw.assign(bytes, bytes + encoded.size());
+		m_encoder.str({});
+	}
+
+	if (m_raw.size() > UINT32_MAX)
+		throw std::length_error("ListChunkWriter chunk is larger than 4 GiB; use smaller chunks");
+
+	const std::vector<std::byte>* stored = &m_raw;
+	if constexpr (!std::is_same_v<Codec, NoCompression>) {
+		Codec::compress(m_raw.data(), m_raw.size(), m_stored);
+		stored = &m_stored;
+		if (m_stored.size() > UINT32_MAX)
+			throw std::length_error("ListChunkWriter compressed chunk is larger than 4 GiB; use smaller chunks");
+	}
+
+	list_serialization::write_integer(m_out, static_cast<uint32_t>(m_pending));
+	list_serialization::write_integer(m_out, static_cast<uint32_t>(stored->size()));
+	list_serialization::write_integer(m_out, static_cast<uint32_t>(m_raw.size()));
+	if (m_options.checksums)
+		list_serialization::write_integer(m_out, list_serialization::crc32(stored->data(), stored->size()));
+	m_out.write(reinterpret_cast<const char*>(stored->data()), static_cast<std::streamsize>(stored->size()));
+	list_serialization::check_written(m_out);
+
+	m_raw.clear();
+	m_pending = 0;
+}
+
+// Reads a chunked stream back one chunk at a time. With read_ahead above 0 a
+// background thread reads, checks, decompresses and decodes up to that many
+// chunks ahead of the caller, so the I/O for the next chunks overlaps with
+// whatever the caller does with this one, such as building nodes. Errors
+// from either thread surface as exceptions from next_chunk(); the stream
+// must not be used by anything else until the reader is destroyed.
+template <typename T, typename Codec = NoCompression>
+class ListChunkReader {
+private:
+	std::istream& m_in;
+	bool m_checksums{ false };
+	size_t m_chunk_elements{ 0 };
+	// elements decoded so far, by whichever thread reads the stream
+	uint64_t m_total{ 0 };
+	// elements handed to the caller so far
+	uint64_t m_consumed{ 0 };
+	std::vector<T> m_current;
+	std::vector<std::byte> m_stored;
+	std::vector<std::byte> m_raw;
+
+	// handed from the read-ahead thread to the caller, and the caller's
+	// finished chunks handed back for reuse
+	size_t m_read_ahead;
+	std::deque<std::vector<T>> m_ready;
+	std::vector<std::vector<T>> m_spare;
+	bool m_done{ false };
+	bool m_stopping{ false };
+	std::exception_ptr m_error;
+	std::mutex m_mutex;
+	std::condition_variable m_changed;
+	std::thread m_thread;
+
+	// Decodes the next chunk into values, or returns false at the end marker.
+	bool read_chunk(std::vector<T>& values);
+	void prefetch();
+public:
+	explicit ListChunkReader(std::istream& in, size_t read_ahead = 2);
+	ListChunkReader(const ListChunkReader&) = delete;
+	ListChunkReader& operator=(const ListChunkReader&) = delete;
+	~ListChunkReader();
+
+	// The next chunk's elements, which the caller may move from, or nullptr
+	// once the stream is exhausted; valid until the next call.
+	std::vector<T>* next_chunk();
+	// Appends every remaining element to a SinglyLinkedList or DoublyLinkedList.
+	template <typename List>
+	void read_into(List& list);
+	template <typename Function>
+	void for_each(Function function);
+
+	size_t chunk_elements() const noexcept { return m_chunk_elements; }
+	uint64_t elements_read() const noexcept { return m_consumed; }
+};
+
+template <typename T, typename Codec>
+ListChunkReader<T, Codec>::ListChunkReader(std::istream& in, size_t read_ahead) :
+	m_in(in), m_read_ahead(read_ahead) {
+	char found[sizeof(list_chunks::magic)];
+	list_serialization::read_exact(m_in, found, sizeof(found));
+	if (std::memcmp(found, list_chunks::magic, sizeof(found)) != 0
+		|| list_serialization::read_integer<uint32_t>(m_in) != list_chunks::version)
+		throw std::runtime_error("list stream is not in the chunked list format");
+	if (list_serialization::read_integer<uint32_t>(m_in) != ListSerializer<T>::width)
+		throw std::runtime_error("list stream holds elements of another type");
+	if (list_serialization::read_integer<uint32_t>(m_in) != Codec::id)
+		throw std::runtime_error("list stream was written with another codec");
+
+	m_checksums = (list_serialization::read_integer<uint32_t>(m_in) & list_chunks::checksummed) != 0;
+	m_chunk_elements = list_serialization::read_integer<uint32_t>(m_in);
+
+	if (m_read_ahead)
+		m_thread = std::thread([this] { prefetch(); });
+}
+
+template <typename T, typename Codec>
+ListChunkReader<T, Codec>::~ListChunkReader() {
+	if (m_thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_changed.notify_all();
+		m_thread.join();
+	}
+}
+
+// Raw elements stored uncompressed are read straight into values; everything
+// else goes through the stored and raw byte buffers, which are reused from
+// chunk to chunk.
+template <typename T, typename Codec>
+bool ListChunkReader<T, Codec>::read_chunk(std::vector<T>& values) {
+	auto count = list_serialization::read_integer<uint32_t>(m_in);
+	if (count == 0) {
+		uint64_t total = list_serialization::read_integer<uint64_t>(m_in);
+		if (total != m_total)
+			throw std::runtime_error("list stream ended after the wrong number of elements");
+		return false;
+	}
+
+	auto stored_bytes = list_serialization::read_integer<uint32_t>(m_in);
+	auto raw_bytes = list_serialization::read_integer<uint32_t>(m_in);
+	if (count > m_chunk_elements || (ListSerializer<T>::bulk && raw_bytes != uint64_t{ count } * sizeof(T)))
+		throw std::runtime_error("list stream has a malformed chunk");
+
+	uint32_t checksum{ 0 };
+	if (m_checksums)
+		checksum = list_serialization::read_integer<uint32_t>(m_in);
+
+	values.clear();
+
+	if constexpr (ListSerializer<T>::bulk && std::is_same_v<Codec, NoCompression>) {
+		if (stored_bytes != raw_bytes)
+			throw std::runtime_error("list stream has a malformed chunk");
+
+		values.resize(count);
+		auto bytes = reinterpret_cast<std::byte*>(values.data());
+		list_serialization::read_exact(m_in, bytes, raw_bytes);
+		if (m_checksums && list_serialization::crc32(bytes, raw_bytes) != checksum)
+			throw std::runtime_error("list stream chunk fails its checksum");
+
+		m_total += count;
+		return true;
+	}
+
+	m_stored.resize(stored_bytes);
+	list_serialization::read_exact(m_in, m_stored.data(), m_stored.size());
+	if (m_checksums && list_serialization::crc32(m_stored.data(), m_stored.size()) != checksum)
+		throw std::runtime_error("list stream chunk fails its checksum");
+
+	const std::vector<std::byte>* payload = &m_stored;
+	if constexpr (!std::is_same_v<Codec, NoCompression>) {
+		Codec::decompress(m_stored.data(), m_stored.size(), raw_bytes, m_raw);
+		payload = &m_raw;
+	}
+	if (payload->size() != raw_bytes)
+		throw std::runtime_error("list stream chunk decompresses to the wrong size");
+
+	if constexpr (ListSerializer<T>::bulk) {
+		values.resize(count);
+		std::memcpy(values.data(), payload->data(), payload->size());
+	}
+	else {
+		std::istringstream decoder(std::string(reinterpret_cast<const char*>(payload->data()), payload->size()));
+		values.reserve(count);
+		for (uint32_t idx = 0; idx < count; ++idx)
+			values.push_back(ListSerializer<T>::read(decoder));
+	}
+
+	m_total += count;
+
+	return true;
+}
+
+template <typename T, typename Codec>
+void ListChunkReader<T, Codec>::prefetch() {
+	try {
+		while (true) {
+			std::vector<T> chunk;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (!m_spare.empty()) {
+					chunk = std::move(m_spare.back());
+					m_spare.pop_back();
+				}
+			}
+
+			bool more = read_chunk(chunk);
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (!more) {
+				m_done = true;
+				break;
+			}
+
+			m_changed.wait(lock, [this] { return m_stopping || m_ready.size() < m_read_ahead; });
+			if (m_stopping)
+				return;
+
+			m_ready.push_back(std::move(chunk));
+			lock.unlock();
+			m_changed.notify_all();
+		}
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_error = std::current_exception();
+		m_done = true;
+	}
+
+	m_changed.notify_all();
+}
+
+template <typename T, typename Codec>
+std::vector<T>* ListChunkReader<T, Codec>::next_chunk() {
+	if (!m_read_ahead) {
+		if (m_done || !read_chunk(m_current)) {
+			m_done = true;
+			return nullptr;
+		}
+
+		m_consumed += m_current.size();
+		return &m_current;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_changed.wait(lock, [this] { return !m_ready.empty() || m_done; });
+
+	if (m_ready.empty()) {
+		if (m_error)
+			std::rethrow_exception(m_error);
+		return nullptr;
+	}
+
+	m_spare.push_back(std::move(m_current));
+	m_current = std::move(m_ready.front());
+	m_ready.pop_front();
+	m_consumed += m_current.size();
+	lock.unlock();
+	m_changed.notify_all();
+
+	return &m_current;
+}
+
+template <typename T, typename Codec>
+template <typename List>
+void ListChunkReader<T, Codec>::read_into(List& list) {
+	while (auto chunk = next_chunk()) {
+		for (auto& value : *chunk)
+			list.append(std::move(value));
+	}
+}
+
+template <typename T, typename Codec>
+template <typename Function>
+void ListChunkReader<T, Codec>::for_each(Function function) {
+	while (auto chunk = next_chunk()) {
+		for (auto& value : *chunk)
+			function(value);
+	}
+}
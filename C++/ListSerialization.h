@@ -0,0 +1,204 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Binary format written by SinglyLinkedList::save() and DoublyLinkedList::save():
+//
+//	4 bytes   magic "DSAL"
+//	uint32    format version, 1
+//	uint32    element width: sizeof(T) for elements stored as raw bytes, 0 for
+//	          elements with a ListSerializer of their own
+//	uint64    element count
+//	          the elements, front to back
+//
+// Integers and raw elements are stored in the writer's byte order, so a file
+// is read back on a machine of the same endianness and with the same layout
+// of T. Either list can load what the other saved.
+
+// How one element is written and read. Trivially copyable types are stored
+// as their bytes, which lets load() read all of them with one read(); other
+// types need a specialization providing write() and read() and setting bulk
+// to false, like the one for std::string below.
+template <typename T>
+struct ListSerializer {
+	static_assert(std::is_trivially_copyable_v<T>,
+		"lists of types that are not trivially copyable need a ListSerializer specialization");
+
+	static constexpr bool bulk{ true };
+	static constexpr uint32_t width{ sizeof(T) };
+};
+
+template <typename Char, typename Traits, typename Alloc>
+struct ListSerializer<std::basic_string<Char, Traits, Alloc>> {
+	using String = std::basic_string<Char, Traits, Alloc>;
+
+	static constexpr bool bulk{ false };
+	static constexpr uint32_t width{ 0 };
+
+	// length in characters, then the characters
+	static void write(std::ostream& out, const String& value);
+	static String read(std::istream& in);
+};
+
+namespace list_serialization {
+	constexpr char magic[4]{ 'D', 'S', 'A', 'L' };
+	constexpr uint32_t version{ 1 };
+	// bytes staged before each write() when saving raw elements
+	constexpr size_t chunk_bytes{ 1 << 16 };
+
+	// CRC-32 (IEEE 802.3, reflected), eight bytes per step with slicing-by-8:
+	// table[k][b] is the CRC of byte b followed by k zero bytes.
+	inline uint32_t crc32(const std::byte* data, size_t bytes) {
+		static const std::array<std::array<uint32_t, 256>, 8> table = [] {
+			std::array<std::array<uint32_t, 256>, 8> entries{};
+			for (uint32_t idx = 0; idx < 256; ++idx) {
+				uint32_t crc = idx;
+				for (int bit = 0; bit < 8; ++bit)
+					crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+				entries[0][idx] = crc;
+			}
+			for (size_t slice = 1; slice < 8; ++slice) {
+				for (uint32_t idx = 0; idx < 256; ++idx)
+					entries[slice][idx] = (entries[slice - 1][idx] >> 8) ^ entries[0][entries[slice - 1][idx] & 0xFF];
+			}
+			return entries;
+		}();
+
+		auto byte = [&](size_t idx) { return static_cast<uint32_t>(static_cast<uint8_t>(data[idx])); };
+		uint32_t crc{ 0xFFFFFFFFu };
+		size_t idx{ 0 };
+
+		for (; idx + 8 <= bytes; idx += 8) {
+			uint32_t low = crc ^ (byte(idx) | byte(idx + 1) << 8 | byte(idx + 2) << 16 | byte(idx + 3) << 24);
+			crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24]
+				^ table[3][byte(idx + 4)] ^ table[2][byte(idx + 5)] ^ table[1][byte(idx + 6)] ^ table[0][byte(idx + 7)];
+		}
+		for (; idx < bytes; ++idx)
+			crc = table[0][(crc ^ byte(idx)) & 0xFF] ^ (crc >> 8);
+
+		return crc ^ 0xFFFFFFFFu;
+	}
+
+	inline void read_exact(std::istream& in, void* destination, size_t bytes) {
+		if (bytes && !in.read(static_cast<char*>(destination), static_cast<std::streamsize>(bytes)))
+			throw std::runtime_error("list stream is truncated");
+	}
+
+	template <typename Integer>
+	void write_integer(std::ostream& out, Integer value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	template <typename Integer>
+	Integer read_integer(std::istream& in) {
+		Integer value;
+		read_exact(in, &value, sizeof(value));
+
+		return value;
+	}
+
+	inline void write_header(std::ostream& out, uint32_t width, uint64_t count) {
+		out.write(magic, sizeof(magic));
+		write_integer(out, version);
+		write_integer(out, width);
+		write_integer(out, count);
+	}
+
+	// Returns the element count after checking the header matches width.
+	inline uint64_t read_header(std::istream& in, uint32_t width) {
+		char found[sizeof(magic)];
+		read_exact(in, found, sizeof(found));
+		if (std::memcmp(found, magic, sizeof(magic)) != 0 || read_integer<uint32_t>(in) != version)
+			throw std::runtime_error("list stream is not in the list format");
+		if (read_integer<uint32_t>(in) != width)
+			throw std::runtime_error("list stream holds elements of another type");
+
+		return read_integer<uint64_t>(in);
+	}
+
+	// Throws rather than allocating for a count the stream cannot hold, when
+	// the stream can tell how much is left.
+	inline void check_remaining(std::istream& in, uint64_t bytes) {
+		auto here = in.tellg();
+		if (here == std::istream::pos_type(-1))
+			return;
+
+		in.seekg(0, std::ios::end);
+		auto end = in.tellg();
+		in.seekg(here);
+
+		if (end != std::istream::pos_type(-1) && static_cast<uint64_t>(end - here) < bytes)
+			throw std::runtime_error("list stream is truncated");
+	}
+
+	inline void check_written(const std::ostream& out) {
+		if (!out)
+			throw std::runtime_error("list stream write failed");
+	}
+
+	// Writes the elements from first on, following next, staging raw
+	// elements so they go out in large writes.
+	template <typename T, typename Node, typename Next>
+	void write_elements(std::ostream& out, const Node* first, Next next) {
+		if constexpr (ListSerializer<T>::bulk) {
+			constexpr size_t per_chunk{ chunk_bytes / sizeof(T) ? chunk_bytes / sizeof(T) : 1 };
+			std::unique_ptr<char[]> chunk{ new char[per_chunk * sizeof(T)] };
+			size_t staged{ 0 };
+
+			for (const Node* node = first; node; node = next(node)) {
+				std::memcpy(chunk.get() + staged * sizeof(T), &node->data(), sizeof(T));
+				if (++staged == per_chunk) {
+					out.write(chunk.get(), static_cast<std::streamsize>(staged * sizeof(T)));
+					staged = 0;
+				}
+			}
+
+			out.write(chunk.get(), static_cast<std::streamsize>(staged * sizeof(T)));
+		}
+		else {
+			for (const Node* node = first; node; node = next(node))
+				ListSerializer<T>::write(out, node->data());
+		}
+	}
+
+	// All count raw elements, read with a single read() into uninitialized
+	// storage that is freed with the returned pointer.
+	template <typename T>
+	auto read_bulk(std::istream& in, uint64_t count) {
+		if (count > UINT64_MAX / sizeof(T))
+			throw std::runtime_error("list stream is truncated");
+		check_remaining(in, count * sizeof(T));
+
+		auto free = [count](T* values) { std::allocator<T>().deallocate(values, static_cast<size_t>(count)); };
+		std::unique_ptr<T, decltype(free)> values{ std::allocator<T>().allocate(static_cast<size_t>(count)), free };
+		read_exact(in, values.get(), static_cast<size_t>(count * sizeof(T)));
+
+		return values;
+	}
+}
+
+template <typename Char, typename Traits, typename Alloc>
+void ListSerializer<std::basic_string<Char, Traits, Alloc>>::write(std::ostream& out, const String& value) {
+	list_serialization::write_integer<uint64_t>(out, value.size());
+	out.write(reinterpret_cast<const char*>(value.data()), static_cast<std::streamsize>(value.size() * sizeof(Char)));
+}
+
+template <typename Char, typename Traits, typename Alloc>
+typename ListSerializer<std::basic_string<Char, Traits, Alloc>>::String
+ListSerializer<std::basic_string<Char, Traits, Alloc>>::read(std::istream& in) {
+	auto length = list_serialization::read_integer<uint64_t>(in);
+	list_serialization::check_remaining(in, length * sizeof(Char));
+
+	String value(static_cast<size_t>(length), Char());
+	list_serialization::read_exact(in, value.data(), static_cast<size_t>(length * sizeof(Char)));
+
+	return value;
+}
@@ -0,0 +1,252 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A file mapped read-write into memory in full, through mmap on POSIX systems
+// and a file mapping on Windows. Writes to data() reach the file; flush()
+// waits until a range of them is on disk.
+//
+// resize() changes the file's length and maps it again, usually at another
+// address, so callers keep offsets into the file rather than pointers.
+// Failures of the underlying calls throw std::system_error; a resize() that
+// fails leaves the file mapped at its old length.
+class MappedFile {
+private:
+#if defined(_WIN32)
+	HANDLE m_file{ INVALID_HANDLE_VALUE };
+	HANDLE m_mapping{ nullptr };
+#else
+	int m_file{ -1 };
+#endif
+	std::byte* m_data{ nullptr };
+	size_t m_size{ 0 };
+
+	std::byte* map(size_t bytes);
+	void unmap() noexcept;
+	[[noreturn]] static void fail(const std::string& what);
+public:
+	// Opens path, creating an empty file if there is none.
+	explicit MappedFile(const std::string& path);
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+
+	std::byte* data() const noexcept { return m_data; }
+	size_t size() const noexcept { return m_size; }
+
+	void resize(size_t bytes);
+	void flush(size_t offset, size_t bytes);
+};
+
+#if defined(_WIN32)
+
+inline MappedFile::MappedFile(const std::string& path) {
+	m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+		OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+		fail("cannot open " + path);
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size)) {
+		CloseHandle(m_file);
+		fail("cannot read the size of " + path);
+	}
+
+	m_size = static_cast<size_t>(size.QuadPart);
+	try {
+		m_data = map(m_size);
+	}
+	catch (...) {
+		CloseHandle(m_file);
+		throw;
+	}
+}
+
+inline MappedFile::~MappedFile() {
+	unmap();
+	CloseHandle(m_file);
+}
+
+// Maps the first bytes of the file, extending it if it is shorter, and keeps
+// the mapping handle in m_mapping; the caller has released the previous one.
+inline std::byte* MappedFile::map(size_t bytes) {
+	if (bytes == 0)
+		return nullptr;
+
+	auto size = static_cast<uint64_t>(bytes);
+	HANDLE mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+	if (!mapping)
+		fail("cannot map file");
+
+	auto data = static_cast<std::byte*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes));
+	if (!data) {
+		DWORD error = GetLastError();
+		CloseHandle(mapping);
+		SetLastError(error);
+		fail("cannot map file");
+	}
+
+	m_mapping = mapping;
+	return data;
+}
+
+inline void MappedFile::unmap() noexcept {
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+
+	m_data = nullptr;
+	m_mapping = nullptr;
+}
+
+// A larger mapping extends the file itself, so growing maps the new length
+// before letting the old view go. A mapped file cannot be cut, so shrinking
+// unmaps first and maps the old length again if the cut fails.
+inline void MappedFile::resize(size_t bytes) {
+	if (bytes >= m_size) {
+		HANDLE mapping = m_mapping;
+		std::byte* data = m_data;
+		std::byte* grown = map(bytes);
+
+		if (data)
+			UnmapViewOfFile(data);
+		if (mapping)
+			CloseHandle(mapping);
+		m_data = grown;
+		m_size = bytes;
+		return;
+	}
+
+	unmap();
+
+	LARGE_INTEGER size;
+	size.QuadPart = static_cast<LONGLONG>(bytes);
+	if (!SetFilePointerEx(m_file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file)) {
+		DWORD error = GetLastError();
+		m_data = map(m_size);
+		SetLastError(error);
+		fail("cannot resize file");
+	}
+
+	m_size = bytes;
+	m_data = map(m_size);
+}
+
+inline void MappedFile::flush(size_t offset, size_t bytes) {
+	if (!m_data || bytes == 0)
+		return;
+
+	if (!FlushViewOfFile(m_data + offset, bytes) || !FlushFileBuffers(m_file))
+		fail("cannot flush file");
+}
+
+inline void MappedFile::fail(const std::string& what) {
+	throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "MappedFile: " + what);
+}
+
+#else
+
+inline MappedFile::MappedFile(const std::string& path) {
+	m_file = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (m_file < 0)
+		fail("cannot open " + path);
+
+	struct stat status;
+	if (::fstat(m_file, &status) != 0) {
+		::close(m_file);
+		fail("cannot read the size of " + path);
+	}
+
+	m_size = static_cast<size_t>(status.st_size);
+	try {
+		m_data = map(m_size);
+	}
+	catch (...) {
+		::close(m_file);
+		throw;
+	}
+}
+
+inline MappedFile::~MappedFile() {
+	unmap();
+	::close(m_file);
+}
+
+// Maps the first bytes of the file; null for an empty one.
+inline std::byte* MappedFile::map(size_t bytes) {
+	if (bytes == 0)
+		return nullptr;
+
+	void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+	if (address == MAP_FAILED)
+		fail("cannot map file");
+
+	return static_cast<std::byte*>(address);
+}
+
+inline void MappedFile::unmap() noexcept {
+	if (m_data)
+		::munmap(m_data, m_size);
+
+	m_data = nullptr;
+}
+
+// The old mapping stays until the new one is in place, so a failure leaves it
+// usable. A file that grows is extended, and the new length made durable,
+// before it is mapped again, so a flush of the larger mapping never refers to
+// pages past the end of the file on disk; one that shrinks is cut only once
+// the smaller mapping exists.
+inline void MappedFile::resize(size_t bytes) {
+	if (bytes > m_size && (::ftruncate(m_file, static_cast<off_t>(bytes)) != 0 || ::fsync(m_file) != 0))
+		fail("cannot resize file");
+
+	std::byte* data = map(bytes);
+	if (bytes < m_size && (::ftruncate(m_file, static_cast<off_t>(bytes)) != 0 || ::fsync(m_file) != 0)) {
+		int error = errno;
+		if (data)
+			::munmap(data, bytes);
+		errno = error;
+		fail("cannot resize file");
+	}
+
+	unmap();
+	m_data = data;
+	m_size = bytes;
+}
+
+inline void MappedFile::flush(size_t offset, size_t bytes) {
+	if (!m_data || bytes == 0)
+		return;
+
+	// msync takes a page-aligned address
+	size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+	size_t start = offset - offset % page;
+	if (::msync(m_data + start, offset + bytes - start, MS_SYNC) != 0)
+		fail("cannot flush file");
+}
+
+inline void MappedFile::fail(const std::string& what) {
+	throw std::system_error(errno, std::generic_category(), "MappedFile: " + what);
+}
+
+#endif
@@ -0,0 +1,611 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "MappedFile.h"
+
+// Singly linked list kept in a memory-mapped file, so it can be larger than
+// RAM and is still there when the process restarts.
+//
+// Nodes hold their element and the file offset of the next node rather than
+// a pointer, so the file means the same wherever it is mapped. Opening an
+// existing file only maps it and checks its header: there is no
+// deserialization, and startup takes the same time however long the list.
+// Nodes freed by pop() and remove() are kept on a free list in the file and
+// reused by later inserts; the file grows by doubling when it runs out.
+//
+// sync() is the durability point: once it returns, the list as it stands is
+// on disk, and the destructor calls it. Pages changed since reach the file in
+// whatever order the kernel writes them back, so nothing the last sync()
+// left on disk is written in place before the next one:
+//
+//  - the list's head, tail, size and free list live in memory and are
+//    written to one of two header slots, the one the last sync() did not
+//    use, and only after everything they refer to is on disk;
+//  - a new link out of a node the last sync() saw is kept in memory and
+//    written to the file, as a redo log, at the next sync(), which commits
+//    the header first and applies the log after;
+//  - a node the last sync() saw is not reused until the next one.
+//
+// After a crash, opening the file finds the newest header whose checksum
+// holds and gets the list as that sync() left it. Only the free list needs
+// rebuilding, by walking the list once, since nodes that were free at the
+// last sync() may have been taken since.
+//
+// Between syncs a walk looks each node it passes up among the links kept in
+// memory, which costs a hash lookup per node once the first node the last
+// sync() saw has been relinked.
+//
+// T must be trivially copyable, since elements are stored as their bytes,
+// and the file is only read back by a build with the same layout of T. One
+// MappedList at a time may have a file open.
+template <typename T>
+class MappedList {
+	static_assert(std::is_trivially_copyable_v<T>, "MappedList stores trivially copyable types only");
+public:
+	class Iterator;
+private:
+	struct Node {
+		T m_data;
+		uint64_t m_next;
+	};
+
+	// A link to set in the node at offset once the header naming it commits.
+	struct Patch {
+		uint64_t offset;
+		uint64_t next;
+	};
+
+	// Offsets are from the start of the file; 0, where the headers are, is
+	// null. Each header slot sits in a sector of its own.
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t element_size;
+		uint32_t element_alignment;
+		uint64_t generation;
+		uint64_t size;
+		uint64_t head;
+		uint64_t tail;
+		uint64_t free;
+		// offset just past the last node ever allocated
+		uint64_t used;
+		// the redo log, and whether it and the freed nodes are still to be
+		// applied
+		uint64_t patches;
+		uint64_t patch_count;
+		uint32_t pending;
+		uint32_t reserved;
+		// of everything above
+		uint64_t checksum;
+		// set once the list has changed since this header was written
+		uint32_t dirty;
+		uint32_t reserved2;
+	};
+
+	static constexpr char magic[4]{ 'D', 'S', 'A', 'M' };
+	static constexpr uint32_t version{ 2 };
+	static constexpr uint64_t header_slot{ 512 };
+	static constexpr uint64_t first_node{ (2 * header_slot + alignof(Node) - 1) / alignof(Node) * alignof(Node) };
+	static_assert(sizeof(Header) <= header_slot, "a header must fit its slot");
+
+	MappedFile m_file;
+	// the list as it stands, which sync() writes to a header slot
+	Header m_state{};
+	// links out of nodes the last sync() saw, nodes the last sync() saw that
+	// have been freed, and free nodes of the last sync() since reused
+	std::unordered_map<uint64_t, uint64_t> m_patches;
+	std::vector<uint64_t> m_released;
+	std::unordered_set<uint64_t> m_reused;
+	uint64_t m_synced_used{ 0 };
+	bool m_changed{ false };
+
+	Header& slot(uint64_t generation) const noexcept {
+		return *reinterpret_cast<Header*>(m_file.data() + generation % 2 * header_slot);
+	}
+	Node& node(uint64_t offset) const noexcept { return *reinterpret_cast<Node*>(m_file.data() + offset); }
+
+	static uint64_t checksum(const Header& header) noexcept;
+	bool synced(uint64_t offset) const noexcept;
+	uint64_t next(uint64_t offset) const noexcept;
+	void link(uint64_t offset, uint64_t next);
+
+	void create(size_t initial_nodes);
+	void open();
+	void recover();
+	void commit(uint64_t patches, uint64_t patch_count, bool pending);
+	void reserve(uint64_t bytes);
+	void modify();
+	uint64_t allocate(T data, uint64_t next);
+	void release(uint64_t offset);
+	uint64_t unlink(uint64_t prev, uint64_t offset);
+public:
+	// Opens the list in path, or creates an empty one with room for
+	// initial_nodes nodes if the file is empty or missing.
+	explicit MappedList(const std::string& path, size_t initial_nodes = 1024);
+	MappedList(const MappedList&) = delete;
+	MappedList& operator=(const MappedList&) = delete;
+	~MappedList();
+
+	Iterator begin() const noexcept { return Iterator(this, m_state.head); }
+	Iterator end() const noexcept { return Iterator(this, 0); }
+
+	void append(T data);
+	void insert(int index, T data);
+	T pop(std::optional<size_t> index = std::nullopt);
+	void remove(T data);
+	void remove_all(T data);
+	T index(size_t index) const;
+	int count(T data) const;
+	void clear();
+	size_t size() const noexcept { return static_cast<size_t>(m_state.size); }
+
+	void sync();
+	// Bytes the file takes, including the headers and free nodes.
+	size_t file_size() const noexcept { return m_file.size(); }
+};
+
+// Refers to the list and an offset, not to memory, so it stays valid when the
+// file grows and is mapped again; it is invalidated by removing its node.
+template <typename T>
+class MappedList<T>::Iterator {
+private:
+	const MappedList* m_list;
+	uint64_t m_offset;
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
+	Iterator(const MappedList* list, uint64_t offset) noexcept : m_list(list), m_offset(offset) {};
+
+	const T& operator*() const noexcept { return m_list->node(m_offset).m_data; }
+
+	Iterator& operator++() noexcept {
+		m_offset = m_list->next(m_offset);
+		return *this;
+	}
+
+	Iterator operator++(int) noexcept {
+		Iterator iterator = *this;
+		++*this;
+		return iterator;
+	}
+
+	bool operator==(const Iterator& other) const noexcept { return m_offset == other.m_offset; }
+	bool operator!=(const Iterator& other) const noexcept { return m_offset != other.m_offset; }
+};
+
+template <typename T>
+MappedList<T>::MappedList(const std::string& path, size_t initial_nodes) : m_file(path) {
+	if (m_file.size() == 0)
+		create(initial_nodes);
+	else
+		open();
+}
+
+// Errors from the final sync cannot be reported here; callers that need to
+// know the list reached the disk call sync() themselves first.
+template <typename T>
+MappedList<T>::~MappedList() {
+	try {
+		sync();
+	}
+	catch (...) {}
+}
+
+// FNV-1a over the header up to its checksum.
+template <typename T>
+uint64_t MappedList<T>::checksum(const Header& header) noexcept {
+	auto bytes = reinterpret_cast<const unsigned char*>(&header);
+	uint64_t hash{ 14695981039346656037ull };
+
+	for (size_t idx = 0; idx < offsetof(Header, checksum); ++idx) {
+		hash ^= bytes[idx];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+// Whether the last sync() may have left the node at offset in the list, so
+// that it must not be written until the next one.
+template <typename T>
+bool MappedList<T>::synced(uint64_t offset) const noexcept {
+
+	return offset < m_synced_used && m_reused.count(offset) == 0;
+}
+
+template <typename T>
+uint64_t MappedList<T>::next(uint64_t offset) const noexcept {
+	if (!m_patches.empty()) {
+		auto patch = m_patches.find(offset);
+		if (patch != m_patches.end())
+			return patch->second;
+	}
+
+	return node(offset).m_next;
+}
+
+template <typename T>
+void MappedList<T>::link(uint64_t offset, uint64_t next) {
+	if (synced(offset))
+		m_patches[offset] = next;
+	else
+		node(offset).m_next = next;
+}
+
+template <typename T>
+void MappedList<T>::create(size_t initial_nodes) {
+	m_file.resize(static_cast<size_t>(first_node + (initial_nodes ? initial_nodes : 1) * sizeof(Node)));
+	std::memset(m_file.data(), 0, static_cast<size_t>(first_node));
+
+	std::memcpy(m_state.magic, magic, sizeof(magic));
+	m_state.version = version;
+	m_state.element_size = sizeof(T);
+	m_state.element_alignment = alignof(T);
+	m_state.used = first_node;
+	m_synced_used = first_node;
+	commit(0, 0, false);
+}
+
+template <typename T>
+void MappedList<T>::open() {
+	if (m_file.size() < first_node)
+		throw std::runtime_error("MappedList file is too short to hold a list");
+
+	const Header* newest{ nullptr };
+	for (uint64_t idx = 0; idx < 2; ++idx) {
+		const Header& candidate = slot(idx);
+		if (std::memcmp(candidate.magic, magic, sizeof(magic)) != 0 || candidate.version != version)
+			continue;
+		if (candidate.checksum != checksum(candidate))
+			continue;
+		if (!newest || candidate.generation > newest->generation)
+			newest = &candidate;
+	}
+
+	if (!newest)
+		throw std::runtime_error("MappedList file does not hold a list");
+	if (newest->element_size != sizeof(T) || newest->element_alignment != alignof(T))
+		throw std::runtime_error("MappedList file holds elements of another type");
+	if (newest->used > m_file.size() || newest->patches + newest->patch_count * sizeof(Patch) > m_file.size())
+		throw std::runtime_error("MappedList file is truncated");
+
+	m_state = *newest;
+	m_synced_used = m_state.used;
+	if (m_state.pending || m_state.dirty)
+		recover();
+}
+
+// Finishes a sync() that committed its header but was cut short, replaying
+// the redo log, and rebuilds the free list, which changes made after the
+// header may have taken nodes from; then commits the result.
+template <typename T>
+void MappedList<T>::recover() {
+	if (m_state.pending) {
+		auto log = reinterpret_cast<const Patch*>(m_file.data() + m_state.patches);
+		for (uint64_t idx = 0; idx < m_state.patch_count; ++idx)
+			node(log[idx].offset).m_next = log[idx].next;
+	}
+
+	uint64_t nodes = (m_state.used - first_node) / sizeof(Node);
+	std::vector<bool> linked(static_cast<size_t>(nodes), false);
+	uint64_t current = m_state.head;
+	for (uint64_t position = 0; position < m_state.size; ++position) {
+		if (current < first_node || current >= m_state.used || linked[static_cast<size_t>((current - first_node) / sizeof(Node))])
+			throw std::runtime_error("MappedList file holds a broken list");
+
+		linked[static_cast<size_t>((current - first_node) / sizeof(Node))] = true;
+		current = node(current).m_next;
+	}
+
+	m_state.free = 0;
+	for (uint64_t idx = nodes; idx > 0; --idx) {
+		if (linked[static_cast<size_t>(idx - 1)])
+			continue;
+
+		uint64_t offset = first_node + (idx - 1) * sizeof(Node);
+		node(offset).m_next = m_state.free;
+		m_state.free = offset;
+	}
+
+	m_file.flush(static_cast<size_t>(first_node), static_cast<size_t>(m_state.used - first_node));
+	commit(0, 0, false);
+}
+
+// Writes m_state to the slot the newest header is not in, with the next
+// generation, and makes it durable.
+template <typename T>
+void MappedList<T>::commit(uint64_t patches, uint64_t patch_count, bool pending) {
+	m_state.generation += 1;
+	m_state.patches = patches;
+	m_state.patch_count = patch_count;
+	m_state.pending = pending ? 1 : 0;
+	m_state.reserved = 0;
+	m_state.checksum = checksum(m_state);
+	m_state.dirty = 0;
+	m_state.reserved2 = 0;
+
+	slot(m_state.generation) = m_state;
+	m_file.flush(static_cast<size_t>(m_state.generation % 2 * header_slot), sizeof(Header));
+}
+
+// Grows the file, by doubling, until it holds bytes.
+template <typename T>
+void MappedList<T>::reserve(uint64_t bytes) {
+	size_t size = m_file.size();
+	while (size < bytes)
+		size *= 2;
+
+	if (size != m_file.size())
+		m_file.resize(size);
+}
+
+// Marks the newest header as changed since, and makes that mark durable,
+// before the first change after a sync(). The mark is outside the checksum,
+// so the header stays valid.
+template <typename T>
+void MappedList<T>::modify() {
+	if (m_changed)
+		return;
+
+	m_changed = true;
+	slot(m_state.generation).dirty = 1;
+	m_file.flush(static_cast<size_t>(m_state.generation % 2 * header_slot), sizeof(Header));
+}
+
+// Takes a node from the free list, or from the end of the used part of the
+// file, growing the file if it is full.
+template <typename T>
+uint64_t MappedList<T>::allocate(T data, uint64_t next) {
+	uint64_t offset = m_state.free;
+
+	if (offset) {
+		m_state.free = this->next(offset);
+		if (offset < m_synced_used)
+			m_reused.insert(offset);
+	}
+	else {
+		reserve(m_state.used + sizeof(Node));
+		offset = m_state.used;
+		m_state.used += sizeof(Node);
+	}
+
+	::new (m_file.data() + offset) Node{ data, next };
+
+	return offset;
+}
+
+// Puts a node on the free list, or, if the last sync() saw it, keeps it
+// aside until the next one.
+template <typename T>
+void MappedList<T>::release(uint64_t offset) {
+	if (synced(offset)) {
+		m_patches.erase(offset);
+		m_released.push_back(offset);
+	}
+	else {
+		node(offset).m_next = m_state.free;
+		m_state.free = offset;
+	}
+}
+
+// Unlinks the node at offset, which follows prev (0 for the head), and
+// returns the offset of the node after it.
+template <typename T>
+uint64_t MappedList<T>::unlink(uint64_t prev, uint64_t offset) {
+	uint64_t following = next(offset);
+
+	if (prev)
+		link(prev, following);
+	else
+		m_state.head = following;
+
+	if (m_state.tail == offset)
+		m_state.tail = prev;
+
+	--m_state.size;
+	release(offset);
+
+	return following;
+}
+
+template <typename T>
+void MappedList<T>::append(T data) {
+	modify();
+	uint64_t offset = allocate(data, 0);
+
+	if (m_state.tail)
+		link(m_state.tail, offset);
+	else
+		m_state.head = offset;
+
+	m_state.tail = offset;
+	++m_state.size;
+}
+
+// Inserts data before the element at index; an index at or past the end, or
+// negative, appends it, as SinglyLinkedList does.
+template <typename T>
+void MappedList<T>::insert(int index, T data) {
+	if (index < 0 || static_cast<size_t>(index) >= size()) {
+		append(data);
+		return;
+	}
+
+	modify();
+
+	uint64_t prev{ 0 };
+	uint64_t current = m_state.head;
+	for (int position = 0; position < index; ++position) {
+		prev = current;
+		current = next(current);
+	}
+
+	uint64_t offset = allocate(data, current);
+	if (prev)
+		link(prev, offset);
+	else
+		m_state.head = offset;
+
+	++m_state.size;
+}
+
+// Removes and returns the element at index, the last one by default.
+template <typename T>
+T MappedList<T>::pop(std::optional<size_t> index) {
+	size_t position = index.value_or(size() - 1);
+	if (size() == 0 || position >= size())
+		throw std::out_of_range("MappedList index out of range");
+
+	modify();
+
+	uint64_t prev{ 0 };
+	uint64_t current = m_state.head;
+	for (size_t idx = 0; idx < position; ++idx) {
+		prev = current;
+		current = next(current);
+	}
+
+	T data = node(current).m_data;
+	unlink(prev, current);
+
+	return data;
+}
+
+template <typename T>
+void MappedList<T>::remove(T data) {
+	uint64_t prev{ 0 };
+
+	for (uint64_t current = m_state.head; current; current = next(current)) {
+		if (node(current).m_data == data) {
+			modify();
+			unlink(prev, current);
+			return;
+		}
+
+		prev = current;
+	}
+}
+
+template <typename T>
+void MappedList<T>::remove_all(T data) {
+	uint64_t prev{ 0 };
+	uint64_t current = m_state.head;
+
+	while (current) {
+		if (node(current).m_data == data) {
+			modify();
+			current = unlink(prev, current);
+		}
+		else {
+			prev = current;
+			current = next(current);
+		}
+	}
+}
+
+template <typename T>
+T MappedList<T>::index(size_t index) const {
+	if (index >= size())
+		throw std::out_of_range("MappedList index out of range");
+
+	uint64_t current = m_state.head;
+	for (size_t position = 0; position < index; ++position)
+		current = next(current);
+
+	return node(current).m_data;
+}
+
+template <typename T>
+int MappedList<T>::count(T data) const {
+	int cnt{ 0 };
+
+	for (uint64_t current = m_state.head; current; current = next(current)) {
+		if (node(current).m_data == data)
+			++cnt;
+	}
+
+	return cnt;
+}
+
+// Empties the list, freeing every node without shrinking the file; later
+// inserts reuse them.
+template <typename T>
+void MappedList<T>::clear() {
+	modify();
+
+	for (uint64_t current = m_state.head; current;) {
+		uint64_t following = next(current);
+		release(current);
+		current = following;
+	}
+
+	m_state.size = 0;
+	m_state.head = 0;
+	m_state.tail = 0;
+}
+
+// Writes every change since the last sync to disk and returns once the list
+// as it stands is durable:
+//
+//  1. the nodes written since and the redo log, placed past the last node,
+//     reach the disk;
+//  2. a header naming the log, marked pending, is committed to the other
+//     slot, which is the point where reopening sees the new list;
+//  3. the log is applied and the nodes kept aside are put on the free list,
+//     in place, now that no committed header reaches them;
+//  4. a header without the log is committed, so the space it took can be
+//     handed out again.
+//
+// A list that relinked no node the last sync() saw needs only steps 1 and 4.
+template <typename T>
+void MappedList<T>::sync() {
+	if (!m_changed)
+		return;
+
+	uint64_t log{ 0 };
+	if (!m_patches.empty() || !m_released.empty()) {
+		log = m_state.used;
+		reserve(log + m_patches.size() * sizeof(Patch));
+
+		auto entries = reinterpret_cast<Patch*>(m_file.data() + log);
+		for (const auto& patch : m_patches)
+			*entries++ = Patch{ patch.first, patch.second };
+	}
+
+	m_file.flush(static_cast<size_t>(first_node), static_cast<size_t>(m_state.used + m_patches.size() * sizeof(Patch) - first_node));
+
+	if (log) {
+		commit(log, m_patches.size(), true);
+
+		for (const auto& patch : m_patches)
+			node(patch.first).m_next = patch.second;
+		for (uint64_t offset : m_released) {
+			node(offset).m_next = m_state.free;
+			m_state.free = offset;
+		}
+
+		m_file.flush(static_cast<size_t>(first_node), static_cast<size_t>(m_state.used - first_node));
+	}
+
+	commit(0, 0, false);
+
+	m_patches.clear();
+	m_released.clear();
+	m_reused.clear();
+	m_synced_used = m_state.used;
+	m_changed = false;
+}
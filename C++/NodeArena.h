@@ -0,0 +1,128 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Bump allocator that hands out list nodes from large contiguous blocks, so
+// nodes allocated one after another end up next to each other in memory.
+//
+// Memory is never reused; the blocks are returned all at once when the owner
+// has released the arena and the last node allocated from it is gone. Every
+// allocation and the owner each hold one reference.
+class NodeArena {
+private:
+	std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+	size_t m_block_size;
+	size_t m_offset{ 0 };
+	size_t m_capacity{ 0 };
+	std::atomic<size_t> m_references{ 1 };
+
+	explicit NodeArena(size_t block_size) : m_block_size(block_size) {};
+	~NodeArena() = default;
+	void unreference() noexcept;
+public:
+	NodeArena(const NodeArena&) = delete;
+	NodeArena& operator=(const NodeArena&) = delete;
+
+	static std::shared_ptr<NodeArena> create(size_t block_size);
+
+	void* allocate(size_t bytes, size_t alignment);
+	void deallocate(void* address, size_t bytes) noexcept;
+	size_t blocks() const noexcept { return m_blocks.size(); }
+};
+
+// Drops the owner reference when the last shared_ptr to the arena goes away.
+inline std::shared_ptr<NodeArena> NodeArena::create(size_t block_size) {
+	return std::shared_ptr<NodeArena>(new NodeArena(block_size), [](NodeArena* arena) {
+		arena->unreference();
+	});
+}
+
+inline void* NodeArena::allocate(size_t bytes, size_t alignment) {
+	size_t padding = (alignment - (m_offset % alignment)) % alignment;
+
+	if (m_blocks.empty() || m_offset + padding + bytes > m_capacity) {
+		m_capacity = bytes + alignment > m_block_size ? bytes + alignment : m_block_size;
+		m_blocks.emplace_back(new std::byte[m_capacity]);
+		m_offset = 0;
+
+		auto base = reinterpret_cast<uintptr_t>(m_blocks.back().get());
+		padding = (alignment - (base % alignment)) % alignment;
+	}
+
+	void* address = m_blocks.back().get() + m_offset + padding;
+	m_offset += padding + bytes;
+	m_references.fetch_add(1, std::memory_order_relaxed);
+
+	return address;
+}
+
+inline void NodeArena::deallocate(void*, size_t) noexcept {
+	unreference();
+}
+
+inline void NodeArena::unreference() noexcept {
+	if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete this;
+}
+
+// Standard allocator over a NodeArena, used with std::allocate_shared so the
+// control block and the node share one arena slot.
+template <typename T>
+class ArenaAllocator {
+	template <typename U>
+	friend class ArenaAllocator;
+private:
+	NodeArena* m_arena;
+public:
+	using value_type = T;
+
+	explicit ArenaAllocator(NodeArena* arena) noexcept : m_arena(arena) {};
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.m_arena) {};
+
+	T* allocate(size_t count) {
+		return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* address, size_t count) noexcept {
+		m_arena->deallocate(address, count * sizeof(T));
+	}
+
+	template <typename U>
+	bool operator==(const ArenaAllocator<U>& other) const noexcept {
+		return m_arena == other.m_arena;
+	}
+
+	template <typename U>
+	bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+		return m_arena != other.m_arena;
+	}
+};
+
+// Where an incremental compaction pass stopped. prev is the last node already
+// relocated; it stays valid until the list unlinks a node, which bumps the
+// list's generation and makes the pass seek back to position from the head.
+// Lists whose nodes are not reference counted relocate them through their
+// own allocator and leave arena null.
+template <typename Node>
+struct CompactionCursor {
+	bool running{ false };
+	std::shared_ptr<NodeArena> arena{ nullptr };
+	Node* prev{ nullptr };
+	size_t position{ 0 };
+	size_t generation{ 0 };
+};
+
+// Arena block size for relocating node_count nodes of node_size bytes; the
+// extra words cover the shared_ptr control block stored with each node.
+inline size_t compaction_block_size(size_t node_count, size_t node_size) {
+	const size_t max_nodes_per_block{ 1 << 16 };
+	size_t nodes = node_count < max_nodes_per_block ? node_count : max_nodes_per_block;
+
+	return (nodes ? nodes : 1) * (node_size + 4 * sizeof(void*));
+}
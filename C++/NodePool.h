@@ -0,0 +1,181 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Fixed-size slot allocator for containers that create and destroy nodes all
+// the time, such as the recency list and hash map of an LRU cache.
+//
+// Requests are rounded up to a multiple of the slot granularity and served
+// from one free list per size class; a freed slot goes back on its free list
+// and is handed out again by the next request of that class. Empty free lists
+// are refilled a block at a time. Requests larger than max_slot_bytes or
+// aligned beyond the granularity go to the global operator new.
+//
+// A pool serves one container at a time and is not thread-safe. Memory is
+// returned all at once when the last reference goes away; every PoolAllocator
+// copy holds one.
+class NodePool {
+public:
+	static constexpr size_t granularity{ alignof(std::max_align_t) };
+	static constexpr size_t size_classes{ 16 };
+	static constexpr size_t max_slot_bytes{ granularity * size_classes };
+private:
+	struct FreeSlot {
+		FreeSlot* next;
+	};
+
+	std::array<FreeSlot*, size_classes> m_free{};
+	std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+	size_t m_block_size;
+	size_t m_live_slots{ 0 };
+	std::atomic<size_t> m_references{ 1 };
+
+	explicit NodePool(size_t block_size) : m_block_size(block_size) {};
+	~NodePool() = default;
+	static bool pooled(size_t bytes, size_t alignment) noexcept;
+	void refill(size_t size_class);
+public:
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	static NodePool* create(size_t block_size = 64 * 1024) { return new NodePool(block_size); }
+
+	void reference() noexcept;
+	void unreference() noexcept;
+
+	void* allocate(size_t bytes, size_t alignment);
+	void deallocate(void* address, size_t bytes, size_t alignment) noexcept;
+
+	size_t blocks() const noexcept { return m_blocks.size(); }
+	size_t live_slots() const noexcept { return m_live_slots; }
+};
+
+inline void NodePool::reference() noexcept {
+	m_references.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void NodePool::unreference() noexcept {
+	if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete this;
+}
+
+inline bool NodePool::pooled(size_t bytes, size_t alignment) noexcept {
+
+	return bytes > 0 && bytes <= max_slot_bytes && alignment <= granularity;
+}
+
+// Carves a new block into slots of one size class and threads them onto its
+// free list.
+inline void NodePool::refill(size_t size_class) {
+	size_t slot_bytes = (size_class + 1) * granularity;
+	size_t slots = m_block_size / slot_bytes;
+	if (slots == 0)
+		slots = 1;
+
+	m_blocks.emplace_back(new std::byte[slots * slot_bytes]);
+	std::byte* block = m_blocks.back().get();
+
+	for (size_t idx = slots; idx-- > 0;) {
+		auto slot = reinterpret_cast<FreeSlot*>(block + idx * slot_bytes);
+		slot->next = m_free[size_class];
+		m_free[size_class] = slot;
+	}
+}
+
+inline void* NodePool::allocate(size_t bytes, size_t alignment) {
+	if (!pooled(bytes, alignment)) {
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			return ::operator new(bytes, std::align_val_t{ alignment });
+		return ::operator new(bytes);
+	}
+
+	size_t size_class = (bytes - 1) / granularity;
+	if (!m_free[size_class])
+		refill(size_class);
+
+	FreeSlot* slot = m_free[size_class];
+	m_free[size_class] = slot->next;
+	++m_live_slots;
+
+	return slot;
+}
+
+inline void NodePool::deallocate(void* address, size_t bytes, size_t alignment) noexcept {
+	if (!pooled(bytes, alignment)) {
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			::operator delete(address, std::align_val_t{ alignment });
+		else
+			::operator delete(address);
+		return;
+	}
+
+	size_t size_class = (bytes - 1) / granularity;
+	auto slot = static_cast<FreeSlot*>(address);
+	slot->next = m_free[size_class];
+	m_free[size_class] = slot;
+	--m_live_slots;
+}
+
+// Standard allocator over a NodePool. A default-constructed PoolAllocator
+// starts a fresh pool; copies and rebinds share it, so a container's nodes
+// and anything it rebinds the allocator for draw from the same free lists.
+template <typename T>
+class PoolAllocator {
+	template <typename U>
+	friend class PoolAllocator;
+private:
+	NodePool* m_pool;
+public:
+	using value_type = T;
+
+	PoolAllocator() : m_pool(NodePool::create()) {};
+
+	explicit PoolAllocator(NodePool* pool) noexcept : m_pool(pool) {
+		m_pool->reference();
+	}
+
+	PoolAllocator(const PoolAllocator& other) noexcept : m_pool(other.m_pool) {
+		m_pool->reference();
+	}
+
+	template <typename U>
+	PoolAllocator(const PoolAllocator<U>& other) noexcept : m_pool(other.m_pool) {
+		m_pool->reference();
+	}
+
+	PoolAllocator& operator=(const PoolAllocator& other) noexcept {
+		other.m_pool->reference();
+		m_pool->unreference();
+		m_pool = other.m_pool;
+
+		return *this;
+	}
+
+	~PoolAllocator() {
+		m_pool->unreference();
+	}
+
+	T* allocate(size_t count) {
+		return static_cast<T*>(m_pool->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* address, size_t count) noexcept {
+		m_pool->deallocate(address, count * sizeof(T), alignof(T));
+	}
+
+	NodePool* pool() const noexcept { return m_pool; }
+
+	template <typename U>
+	bool operator==(const PoolAllocator<U>& other) const noexcept {
+		return m_pool == other.m_pool;
+	}
+
+	template <typename U>
+	bool operator!=(const PoolAllocator<U>& other) const noexcept {
+		return m_pool != other.m_pool;
+	}
+};
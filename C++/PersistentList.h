@@ -0,0 +1,187 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+// Immutable singly linked list whose versions share structure.
+//
+// push_front() returns a new list whose node points at this list's head, so
+// a new version costs one node however long the list is, and tail() returns
+// the list after the head without copying anything. The nodes are never
+// modified once linked, so any number of versions can share a tail and each
+// stays exactly as it was when it was made. Nodes are held by shared_ptr and
+// freed when the last version that reaches them goes away.
+//
+// A version is safe to read, iterate and derive new versions from on several
+// threads at once, as long as the Allocator is; the default std::allocator
+// is, PoolAllocator is not. An iterator stays valid as long as the list it
+// came from, or any list sharing that node, is alive.
+//
+// Versions are freed a node at a time, not recursively, so long chains do not
+// overflow the stack, also when several threads drop versions sharing a tail
+// at once: whichever thread lets a node go last frees the rest of its chain.
+template <typename T, typename Allocator = std::allocator<T>>
+class PersistentList {
+private:
+	struct Node {
+		T m_data;
+		// only ever reassigned by the destructor, once nothing else can see it
+		std::shared_ptr<Node> m_next;
+
+		Node(T value, std::shared_ptr<Node> next) : m_data(std::move(value)), m_next(std::move(next)) {};
+		~Node();
+	};
+
+	std::shared_ptr<Node> m_head{ nullptr };
+	size_t m_size{ 0 };
+	Allocator m_allocator;
+
+	PersistentList(std::shared_ptr<Node> head, size_t size, const Allocator& allocator) :
+		m_head(std::move(head)), m_size(size), m_allocator(allocator) {};
+	void release() noexcept;
+public:
+	class Iterator;
+
+	PersistentList() {};
+	explicit PersistentList(const Allocator& allocator) : m_allocator(allocator) {};
+	PersistentList(std::initializer_list<T> values, const Allocator& allocator = Allocator());
+	PersistentList(const PersistentList& other) = default;
+	PersistentList(PersistentList&& other) noexcept;
+	PersistentList& operator=(const PersistentList& other);
+	PersistentList& operator=(PersistentList&& other) noexcept;
+	~PersistentList() { release(); }
+
+	Iterator begin() const noexcept { return Iterator(m_head.get()); }
+	Iterator end() const noexcept { return Iterator(nullptr); }
+
+	PersistentList push_front(T data) const;
+	const T& front() const;
+	PersistentList tail() const;
+
+	size_t size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+	// True if both lists start at the same node, so are the same version.
+	bool same_version(const PersistentList& other) const noexcept { return m_head == other.m_head; }
+};
+
+template <typename T, typename Allocator>
+class PersistentList<T, Allocator>::Iterator {
+private:
+	const Node* m_current;
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
+	explicit Iterator(const Node* node) noexcept : m_current(node) {};
+
+	const T& operator*() const noexcept { return m_current->m_data; }
+	const T* operator->() const noexcept { return &m_current->m_data; }
+
+	Iterator& operator++() noexcept {
+		m_current = m_current->m_next.get();
+		return *this;
+	}
+
+	Iterator operator++(int) noexcept {
+		Iterator iterator = *this;
+		++*this;
+		return iterator;
+	}
+
+	bool operator==(const Iterator& other) const noexcept { return m_current == other.m_current; }
+	bool operator!=(const Iterator& other) const noexcept { return m_current != other.m_current; }
+};
+
+template <typename T, typename Allocator>
+PersistentList<T, Allocator>::PersistentList(std::initializer_list<T> values, const Allocator& allocator) :
+	m_allocator(allocator) {
+	for (auto value = std::rbegin(values); value != std::rend(values); ++value)
+		m_head = std::allocate_shared<Node>(m_allocator, *value, std::move(m_head));
+
+	m_size = values.size();
+}
+
+template <typename T, typename Allocator>
+PersistentList<T, Allocator>::PersistentList(PersistentList&& other) noexcept :
+	m_head(std::move(other.m_head)), m_size(std::exchange(other.m_size, 0)), m_allocator(other.m_allocator) {}
+
+template <typename T, typename Allocator>
+PersistentList<T, Allocator>& PersistentList<T, Allocator>::operator=(const PersistentList& other) {
+	if (this != &other) {
+		release();
+		m_head = other.m_head;
+		m_size = other.m_size;
+		m_allocator = other.m_allocator;
+	}
+
+	return *this;
+}
+
+template <typename T, typename Allocator>
+PersistentList<T, Allocator>& PersistentList<T, Allocator>::operator=(PersistentList&& other) noexcept {
+	if (this != &other) {
+		release();
+		m_head = std::move(other.m_head);
+		m_size = std::exchange(other.m_size, 0);
+		m_allocator = other.m_allocator;
+	}
+
+	return *this;
+}
+
+// Frees the nodes only this one reaches one at a time, stopping at the first
+// that some other version still reaches; letting m_next go would destroy the
+// chain recursively and overflow the stack on long lists. A count of 1 may
+// have been left by another thread dropping its version just now; the fence
+// orders its last reads of the node before the move below.
+//
+// Running in the destructor rather than in release() is what keeps this safe
+// when threads race: two versions dropped together may each see the shared
+// node's count at 2 and stop, but the one whose reset() takes it to 0 runs
+// this destructor on it and carries on from there. The recursion nests only
+// as often as such a race is lost, at most once per thread releasing.
+template <typename T, typename Allocator>
+PersistentList<T, Allocator>::Node::~Node() {
+	while (m_next && m_next.use_count() == 1) {
+		std::atomic_thread_fence(std::memory_order_acquire);
+		m_next = std::move(m_next->m_next);
+	}
+}
+
+// The nodes go with the head; see ~Node().
+template <typename T, typename Allocator>
+void PersistentList<T, Allocator>::release() noexcept {
+	m_head.reset();
+	m_size = 0;
+}
+
+// A new version with data in front of this one, which it shares; O(1).
+template <typename T, typename Allocator>
+PersistentList<T, Allocator> PersistentList<T, Allocator>::push_front(T data) const {
+
+	return PersistentList(std::allocate_shared<Node>(m_allocator, std::move(data), m_head), m_size + 1, m_allocator);
+}
+
+template <typename T, typename Allocator>
+const T& PersistentList<T, Allocator>::front() const {
+	if (!m_head)
+		throw std::out_of_range("PersistentList is empty");
+
+	return m_head->m_data;
+}
+
+// The version after the front element, shared with this one; O(1).
+template <typename T, typename Allocator>
+PersistentList<T, Allocator> PersistentList<T, Allocator>::tail() const {
+	if (!m_head)
+		throw std::out_of_range("PersistentList is empty");
+
+	return PersistentList(m_head->m_next, m_size - 1, m_allocator);
+}
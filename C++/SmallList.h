@@ -0,0 +1,371 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+// Singly linked list that keeps its first K nodes inside the list object and
+// only takes nodes from Allocator once it holds more than K elements, so the
+// short lists most callers make never touch the heap. Inline slots freed by
+// pop() and remove() are reused before the allocator is asked again, and a
+// list that shrinks back to K elements or fewer stops allocating.
+//
+// The interface follows SinglyLinkedList's. Nodes link by raw pointers, so
+// moving a list moves its elements one by one into the new object's slots
+// rather than stealing them, and invalidates its iterators. Allocator may be
+// std::allocator, PoolAllocator or any other allocator; it is rebound to the
+// node type.
+template <typename T, size_t K = 8, typename Allocator = std::allocator<T>>
+class SmallList {
+	static_assert(K > 0, "SmallList needs at least one inline node; use SinglyLinkedList otherwise");
+public:
+	class Iterator;
+private:
+	struct Node {
+		T m_data;
+		Node* m_next;
+
+		Node(T value, Node* next) : m_data(std::move(value)), m_next(next) {};
+	};
+
+	// what an unused inline slot holds
+	struct FreeSlot {
+		FreeSlot* m_next;
+	};
+
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+	alignas(Node) std::byte m_inline[K * sizeof(Node)];
+	FreeSlot* m_free{ nullptr };
+	// inline slots from m_inline_used on have never been handed out
+	size_t m_inline_used{ 0 };
+	Node* m_head{ nullptr };
+	Node* m_tail{ nullptr };
+	size_t m_size{ 0 };
+	size_t m_spilled{ 0 };
+	NodeAllocator m_allocator;
+
+	bool is_inline(const Node* node) const noexcept;
+	Node* create(T data, Node* next);
+	void destroy(Node* node) noexcept;
+	Node* unlink(Node* prev, Node* node) noexcept;
+public:
+	SmallList() {};
+	explicit SmallList(const Allocator& allocator) : m_allocator(allocator) {};
+	SmallList(T arr[], int size);
+	SmallList(const SmallList& other);
+	SmallList(SmallList&& other);
+	SmallList& operator=(const SmallList& other);
+	SmallList& operator=(SmallList&& other);
+	~SmallList() { clear(); }
+
+	Iterator begin() const noexcept { return Iterator(m_head); }
+	Iterator end() const noexcept { return Iterator(nullptr); }
+
+	void append(T data);
+	void insert(int index, T data);
+	T pop(std::optional<size_t> index = std::nullopt);
+	void remove(T data);
+	void remove_all(T data);
+	T index(size_t index) const;
+	int count(const T& data) const;
+	void clear() noexcept;
+	size_t size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+
+	static constexpr size_t inline_capacity() noexcept { return K; }
+	// Nodes that did not fit inline and came from the allocator.
+	size_t spilled() const noexcept { return m_spilled; }
+};
+
+template <typename T, size_t K, typename Allocator>
+class SmallList<T, K, Allocator>::Iterator {
+private:
+	const Node* m_current;
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
+	explicit Iterator(const Node* node) noexcept : m_current(node) {};
+
+	const T& operator*() const noexcept { return m_current->m_data; }
+	const T* operator->() const noexcept { return &m_current->m_data; }
+
+	Iterator& operator++() noexcept {
+		m_current = m_current->m_next;
+		return *this;
+	}
+
+	Iterator operator++(int) noexcept {
+		Iterator iterator = *this;
+		++*this;
+		return iterator;
+	}
+
+	bool operator==(const Iterator& other) const noexcept { return m_current == other.m_current; }
+	bool operator!=(const Iterator& other) const noexcept { return m_current != other.m_current; }
+};
+
+template <typename T, size_t K, typename Allocator>
+SmallList<T, K, Allocator>::SmallList(T arr[], int size) {
+	for (int idx = 0; idx < size; ++idx)
+		append(arr[idx]);
+}
+
+template <typename T, size_t K, typename Allocator>
+SmallList<T, K, Allocator>::SmallList(const SmallList& other) :
+	m_allocator(NodeTraits::select_on_container_copy_construction(other.m_allocator)) {
+	for (const T& value : other)
+		append(value);
+}
+
+template <typename T, size_t K, typename Allocator>
+SmallList<T, K, Allocator>::SmallList(SmallList&& other) : m_allocator(other.m_allocator) {
+	for (Node* node = other.m_head; node; node = node->m_next)
+		append(std::move(node->m_data));
+
+	other.clear();
+}
+
+template <typename T, size_t K, typename Allocator>
+SmallList<T, K, Allocator>& SmallList<T, K, Allocator>::operator=(const SmallList& other) {
+	if (this != &other) {
+		clear();
+		for (const T& value : other)
+			append(value);
+	}
+
+	return *this;
+}
+
+template <typename T, size_t K, typename Allocator>
+SmallList<T, K, Allocator>& SmallList<T, K, Allocator>::operator=(SmallList&& other) {
+	if (this != &other) {
+		clear();
+		for (Node* node = other.m_head; node; node = node->m_next)
+			append(std::move(node->m_data));
+
+		other.clear();
+	}
+
+	return *this;
+}
+
+template <typename T, size_t K, typename Allocator>
+bool SmallList<T, K, Allocator>::is_inline(const Node* node) const noexcept {
+	auto address = reinterpret_cast<const std::byte*>(node);
+
+	return !std::less<const std::byte*>()(address, m_inline)
+		&& std::less<const std::byte*>()(address, m_inline + sizeof(m_inline));
+}
+
+// Builds a node in a freed inline slot, else in one never used, else in
+// memory from the allocator.
+template <typename T, size_t K, typename Allocator>
+typename SmallList<T, K, Allocator>::Node* SmallList<T, K, Allocator>::create(T data, Node* next) {
+	if (m_free) {
+		FreeSlot* slot = m_free;
+		m_free = slot->m_next;
+		try {
+			return ::new (static_cast<void*>(slot)) Node(std::move(data), next);
+		}
+		catch (...) {
+			m_free = ::new (static_cast<void*>(slot)) FreeSlot{ m_free };
+			throw;
+		}
+	}
+
+	if (m_inline_used < K) {
+		Node* node = ::new (static_cast<void*>(m_inline + m_inline_used * sizeof(Node))) Node(std::move(data), next);
+		++m_inline_used;
+		return node;
+	}
+
+	Node* node = NodeTraits::allocate(m_allocator, 1);
+	try {
+		NodeTraits::construct(m_allocator, node, std::move(data), next);
+	}
+	catch (...) {
+		NodeTraits::deallocate(m_allocator, node, 1);
+		throw;
+	}
+	++m_spilled;
+
+	return node;
+}
+
+template <typename T, size_t K, typename Allocator>
+void SmallList<T, K, Allocator>::destroy(Node* node) noexcept {
+	if (is_inline(node)) {
+		node->~Node();
+		m_free = ::new (static_cast<void*>(node)) FreeSlot{ m_free };
+	}
+	else {
+		NodeTraits::destroy(m_allocator, node);
+		NodeTraits::deallocate(m_allocator, node, 1);
+		--m_spilled;
+	}
+}
+
+// Unlinks and destroys node, which follows prev (nullptr for the head), and
+// returns the node after it.
+template <typename T, size_t K, typename Allocator>
+typename SmallList<T, K, Allocator>::Node* SmallList<T, K, Allocator>::unlink(Node* prev, Node* node) noexcept {
+	Node* next = node->m_next;
+
+	if (prev)
+		prev->m_next = next;
+	else
+		m_head = next;
+
+	if (m_tail == node)
+		m_tail = prev;
+
+	destroy(node);
+	--m_size;
+
+	return next;
+}
+
+template <typename T, size_t K, typename Allocator>
+void SmallList<T, K, Allocator>::append(T data) {
+	Node* node = create(std::move(data), nullptr);
+
+	if (m_tail)
+		m_tail->m_next = node;
+	else
+		m_head = node;
+
+	m_tail = node;
+	++m_size;
+}
+
+// Inserts data before the element at index; an index at or past the end, or
+// negative, appends it, as SinglyLinkedList does.
+template <typename T, size_t K, typename Allocator>
+void SmallList<T, K, Allocator>::insert(int index, T data) {
+	if (index < 0 || static_cast<size_t>(index) >= m_size) {
+		append(std::move(data));
+		return;
+	}
+
+	Node* prev{ nullptr };
+	Node* current{ m_head };
+	for (int position = 0; position < index; ++position) {
+		prev = current;
+		current = current->m_next;
+	}
+
+	Node* node = create(std::move(data), current);
+	if (prev)
+		prev->m_next = node;
+	else
+		m_head = node;
+
+	++m_size;
+}
+
+// Removes and returns the element at index, the last one by default.
+template <typename T, size_t K, typename Allocator>
+T SmallList<T, K, Allocator>::pop(std::optional<size_t> index) {
+	if (m_size == 0 || index.value_or(m_size - 1) >= m_size)
+		throw std::out_of_range("SmallList index out of range");
+
+	size_t position = index.value_or(m_size - 1);
+	Node* prev{ nullptr };
+	Node* current{ m_head };
+	for (size_t idx = 0; idx < position; ++idx) {
+		prev = current;
+		current = current->m_next;
+	}
+
+	T data = std::move(current->m_data);
+	unlink(prev, current);
+
+	return data;
+}
+
+template <typename T, size_t K, typename Allocator>
+void SmallList<T, K, Allocator>::remove(T data) {
+	Node* prev{ nullptr };
+
+	for (Node* current = m_head; current; current = current->m_next) {
+		if (current->m_data == data) {
+			unlink(prev, current);
+			return;
+		}
+
+		prev = current;
+	}
+}
+
+// data is taken by value, as it may be one of the elements about to be freed.
+template <typename T, size_t K, typename Allocator>
+void SmallList<T, K, Allocator>::remove_all(T data) {
+	Node* prev{ nullptr };
+	Node* current{ m_head };
+
+	while (current) {
+		if (current->m_data == data)
+			current = unlink(prev, current);
+		else {
+			prev = current;
+			current = current->m_next;
+		}
+	}
+}
+
+template <typename T, size_t K, typename Allocator>
+T SmallList<T, K, Allocator>::index(size_t index) const {
+	if (index >= m_size)
+		throw std::out_of_range("SmallList index out of range");
+
+	const Node* current{ m_head };
+	for (size_t position = 0; position < index; ++position)
+		current = current->m_next;
+
+	return current->m_data;
+}
+
+template <typename T, size_t K, typename Allocator>
+int SmallList<T, K, Allocator>::count(const T& data) const {
+	int cnt{ 0 };
+
+	for (const Node* current = m_head; current; current = current->m_next) {
+		if (current->m_data == data)
+			++cnt;
+	}
+
+	return cnt;
+}
+
+// Frees every node; the inline slots are handed out from the first again.
+template <typename T, size_t K, typename Allocator>
+void SmallList<T, K, Allocator>::clear() noexcept {
+	for (Node* current = m_head; current;) {
+		Node* next = current->m_next;
+		if (is_inline(current))
+			current->~Node();
+		else {
+			NodeTraits::destroy(m_allocator, current);
+			NodeTraits::deallocate(m_allocator, current, 1);
+		}
+		current = next;
+	}
+
+	m_free = nullptr;
+	m_inline_used = 0;
+	m_head = nullptr;
+	m_tail = nullptr;
+	m_size = 0;
+	m_spilled = 0;
+}
@@ -0,0 +1,277 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Singly linked list of at most N elements, with every node in an array
+// inside the list object, so it never allocates. Nodes link by their index in
+// the array, using the narrowest unsigned type that can index N slots, and
+// nodes freed by pop() and remove() are kept on a free list and reused.
+// append() and insert() on a full list throw std::length_error.
+//
+// The interface follows SinglyLinkedList's. Every member is constexpr, so a
+// list can be built, changed and read during constant evaluation and a table
+// computed at compile time kept as a constexpr StaticList. For that the slots
+// are value-initialized when the list is made, which needs T to be default
+// constructible; a freed slot is reset to T() so it does not keep resources
+// alive.
+template <typename T, size_t N>
+class StaticList {
+	static_assert(N > 0, "StaticList needs room for at least one element");
+	static_assert(std::is_default_constructible_v<T>, "StaticList stores default constructible types only");
+public:
+	class Iterator;
+	// narrowest type indexing N slots with one value left over for null
+	using Index = std::conditional_t<N < UINT8_MAX, uint8_t,
+		std::conditional_t<N < UINT16_MAX, uint16_t,
+		std::conditional_t<N < UINT32_MAX, uint32_t, uint64_t>>>;
+private:
+	static constexpr Index null{ static_cast<Index>(-1) };
+
+	struct Node {
+		T m_data{};
+		Index m_next{ null };
+	};
+
+	Node m_nodes[N]{};
+	Index m_head{ null };
+	Index m_tail{ null };
+	Index m_free{ null };
+	// slots from m_used on have never been handed out
+	size_t m_used{ 0 };
+	size_t m_size{ 0 };
+
+	constexpr Index allocate(T data, Index next);
+	constexpr void release(Index slot);
+	constexpr Index unlink(Index prev, Index slot);
+public:
+	constexpr StaticList() {};
+	constexpr StaticList(const T arr[], int size);
+
+	constexpr Iterator begin() const noexcept { return Iterator(this, m_head); }
+	constexpr Iterator end() const noexcept { return Iterator(this, null); }
+
+	constexpr void append(T data);
+	constexpr void insert(int index, T data);
+	constexpr T pop(std::optional<size_t> index = std::nullopt);
+	constexpr void remove(T data);
+	constexpr void remove_all(T data);
+	constexpr T index(size_t index) const;
+	constexpr int count(const T& data) const;
+	constexpr void clear();
+	constexpr size_t size() const noexcept { return m_size; }
+	constexpr bool empty() const noexcept { return m_size == 0; }
+	constexpr bool full() const noexcept { return m_size == N; }
+	static constexpr size_t capacity() noexcept { return N; }
+};
+
+template <typename T, size_t N>
+class StaticList<T, N>::Iterator {
+private:
+	const StaticList* m_list;
+	Index m_slot;
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
+	constexpr Iterator(const StaticList* list, Index slot) noexcept : m_list(list), m_slot(slot) {};
+
+	constexpr const T& operator*() const noexcept { return m_list->m_nodes[m_slot].m_data; }
+	constexpr const T* operator->() const noexcept { return &m_list->m_nodes[m_slot].m_data; }
+
+	constexpr Iterator& operator++() noexcept {
+		m_slot = m_list->m_nodes[m_slot].m_next;
+		return *this;
+	}
+
+	constexpr Iterator operator++(int) noexcept {
+		Iterator iterator = *this;
+		++*this;
+		return iterator;
+	}
+
+	constexpr bool operator==(const Iterator& other) const noexcept { return m_slot == other.m_slot; }
+	constexpr bool operator!=(const Iterator& other) const noexcept { return m_slot != other.m_slot; }
+};
+
+template <typename T, size_t N>
+constexpr StaticList<T, N>::StaticList(const T arr[], int size) {
+	for (int idx = 0; idx < size; ++idx)
+		append(arr[idx]);
+}
+
+// Takes a slot from the free list, or the first one never used.
+template <typename T, size_t N>
+constexpr typename StaticList<T, N>::Index StaticList<T, N>::allocate(T data, Index next) {
+	if (m_size == N)
+		throw std::length_error("StaticList is full");
+
+	Index slot = m_free;
+	if (slot != null)
+		m_free = m_nodes[slot].m_next;
+	else
+		slot = static_cast<Index>(m_used++);
+
+	m_nodes[slot].m_data = std::move(data);
+	m_nodes[slot].m_next = next;
+	++m_size;
+
+	return slot;
+}
+
+template <typename T, size_t N>
+constexpr void StaticList<T, N>::release(Index slot) {
+	m_nodes[slot].m_data = T();
+	m_nodes[slot].m_next = m_free;
+	m_free = slot;
+	--m_size;
+}
+
+// Unlinks the node in slot, which follows prev (null for the head), and
+// returns the slot of the node after it.
+template <typename T, size_t N>
+constexpr typename StaticList<T, N>::Index StaticList<T, N>::unlink(Index prev, Index slot) {
+	Index next = m_nodes[slot].m_next;
+
+	if (prev != null)
+		m_nodes[prev].m_next = next;
+	else
+		m_head = next;
+
+	if (m_tail == slot)
+		m_tail = prev;
+
+	release(slot);
+
+	return next;
+}
+
+template <typename T, size_t N>
+constexpr void StaticList<T, N>::append(T data) {
+	Index slot = allocate(std::move(data), null);
+
+	if (m_tail != null)
+		m_nodes[m_tail].m_next = slot;
+	else
+		m_head = slot;
+
+	m_tail = slot;
+}
+
+// Inserts data before the element at index; an index at or past the end, or
+// negative, appends it, as SinglyLinkedList does.
+template <typename T, size_t N>
+constexpr void StaticList<T, N>::insert(int index, T data) {
+	if (index < 0 || static_cast<size_t>(index) >= m_size) {
+		append(std::move(data));
+		return;
+	}
+
+	Index prev{ null };
+	Index current{ m_head };
+	for (int position = 0; position < index; ++position) {
+		prev = current;
+		current = m_nodes[current].m_next;
+	}
+
+	Index slot = allocate(std::move(data), current);
+	if (prev != null)
+		m_nodes[prev].m_next = slot;
+	else
+		m_head = slot;
+}
+
+// Removes and returns the element at index, the last one by default.
+template <typename T, size_t N>
+constexpr T StaticList<T, N>::pop(std::optional<size_t> index) {
+	if (m_size == 0 || index.value_or(m_size - 1) >= m_size)
+		throw std::out_of_range("StaticList index out of range");
+
+	size_t position = index.value_or(m_size - 1);
+	Index prev{ null };
+	Index current{ m_head };
+	for (size_t idx = 0; idx < position; ++idx) {
+		prev = current;
+		current = m_nodes[current].m_next;
+	}
+
+	T data = std::move(m_nodes[current].m_data);
+	unlink(prev, current);
+
+	return data;
+}
+
+template <typename T, size_t N>
+constexpr void StaticList<T, N>::remove(T data) {
+	Index prev{ null };
+
+	for (Index current = m_head; current != null; current = m_nodes[current].m_next) {
+		if (m_nodes[current].m_data == data) {
+			unlink(prev, current);
+			return;
+		}
+
+		prev = current;
+	}
+}
+
+// data is taken by value, as it may be one of the elements about to be freed.
+template <typename T, size_t N>
+constexpr void StaticList<T, N>::remove_all(T data) {
+	Index prev{ null };
+	Index current{ m_head };
+
+	while (current != null) {
+		if (m_nodes[current].m_data == data)
+			current = unlink(prev, current);
+		else {
+			prev = current;
+			current = m_nodes[current].m_next;
+		}
+	}
+}
+
+template <typename T, size_t N>
+constexpr T StaticList<T, N>::index(size_t index) const {
+	if (index >= m_size)
+		throw std::out_of_range("StaticList index out of range");
+
+	Index current{ m_head };
+	for (size_t position = 0; position < index; ++position)
+		current = m_nodes[current].m_next;
+
+	return m_nodes[current].m_data;
+}
+
+template <typename T, size_t N>
+constexpr int StaticList<T, N>::count(const T& data) const {
+	int cnt{ 0 };
+
+	for (Index current = m_head; current != null; current = m_nodes[current].m_next) {
+		if (m_nodes[current].m_data == data)
+			++cnt;
+	}
+
+	return cnt;
+}
+
+// Empties the list and resets every slot that was handed out, so later
+// appends start again from the first slot.
+template <typename T, size_t N>
+constexpr void StaticList<T, N>::clear() {
+	for (size_t slot = 0; slot < m_used; ++slot)
+		m_nodes[slot] = Node();
+
+	m_head = null;
+	m_tail = null;
+	m_free = null;
+	m_used = 0;
+	m_size = 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#define DSA_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define DSA_PREFETCH(address) __builtin_prefetch(address)
+#endif
+
+// Traversal policies for the linked lists.
+//
+// Every walk over the nodes (count, remove, index, insert, pop and the
+// iterators) carries a Lookahead next to its cursor and calls step() each
+// time the cursor moves one node forward. A lookahead may read the node the
+// cursor is leaving, so a walk that frees nodes steps before it frees one.
+
+// Plain pointer chasing, the lookahead does nothing.
+struct DirectTraversal {
+	template <typename Node>
+	class Lookahead {
+	public:
+		Lookahead(const Node*) noexcept {};
+		void step() noexcept {};
+	};
+};
+
+// Prefetches the address Distance nodes ahead without following the chain to
+// it. A lookahead that chased m_next to get there would stall on the same
+// misses as the walk and, once caught up, stay about one node ahead whatever
+// Distance is. This cursor instead moves with the walk and guesses the address
+// from the gap between the last two nodes. Nodes laid out at a fixed stride, as
+// compact(), load() and pool allocators leave them, are then fetched Distance
+// misses ahead. On nodes scattered across the heap the guesses are wrong and
+// only cost the bandwidth of useless prefetches. A prefetch never faults, so
+// guessing an address outside the list is harmless.
+template <size_t Distance = 8>
+struct PrefetchTraversal {
+	static_assert(Distance > 0, "prefetch distance must be at least one node");
+
+	template <typename Node>
+	class Lookahead {
+	private:
+		const Node* m_current{ nullptr };
+	public:
+		Lookahead(const Node* start) noexcept : m_current(start) {};
+
+		void step() noexcept {
+			if (!m_current)
+				return;
+
+			// the walk has just loaded this node, so its link is in the cache
+			const Node* next = m_current->next_node();
+			if (!next) {
+				m_current = nullptr;
+				return;
+			}
+
+			auto address = reinterpret_cast<std::intptr_t>(next);
+			auto stride = address - reinterpret_cast<std::intptr_t>(m_current);
+			m_current = next;
+			DSA_PREFETCH(reinterpret_cast<const void*>(address + stride * static_cast<std::intptr_t>(Distance)));
+		};
+	};
+};
@@ -0,0 +1,258 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include "CacheStats.h"
+#include "DoublyLinkedList.h"
+#include "FrequencySketch.h"
+#include "NodePool.h"
+
+// Cache of at most capacity entries with W-TinyLFU admission: a small LRU
+// window in front of a main cache that only admits an entry if its key is
+// accessed more often than the key it would displace.
+//
+// New entries go to the back of the window, 1% of the capacity. The entry
+// the window pushes out is the candidate; while the main cache has room it
+// goes in, and after that it is compared with the main cache's victim, the
+// front of the probation segment, using the access counts in a
+// FrequencySketch. The more frequent of the two stays and the other is
+// evicted, the candidate on a tie. The main cache is a segmented LRU: a hit
+// in probation promotes the entry to protected, up to 80% of the main
+// capacity, and protected overflow is demoted back to the probation back.
+//
+// Every get() and put() counts an access in the sketch, hit or miss, so the
+// sketch also sees keys that are not cached. The three segments are
+// DoublyLinkedLists sharing one allocator and entries move between them by
+// splicing their nodes, so every operation is O(1) apart from hashing.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>,
+	typename Allocator = PoolAllocator<std::pair<K, V>>>
+class WTinyLFUCache {
+public:
+	using Entry = std::pair<K, V>;
+
+	enum class Segment : uint8_t {
+		Window,
+		Probation,
+		Protected,
+	};
+private:
+	using List = DoublyLinkedList<Entry, DirectTraversal, Allocator>;
+	using Handle = std::shared_ptr<typename List::Node>;
+
+	struct Location {
+		Handle entry;
+		Segment segment;
+	};
+
+	using MapAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const K, Location>>;
+
+	size_t m_capacity;
+	size_t m_window_capacity;
+	size_t m_protected_capacity;
+	Hash m_hash;
+	CacheStats m_stats;
+	uint64_t m_rejections{ 0 };
+	FrequencySketch m_sketch;
+	// declared before the map, so the map's handles are released first
+	List m_window;
+	List m_probation;
+	List m_protected;
+	std::unordered_map<K, Location, Hash, KeyEqual, MapAllocator> m_entries;
+
+	uint64_t hash_of(const K& key) const { return static_cast<uint64_t>(m_hash(key)); }
+	List& list(Segment segment) noexcept;
+	void touch(Location& location);
+	void admit();
+	void evict(const Handle& victim, List& from);
+public:
+	explicit WTinyLFUCache(size_t capacity, const Allocator& allocator = Allocator());
+	WTinyLFUCache(const WTinyLFUCache&) = delete;
+	WTinyLFUCache& operator=(const WTinyLFUCache&) = delete;
+
+	std::optional<V> get(const K& key);
+	void put(const K& key, V value);
+	bool erase(const K& key);
+	bool contains(const K& key) const;
+	void clear();
+
+	// Which segment holds key, if it is cached.
+	std::optional<Segment> segment(const K& key) const;
+	// Estimated recent accesses to key, cached or not.
+	uint8_t frequency(const K& key) const { return m_sketch.estimate(hash_of(key)); }
+
+	size_t size() const noexcept { return m_entries.size(); }
+	size_t capacity() const noexcept { return m_capacity; }
+	size_t window_capacity() const noexcept { return m_window_capacity; }
+	size_t protected_capacity() const noexcept { return m_protected_capacity; }
+
+	const CacheStats& stats() const noexcept { return m_stats; }
+	// Candidates evicted from the window because the main cache's victim was
+	// accessed at least as often; these are also counted in stats().evictions.
+	uint64_t rejections() const noexcept { return m_rejections; }
+	void reset_stats() noexcept {
+		m_stats = CacheStats{};
+		m_rejections = 0;
+	}
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::WTinyLFUCache(size_t capacity, const Allocator& allocator) :
+	m_capacity(capacity), m_window_capacity(std::max<size_t>(capacity / 100, 1)),
+	m_protected_capacity((capacity - std::min(m_window_capacity, capacity)) * 4 / 5), m_sketch(capacity),
+	m_window(allocator), m_probation(allocator), m_protected(allocator),
+	m_entries(0, Hash(), KeyEqual(), MapAllocator(allocator)) {
+	if (capacity == 0)
+		throw std::invalid_argument("WTinyLFUCache capacity must be at least 1");
+
+	m_entries.reserve(capacity);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+typename WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::List&
+WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::list(Segment segment) noexcept {
+	switch (segment) {
+	case Segment::Window:
+		return m_window;
+	case Segment::Probation:
+		return m_probation;
+	default:
+		return m_protected;
+	}
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::touch(Location& location) {
+	switch (location.segment) {
+	case Segment::Window:
+		m_window.move_to_back(location.entry);
+		break;
+	case Segment::Protected:
+		m_protected.move_to_back(location.entry);
+		break;
+	case Segment::Probation:
+		m_protected.splice_back(m_probation, location.entry);
+		location.segment = Segment::Protected;
+
+		if (m_protected.size() > m_protected_capacity) {
+			Handle demoted = m_protected.front();
+			m_probation.splice_back(m_protected, demoted);
+			m_entries.find(demoted->data().first)->second.segment = Segment::Probation;
+		}
+		break;
+	}
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+std::optional<V> WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::get(const K& key) {
+	m_sketch.increment(hash_of(key));
+
+	auto found = m_entries.find(key);
+	if (found == m_entries.end()) {
+		++m_stats.misses;
+		return std::nullopt;
+	}
+
+	++m_stats.hits;
+	touch(found->second);
+
+	return found->second.entry->data().second;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::put(const K& key, V value) {
+	m_sketch.increment(hash_of(key));
+
+	auto found = m_entries.find(key);
+	if (found != m_entries.end()) {
+		found->second.entry->data().second = std::move(value);
+		touch(found->second);
+		return;
+	}
+
+	m_window.append(Entry(key, std::move(value)));
+	m_entries.emplace(key, Location{ m_window.back(), Segment::Window });
+	++m_stats.insertions;
+
+	if (m_window.size() > m_window_capacity)
+		admit();
+}
+
+// Settles the candidate the window just pushed out: into probation if the
+// main cache has room or the candidate beats the main cache's victim,
+// otherwise out of the cache.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::admit() {
+	Handle candidate = m_window.front();
+	Location& candidate_location = m_entries.find(candidate->data().first)->second;
+
+	if (m_probation.size() + m_protected.size() < m_capacity - m_window_capacity) {
+		m_probation.splice_back(m_window, candidate);
+		candidate_location.segment = Segment::Probation;
+		return;
+	}
+
+	List& victims = m_probation.size() != 0 ? m_probation : m_protected;
+	Handle victim = victims.front();
+
+	if (victim && m_sketch.estimate(hash_of(candidate->data().first)) > m_sketch.estimate(hash_of(victim->data().first))) {
+		m_probation.splice_back(m_window, candidate);
+		candidate_location.segment = Segment::Probation;
+		evict(victim, victims);
+	}
+	else {
+		evict(candidate, m_window);
+		++m_rejections;
+	}
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::evict(const Handle& victim, List& from) {
+	Handle held = victim;
+
+	from.erase(held);
+	m_entries.erase(held->data().first);
+	++m_stats.evictions;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::erase(const K& key) {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return false;
+
+	list(found->second.segment).erase(found->second.entry);
+	m_entries.erase(found);
+
+	return true;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+bool WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::contains(const K& key) const {
+
+	return m_entries.find(key) != m_entries.end();
+}
+
+// Empties the cache; the sketch keeps its counts.
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+void WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::clear() {
+	m_entries.clear();
+	m_window.clear();
+	m_probation.clear();
+	m_protected.clear();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+std::optional<typename WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::Segment>
+WTinyLFUCache<K, V, Hash, KeyEqual, Allocator>::segment(const K& key) const {
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return std::nullopt;
+
+	return found->second.segment;
+}
@@ -0,0 +1,443 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "ListSerialization.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Append-only log of opaque records, each numbered with a log sequence number
+// (LSN) one past the last, plus a snapshot that makes the records before it
+// unnecessary:
+//
+//	log file, path:
+//	4 bytes   magic "DSAW"
+//	uint32    format version, 1
+//	          records, each:
+//	uint32      bytes that follow the checksum
+//	uint32      CRC-32 of those bytes
+//	uint64      LSN
+//	            the payload
+//
+//	snapshot file, path + ".snapshot":
+//	uint64    LSN of the last record the snapshot includes
+//	          whatever the caller's save wrote
+//
+// append() only buffers a record. Records reach the disk together, with one
+// write and one fsync, each time group_commit of them have been buffered and
+// whenever commit() is called; a group_commit of 1 makes every record durable
+// before append() returns, and 0 leaves it to commit() alone. A crash loses
+// at most the records since the last commit, and can leave the last record
+// half written; recover() drops such a torn tail and truncates the log there.
+//
+// checkpoint() writes the caller's state to a new snapshot, renames it over
+// the old one and only then truncates the log, so a crash between the two
+// leaves records the snapshot already includes; recover() skips those by LSN.
+// Integers are in the writer's byte order, as in ListSerialization.h.
+// Failures of the underlying calls throw std::system_error.
+class WriteAheadLog {
+private:
+#if defined(_WIN32)
+	HANDLE m_file{ INVALID_HANDLE_VALUE };
+#else
+	int m_file{ -1 };
+#endif
+	std::string m_path;
+	size_t m_group_commit;
+	std::vector<char> m_buffer;
+	size_t m_buffered{ 0 };
+	size_t m_file_bytes{ 0 };
+	uint64_t m_last_lsn{ 0 };
+	size_t m_syncs{ 0 };
+	bool m_recovered{ false };
+
+	static constexpr char magic[4]{ 'D', 'S', 'A', 'W' };
+	static constexpr uint32_t version{ 1 };
+	static constexpr size_t header_bytes{ sizeof(magic) + sizeof(version) };
+	static constexpr size_t record_header_bytes{ 2 * sizeof(uint32_t) };
+
+	std::string snapshot_path() const { return m_path + ".snapshot"; }
+	void write_header();
+
+	void open();
+	void close() noexcept;
+	void write(const char* data, size_t bytes);
+	void sync();
+	void truncate(size_t bytes);
+	static void sync_file(const std::string& path);
+	static void sync_directory(const std::string& path);
+	[[noreturn]] static void fail(const std::string& what);
+public:
+	// Opens the log in path, creating it if there is none. Call recover()
+	// before appending to it.
+	explicit WriteAheadLog(const std::string& path, size_t group_commit = 64);
+	WriteAheadLog(const WriteAheadLog&) = delete;
+	WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+	~WriteAheadLog();
+
+	template <typename Restore, typename Apply>
+	void recover(Restore restore, Apply apply);
+	uint64_t append(const char* payload, size_t bytes);
+	void commit();
+	template <typename Save>
+	void checkpoint(Save save);
+
+	uint64_t last_lsn() const noexcept { return m_last_lsn; }
+	// Bytes in the log, including records not yet committed.
+	size_t bytes() const noexcept { return m_file_bytes + m_buffer.size(); }
+	size_t buffered() const noexcept { return m_buffered; }
+	size_t syncs() const noexcept { return m_syncs; }
+};
+
+inline WriteAheadLog::WriteAheadLog(const std::string& path, size_t group_commit) :
+	m_path(path), m_group_commit(group_commit) {
+	open();
+}
+
+// Errors from the final commit cannot be reported here; callers that need to
+// know the last records reached the disk call commit() themselves first.
+inline WriteAheadLog::~WriteAheadLog() {
+	try {
+		commit();
+	}
+	catch (...) {}
+	close();
+}
+
+inline void WriteAheadLog::write_header() {
+	char header[header_bytes];
+	std::memcpy(header, magic, sizeof(magic));
+	std::memcpy(header + sizeof(magic), &version, sizeof(version));
+	write(header, sizeof(header));
+	sync();
+	m_file_bytes = sizeof(header);
+}
+
+// Passes the snapshot, if there is one, to restore(std::istream&), then calls
+// apply(lsn, payload, bytes) for every intact record after it, in order. The
+// log is cut back to its last intact record, so appends continue from there.
+template <typename Restore, typename Apply>
+void WriteAheadLog::recover(Restore restore, Apply apply) {
+	if (m_recovered)
+		throw std::logic_error("WriteAheadLog is already recovered");
+
+	uint64_t snapshot_lsn{ 0 };
+	{
+		std::ifstream snapshot(snapshot_path(), std::ios::binary);
+		if (snapshot) {
+			snapshot_lsn = list_serialization::read_integer<uint64_t>(snapshot);
+			restore(snapshot);
+		}
+	}
+	m_last_lsn = snapshot_lsn;
+
+	// a log shorter than its header was never appended to
+	if (m_file_bytes < header_bytes) {
+		truncate(0);
+		write_header();
+	}
+	else {
+		std::ifstream log(m_path, std::ios::binary);
+		char header[header_bytes];
+		if (!log.read(header, sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0
+			|| std::memcmp(header + sizeof(magic), &version, sizeof(version)) != 0)
+			throw std::runtime_error("WriteAheadLog file is not a log");
+
+		size_t intact{ header_bytes };
+		std::vector<char> record;
+		uint32_t lengths[2];
+
+		while (log.read(reinterpret_cast<char*>(lengths), sizeof(lengths))) {
+			uint32_t length = lengths[0];
+			if (length < sizeof(uint64_t) || length > m_file_bytes - intact - record_header_bytes)
+				break;
+
+			record.resize(length);
+			if (!log.read(record.data(), length)
+				|| list_serialization::crc32(reinterpret_cast<const std::byte*>(record.data()), length) != lengths[1])
+				break;
+
+			uint64_t lsn;
+			std::memcpy(&lsn, record.data(), sizeof(lsn));
+			if (lsn > snapshot_lsn) {
+				apply(lsn, record.data() + sizeof(lsn), length - sizeof(lsn));
+				m_last_lsn = lsn;
+			}
+
+			intact += record_header_bytes + length;
+		}
+
+		if (intact < m_file_bytes) {
+			truncate(intact);
+			sync();
+			m_file_bytes = intact;
+		}
+	}
+
+	m_recovered = true;
+}
+
+// Buffers a record and returns its LSN, committing the group if it is full.
+// If that commit fails, the record is taken back out of the buffer before the
+// error propagates, so a caller that logs a change before making it can leave
+// the change unmade; the records before it stay buffered.
+inline uint64_t WriteAheadLog::append(const char* payload, size_t bytes) {
+	if (!m_recovered)
+		throw std::logic_error("WriteAheadLog must be recovered before it is appended to");
+	if (bytes > UINT32_MAX - sizeof(uint64_t))
+		throw std::length_error("WriteAheadLog record is too long");
+
+	uint64_t lsn = m_last_lsn + 1;
+	auto length = static_cast<uint32_t>(sizeof(lsn) + bytes);
+	size_t start = m_buffer.size();
+
+	m_buffer.resize(start + record_header_bytes + length);
+	char* record = m_buffer.data() + start;
+	std::memcpy(record, &length, sizeof(length));
+	std::memcpy(record + record_header_bytes, &lsn, sizeof(lsn));
+	if (bytes)
+		std::memcpy(record + record_header_bytes + sizeof(lsn), payload, bytes);
+	uint32_t crc = list_serialization::crc32(reinterpret_cast<const std::byte*>(record + record_header_bytes), length);
+	std::memcpy(record + sizeof(length), &crc, sizeof(crc));
+
+	m_last_lsn = lsn;
+	if (++m_buffered == m_group_commit) {
+		try {
+			commit();
+		}
+		catch (...) {
+			m_buffer.resize(start);
+			--m_buffered;
+			m_last_lsn = lsn - 1;
+			throw;
+		}
+	}
+
+	return lsn;
+}
+
+// Writes the buffered records and returns once they are durable. If the write
+// fails, the records stay buffered and the file is cut back to where it was.
+inline void WriteAheadLog::commit() {
+	if (m_buffer.empty())
+		return;
+
+	try {
+		write(m_buffer.data(), m_buffer.size());
+		sync();
+	}
+	catch (...) {
+		try {
+			truncate(m_file_bytes);
+		}
+		catch (...) {}
+		throw;
+	}
+
+	m_file_bytes += m_buffer.size();
+	m_buffer.clear();
+	m_buffered = 0;
+}
+
+// Commits, has save(std::ostream&) write a snapshot of everything logged so
+// far, makes it durable and replaces the old one with it, then empties the log.
+template <typename Save>
+void WriteAheadLog::checkpoint(Save save) {
+	commit();
+
+	std::string temporary = snapshot_path() + ".tmp";
+	{
+		std::ofstream snapshot(temporary, std::ios::binary | std::ios::trunc);
+		list_serialization::write_integer(snapshot, m_last_lsn);
+		save(snapshot);
+		snapshot.flush();
+		list_serialization::check_written(snapshot);
+	}
+	sync_file(temporary);
+
+	std::error_code error;
+	std::filesystem::rename(temporary, snapshot_path(), error);
+	if (error)
+		throw std::system_error(error, "WriteAheadLog: cannot replace " + snapshot_path());
+	sync_directory(m_path);
+
+	truncate(header_bytes);
+	sync();
+	m_file_bytes = header_bytes;
+}
+
+inline void WriteAheadLog::sync_directory(const std::string& path) {
+#if defined(_WIN32)
+	// MoveFileEx, which rename() uses, has already made the new name durable
+	(void)path;
+#else
+	auto directory = std::filesystem::path(path).parent_path();
+	if (directory.empty())
+		directory = ".";
+
+	int handle = ::open(directory.string().c_str(), O_RDONLY);
+	if (handle < 0)
+		fail("cannot open " + directory.string());
+	int synced = ::fsync(handle);
+	::close(handle);
+	if (synced != 0)
+		fail("cannot sync " + directory.string());
+#endif
+}
+
+#if defined(_WIN32)
+
+inline void WriteAheadLog::open() {
+	m_file = CreateFileA(m_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+		OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+		fail("cannot open " + m_path);
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size)) {
+		close();
+		fail("cannot read the size of " + m_path);
+	}
+
+	m_file_bytes = static_cast<size_t>(size.QuadPart);
+}
+
+inline void WriteAheadLog::close() noexcept {
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+
+	m_file = INVALID_HANDLE_VALUE;
+}
+
+inline void WriteAheadLog::write(const char* data, size_t bytes) {
+	LARGE_INTEGER end;
+	end.QuadPart = 0;
+	if (!SetFilePointerEx(m_file, end, nullptr, FILE_END))
+		fail("cannot write " + m_path);
+
+	while (bytes) {
+		DWORD written;
+		DWORD step = bytes > MAXDWORD ? MAXDWORD : static_cast<DWORD>(bytes);
+		if (!WriteFile(m_file, data, step, &written, nullptr))
+			fail("cannot write " + m_path);
+
+		data += written;
+		bytes -= written;
+	}
+}
+
+inline void WriteAheadLog::sync() {
+	if (!FlushFileBuffers(m_file))
+		fail("cannot sync " + m_path);
+
+	++m_syncs;
+}
+
+inline void WriteAheadLog::truncate(size_t bytes) {
+	LARGE_INTEGER size;
+	size.QuadPart = static_cast<LONGLONG>(bytes);
+	if (!SetFilePointerEx(m_file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file))
+		fail("cannot truncate " + m_path);
+}
+
+inline void WriteAheadLog::sync_file(const std::string& path) {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		fail("cannot open " + path);
+
+	BOOL synced = FlushFileBuffers(file);
+	CloseHandle(file);
+	if (!synced)
+		fail("cannot sync " + path);
+}
+
+inline void WriteAheadLog::fail(const std::string& what) {
+	throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "WriteAheadLog: " + what);
+}
+
+#else
+
+inline void WriteAheadLog::open() {
+	m_file = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+	if (m_file < 0)
+		fail("cannot open " + m_path);
+
+	off_t size = ::lseek(m_file, 0, SEEK_END);
+	if (size < 0) {
+		close();
+		fail("cannot read the size of " + m_path);
+	}
+
+	m_file_bytes = static_cast<size_t>(size);
+}
+
+inline void WriteAheadLog::close() noexcept {
+	if (m_file >= 0)
+		::close(m_file);
+
+	m_file = -1;
+}
+
+// O_APPEND puts every write at the end, wherever truncate() left it.
+inline void WriteAheadLog::write(const char* data, size_t bytes) {
+	while (bytes) {
+		ssize_t written = ::write(m_file, data, bytes);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			fail("cannot write " + m_path);
+		}
+
+		data += written;
+		bytes -= static_cast<size_t>(written);
+	}
+}
+
+inline void WriteAheadLog::sync() {
+	if (::fsync(m_file) != 0)
+		fail("cannot sync " + m_path);
+
+	++m_syncs;
+}
+
+inline void WriteAheadLog::truncate(size_t bytes) {
+	if (::ftruncate(m_file, static_cast<off_t>(bytes)) != 0)
+		fail("cannot truncate " + m_path);
+}
+
+inline void WriteAheadLog::sync_file(const std::string& path) {
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		fail("cannot open " + path);
+
+	int synced = ::fsync(file);
+	::close(file);
+	if (synced != 0)
+		fail("cannot sync " + path);
+}
+
+inline void WriteAheadLog::fail(const std::string& what) {
+	throw std::system_error(errno, std::generic_category(), "WriteAheadLog: " + what);
+}
+
+#endif
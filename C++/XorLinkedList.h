@@ -0,0 +1,309 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+// Doubly linked list that stores a single prev ^ next word per node instead
+// of two links. A node's neighbours can only be recovered while walking, by
+// xor-ing its link with the address of the node we came from, so traversal
+// always starts from one of the ends.
+//
+// Nodes are owned by the list through raw pointers; the list can be copied
+// and moved like a value.
+template <typename T>
+class XorLinkedList {
+	class Node;
+public:
+	class Iterator;
+	using Reverse_Iterator = Iterator;
+private:
+	size_t m_size{ 0 };
+	Node* m_head{ nullptr };
+	Node* m_tail{ nullptr };
+
+	static Node* neighbour(const Node* node, const Node* from) noexcept;
+	static uintptr_t address(const Node* node) noexcept;
+public:
+	XorLinkedList() {};
+	XorLinkedList(T arr[], int size);
+	XorLinkedList(const XorLinkedList& other);
+	XorLinkedList(XorLinkedList&& other) noexcept;
+	XorLinkedList& operator=(XorLinkedList other) noexcept;
+	~XorLinkedList();
+
+	Iterator begin() const;
+	Iterator end() const;
+
+	Reverse_Iterator rbegin() const;
+	Reverse_Iterator rend() const;
+
+	void append(T data);
+	void prepend(T data);
+	T pop_front();
+	T pop_back();
+	T& front();
+	T& back();
+	T index(size_t index) const;
+	int count(const T& data) const;
+	void clear();
+	size_t size() const;
+};
+
+template <typename T>
+XorLinkedList<T>::XorLinkedList(T arr[], int size) {
+	for (auto idx = 0; idx < size; ++idx)
+		append(arr[idx]);
+}
+
+template <typename T>
+XorLinkedList<T>::XorLinkedList(const XorLinkedList& other) {
+	for (auto it = other.begin(); it != other.end(); ++it)
+		append(*it);
+}
+
+template <typename T>
+XorLinkedList<T>::XorLinkedList(XorLinkedList&& other) noexcept :
+	m_size(std::exchange(other.m_size, 0)),
+	m_head(std::exchange(other.m_head, nullptr)),
+	m_tail(std::exchange(other.m_tail, nullptr)) {}
+
+template <typename T>
+XorLinkedList<T>& XorLinkedList<T>::operator=(XorLinkedList other) noexcept {
+	std::swap(m_size, other.m_size);
+	std::swap(m_head, other.m_head);
+	std::swap(m_tail, other.m_tail);
+
+	return *this;
+}
+
+template <typename T>
+XorLinkedList<T>::~XorLinkedList() {
+	clear();
+}
+
+template <typename T>
+class XorLinkedList<T>::Node {
+	friend class XorLinkedList;
+private:
+	T m_data;
+	uintptr_t m_link{ 0 };
+public:
+	Node(T value) : m_data(std::move(value)) {};
+};
+
+// Walks in either direction: which one depends only on the end it started
+// from, since every step just moves (prev, current) one node along.
+template <typename T>
+class XorLinkedList<T>::Iterator {
+public:
+	const Node* m_prev{ nullptr };
+	Node* m_current{ nullptr };
+	Iterator(Node* node) noexcept : m_current(node) {};
+
+	// prefix operator
+	XorLinkedList<T>::Iterator& operator++() {
+		if (m_current) {
+			Node* next = XorLinkedList<T>::neighbour(m_current, m_prev);
+			m_prev = m_current;
+			m_current = next;
+		}
+
+		return *this;
+	};
+
+	// postfix operator
+	XorLinkedList<T>::Iterator operator++(int) {
+
+		Iterator iterator = *this;
+		++* this;
+
+		return iterator;
+	}
+
+	bool operator!=(const XorLinkedList<T>::Iterator& iterator) const {
+		return m_current != iterator.m_current;
+	}
+
+	T& operator*() {
+		return m_current->m_data;
+	}
+};
+
+template <typename T>
+uintptr_t XorLinkedList<T>::address(const Node* node) noexcept {
+
+	return reinterpret_cast<uintptr_t>(node);
+}
+
+template <typename T>
+typename XorLinkedList<T>::Node* XorLinkedList<T>::neighbour(const Node* node, const Node* from) noexcept {
+
+	return reinterpret_cast<Node*>(node->m_link ^ address(from));
+}
+
+template <typename T>
+typename XorLinkedList<T>::Iterator XorLinkedList<T>::begin() const {
+
+	return Iterator(m_head);
+}
+
+template <typename T>
+typename XorLinkedList<T>::Iterator XorLinkedList<T>::end() const {
+
+	return Iterator(nullptr);
+}
+
+template <typename T>
+typename XorLinkedList<T>::Reverse_Iterator XorLinkedList<T>::rbegin() const {
+
+	return Reverse_Iterator(m_tail);
+}
+
+template <typename T>
+typename XorLinkedList<T>::Reverse_Iterator XorLinkedList<T>::rend() const {
+
+	return Reverse_Iterator(nullptr);
+}
+
+template <typename T>
+void XorLinkedList<T>::append(T data) {
+	Node* node = new Node(std::move(data));
+
+	if (!m_tail) {
+		m_head = node;
+	}
+	else {
+		node->m_link = address(m_tail);
+		m_tail->m_link ^= address(node);
+	}
+
+	m_tail = node;
+	++m_size;
+}
+
+template <typename T>
+void XorLinkedList<T>::prepend(T data) {
+	Node* node = new Node(std::move(data));
+
+	if (!m_head) {
+		m_tail = node;
+	}
+	else {
+		node->m_link = address(m_head);
+		m_head->m_link ^= address(node);
+	}
+
+	m_head = node;
+	++m_size;
+}
+
+template <typename T>
+T XorLinkedList<T>::pop_front() {
+	if (!m_head)
+		throw std::out_of_range("pop from empty XorLinkedList");
+
+	Node* node = m_head;
+	Node* next = neighbour(node, nullptr);
+
+	if (next)
+		next->m_link ^= address(node);
+	else
+		m_tail = nullptr;
+
+	m_head = next;
+	--m_size;
+
+	T data = std::move(node->m_data);
+	delete node;
+
+	return data;
+}
+
+template <typename T>
+T XorLinkedList<T>::pop_back() {
+	if (!m_tail)
+		throw std::out_of_range("pop from empty XorLinkedList");
+
+	Node* node = m_tail;
+	Node* prev = neighbour(node, nullptr);
+
+	if (prev)
+		prev->m_link ^= address(node);
+	else
+		m_head = nullptr;
+
+	m_tail = prev;
+	--m_size;
+
+	T data = std::move(node->m_data);
+	delete node;
+
+	return data;
+}
+
+template <typename T>
+T& XorLinkedList<T>::front() {
+	if (!m_head)
+		throw std::out_of_range("front of empty XorLinkedList");
+
+	return m_head->m_data;
+}
+
+template <typename T>
+T& XorLinkedList<T>::back() {
+	if (!m_tail)
+		throw std::out_of_range("back of empty XorLinkedList");
+
+	return m_tail->m_data;
+}
+
+// Walks from whichever end is closer.
+template <typename T>
+T XorLinkedList<T>::index(size_t index) const {
+	if (index >= m_size)
+		throw std::out_of_range("XorLinkedList index out of range");
+
+	bool from_tail = index >= m_size / 2;
+	size_t steps = from_tail ? m_size - 1 - index : index;
+
+	Iterator it{ from_tail ? m_tail : m_head };
+	for (size_t position = 0; position < steps; ++position)
+		++it;
+
+	return it.m_current->m_data;
+}
+
+template <typename T>
+int XorLinkedList<T>::count(const T& data) const {
+	int cnt{ 0 };
+
+	for (auto it = begin(); it != end(); ++it) {
+		if (*it == data)
+			++cnt;
+	}
+
+	return cnt;
+}
+
+template <typename T>
+void XorLinkedList<T>::clear() {
+	uintptr_t prev{ 0 };
+	Node* current = m_head;
+
+	while (current) {
+		Node* next = reinterpret_cast<Node*>(current->m_link ^ prev);
+		prev = address(current);
+		delete current;
+		current = next;
+	}
+
+	m_head = nullptr;
+	m_tail = nullptr;
+	m_size = 0;
+}
+
+template <typename T>
+size_t XorLinkedList<T>::size() const {
+
+	return m_size;
+}